@@ -22,6 +22,10 @@
  
  History:
  
+ 18/10/2026 storage is a single contiguous row-major block from an aligned allocator; every row starts
+ on a 64 byte boundary (rows are padded to stride() elements). operator[] returns a std::span row view,
+ so m[i][j] works as before. transpose is cache blocked.
+ 
 */
 
 #ifndef __MATRIX_H__
@@ -30,6 +34,13 @@
 
 #include <iostream>
 #include <vector>
+#include <span>
+#include <algorithm>
+#include <assert.h>
+
+#ifndef __ALIGNEDALLOCATOR_H__
+#include "AlignedAllocator.h"
+#endif
 
 
 template <typename T>
@@ -38,45 +49,51 @@ class Matrix
 
 public:
 	
+    typedef std::span<T> Row;
+    typedef std::span<const T> ConstRow;
 	
-	Matrix( void ): m_rows(0), m_cols(0), m_rawData() {}	
-    Matrix( int r, int c, const T &x = T() ): m_rows(r), m_cols(c), m_rawData(r, std::vector<T>(c, x)) {}
+	Matrix( void ): m_rows(0), m_cols(0), m_stride(0), m_rawData() {}	
+    Matrix( int r, int c, const T &x = T() ): m_rows(0), m_cols(0), m_stride(0), m_rawData() { resize( r, c, x ); }
     
-	explicit Matrix( const std::vector<std::vector<T>>& values ): m_rows(0), m_cols(0), m_rawData() 
+	explicit Matrix( const std::vector<std::vector<T>>& values ): m_rows(0), m_cols(0), m_stride(0), m_rawData() 
 	{
 		setMatrix( values );
 	}
 	
+    Matrix( const Matrix<T>& m ) = default;
+    Matrix( Matrix<T>&& m ) noexcept: m_rows(m.m_rows), m_cols(m.m_cols), m_stride(m.m_stride), m_rawData(std::move(m.m_rawData)) 
+    { 
+        m.m_rows = 0; m.m_cols = 0; m.m_stride = 0; 
+    }
+    
+    Matrix<T>& operator=( const Matrix<T>& m ) = default;
+    Matrix<T>& operator=( Matrix<T>&& m ) noexcept
+    {
+        m_rows = m.m_rows; m_cols = m.m_cols; m_stride = m.m_stride;
+        m_rawData = std::move(m.m_rawData);
+        m.m_rows = 0; m.m_cols = 0; m.m_stride = 0;
+        return *this;
+    }
 
-	~Matrix( void ) { m_rows = 0; m_cols = 0; m_rawData.clear(); }
+	~Matrix( void ) {}
 	
     void 
-    clear( void ) { m_rows = 0; m_cols = 0; m_rawData.clear(); } 
+    clear( void ) { m_rows = 0; m_cols = 0; m_stride = 0; m_rawData.clear(); } 
 	
 	Matrix<T>& 
 	operator=( const T &a );		// assign a to every element
 	
 	void
-	setMatrix( int r, int c )
-	{
-		m_rows = r;
-		m_cols = c;
-		m_rawData.resize( r, std::vector<T>(c, T()) );	
-	}
+	setMatrix( int r, int c ) { resize( r, c ); }
 	
 	void
-	setMatrix( const std::vector< std::vector<T> >& values ) 
-	{
-		m_rows = values.size();
-        m_cols = (m_rows) ? values[0].size() : 0;
-		m_rawData = values;
-	}
+	setMatrix( const std::vector< std::vector<T> >& values ); 
 	
-	std::vector<T>& 
-    operator[]( int i ) { return m_rawData[i]; }	// return row i
+	Row 
+    operator[]( int i ) { return Row( m_rawData.data() + (std::size_t) i * m_stride, m_cols ); }	// return row i
     
-	const std::vector<T>& 
-    operator[]( int i ) const { return m_rawData[i]; }
+	ConstRow 
+    operator[]( int i ) const { return ConstRow( m_rawData.data() + (std::size_t) i * m_stride, m_cols ); }
 	
 	std::vector<T> 
     column( int colIdx ) const; // extract column copy c as a (row) vector
@@ -86,21 +103,32 @@ public:
 	
 	int rows( void ) const { return m_rows; }
 	int cols( void ) const { return m_cols; }
+    int stride( void ) const { return m_stride; } // elements between the starts of consecutive rows
 
 	void 
 	resize( int r, int c, const T& = T() ); // will preserve/truncate existing data accordingly
 
-	const std::vector< std::vector<T> >&
-	data( void ) const { return m_rawData; }
+    // contiguous row-major storage, rows() * stride() elements
+	const T*
+	data( void ) const { return m_rawData.data(); }
 	
-	std::vector< std::vector<T> >&
-	data( void ) { return m_rawData; }
+	T*
+	data( void ) { return m_rawData.data(); }
 	
 private:
+    
+    static int
+    padded( int c )
+    {
+        // round rows up to whole cache lines when T packs evenly into them
+        const int line = (sizeof(T) <= 64 && 64 % sizeof(T) == 0) ? int(64 / sizeof(T)) : 1;
+        return ((c + line - 1) / line) * line;
+    }
 		
 	int m_rows;
 	int m_cols;
-	std::vector< std::vector<T> > m_rawData;
+    int m_stride;
+	std::vector< T, AlignedAllocator<T> > m_rawData;
 	
 };
 
@@ -150,6 +178,20 @@ operator>>( std::istream& istr, Matrix<T>& m )
 }
 
 
+template <class T>
+void
+Matrix<T>::setMatrix( const std::vector< std::vector<T> >& values ) 
+{
+    int r = (int) values.size();
+    int c = (r) ? (int) values[0].size() : 0;
+    
+    clear();
+    resize( r, c );
+    for (int i = 0; i < r; ++i)
+    {
+        std::copy( values[i].begin(), values[i].begin() + c, m_rawData.begin() + (std::size_t) i * m_stride );
+    }
+}
 
 template <class T>
 void 
@@ -158,20 +200,34 @@ Matrix<T>::resize( int r, int c, const T& v )
 	if (r == m_rows && c == m_cols)
 		return; // no resize needed
 	
-	if (c != m_cols) // resize cols of existing rows
-	{
-		typename std::vector< std::vector<T> >::iterator end = m_rawData.end();
-		for (typename std::vector< std::vector<T> >::iterator i = m_rawData.begin(); i != end; ++i)
-		{
-			i->resize(c, v);
-		}
-	}
+    int stride = padded( c );
+    
+    if (stride == m_stride) 
+    {
+        // rows stay where they are; only new rows or columns need filling
+        m_rawData.resize( (std::size_t) r * stride, v );
+        for (int i = 0; i < std::min( r, m_rows ); ++i)
+        {
+            std::fill( m_rawData.begin() + (std::size_t) i * stride + std::min( c, m_cols ), 
+                       m_rawData.begin() + (std::size_t) i * stride + c, v );
+        }
+    }
+    else
+    {
+        std::vector< T, AlignedAllocator<T> > tmp( (std::size_t) r * stride, v );
+        int keepCols = std::min( c, m_cols );
+        for (int i = 0; i < std::min( r, m_rows ); ++i)
+        {
+            std::move( m_rawData.begin() + (std::size_t) i * m_stride, 
+                       m_rawData.begin() + (std::size_t) i * m_stride + keepCols,
+                       tmp.begin() + (std::size_t) i * stride );
+        }
+        m_rawData.swap( tmp );
+    }
 	
 	m_rows = r;
 	m_cols = c;
-	
-	// add in extra rows
-	m_rawData.resize( r, std::vector<T>(c, v) );
+    m_stride = stride;
 }
 
 template <class T>
@@ -179,13 +235,7 @@ Matrix<T>&
 Matrix<T>::operator=( const T &a )	
 // assign a to every element
 {
-	for (int i = 0; i< m_rows; ++i)
-	{
-		for (int j = 0; j < m_cols; ++j)
-		{
-			m_rawData[i][j] = a;
-		}
-	}
+    std::fill( m_rawData.begin(), m_rawData.end(), a );
 	return *this;
 }
 
@@ -197,9 +247,10 @@ Matrix<T>::column( int colIdx ) const
 	assert(colIdx < m_cols);
 	
 	std::vector<T> retVal(m_rows); 
-	for (int j = 0; j < m_rows; ++j)
+    const T* p = m_rawData.data() + colIdx;
+	for (int j = 0; j < m_rows; ++j, p += m_stride)
 	{
-		retVal[j] = m_rawData[j][colIdx];
+		retVal[j] = *p;
 	}
 	return retVal;
 }
@@ -208,10 +259,11 @@ template <class T>
 void
 Matrix<T>::column( int colIdx, const std::vector<T>& col )
 {
-    assert(col.size() == m_rows && colIdx < m_cols);
-    for (int j = 0; j < m_rows; ++j)
+    assert((int) col.size() == m_rows && colIdx < m_cols);
+    T* p = m_rawData.data() + colIdx;
+    for (int j = 0; j < m_rows; ++j, p += m_stride)
     {
-        m_rawData[j][colIdx] = col[j];
+        *p = col[j];
     }
 }
 
@@ -228,17 +280,7 @@ template <class T>
 bool 
 operator!=( const Matrix<T> &m1, const Matrix<T> &m2 ) 
 {
-	assert((m1.rows() == m2.rows()) && (m1.cols() == m2.cols()));
-	
-    for (int i = 0; i < m1.rows(); ++i)
-	{
-		for (int j = 0; j < m1.cols(); ++j)
-		{
-			if (m1[i][j] != m2[i][j])
-				return true;
-		}
-	}
-	return false;
+	return !(m1 == m2);
 }
 
 template <class T>
@@ -249,11 +291,10 @@ operator==( const Matrix<T> &m1, const Matrix<T> &m2 )
 	
     for (int i = 0; i < m1.rows(); ++i)
 	{
-		for (int j = 0; j < m1.cols(); ++j)
-		{
-			if (m1[i][j] != m2[i][j])
-				return false;
-		}
+        typename Matrix<T>::ConstRow r1 = m1[i];
+        typename Matrix<T>::ConstRow r2 = m2[i];
+        if (!std::equal( r1.begin(), r1.end(), r2.begin() ))
+            return false;
 	}
 	return true;
 }
@@ -268,15 +309,31 @@ transpose( const Matrix<T>& m );
 template <class T>
 Matrix<T> 
 transpose( const Matrix<T>& m ) 
+// cache blocked: each BLOCK x BLOCK tile of the source and destination stays in L1 while it is copied
 {
+    const int BLOCK = 32;
+    
 	Matrix<T> retVal(m.cols(), m.rows());
-    for (int i = 0; i < retVal.rows(); ++i)
-	{
-		for (int j = 0; j < retVal.cols(); ++j)
-		{
-			retVal[i][j] = m[j][i];
-		}
-	}
+    const T* src = m.data();
+    T* dst = retVal.data();
+    const int ss = m.stride();
+    const int ds = retVal.stride();
+    
+    for (int ib = 0; ib < m.rows(); ib += BLOCK)
+    {
+        int iend = std::min( ib + BLOCK, m.rows() );
+        for (int jb = 0; jb < m.cols(); jb += BLOCK)
+        {
+            int jend = std::min( jb + BLOCK, m.cols() );
+            for (int i = ib; i < iend; ++i)
+            {
+                for (int j = jb; j < jend; ++j)
+                {
+                    dst[(std::size_t) j * ds + i] = src[(std::size_t) i * ss + j];
+                }
+            }
+        }
+    }
 	
 	return retVal;
 }
@@ -286,5 +343,3 @@ transpose( const Matrix<T>& m )
 
 
 #endif // __MATRIX_H__ 
-
-
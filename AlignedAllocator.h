@@ -0,0 +1,79 @@
+/* Aligned Allocator 18/10/2026
+
+ $$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$
+ $   AlignedAllocator.h - header   $
+ $$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$
+
+ Copyright (C) 2026  W.B. Yates
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see http://www.gnu.org/licenses/
+
+ History:
+
+ A standard allocator returning storage aligned to Align bytes (a cache line by default),
+ so that std::vector<double, AlignedAllocator<double>> can be used with aligned SIMD loads.
+
+ Examples
+
+    std::vector<double, AlignedAllocator<double>> v(1024);   // v.data() is 64 byte aligned
+ */
+
+
+#ifndef __ALIGNEDALLOCATOR_H__
+#define __ALIGNEDALLOCATOR_H__
+
+#include <cstddef>
+#include <new>
+
+
+template <typename T, std::size_t Align = 64>
+class AlignedAllocator
+{
+public:
+
+    static_assert( Align >= alignof(T) && (Align & (Align - 1)) == 0, "Align must be a power of two no smaller than alignof(T)" );
+
+    typedef T value_type;
+
+    template <typename U>
+    struct rebind { typedef AlignedAllocator<U, Align> other; };
+
+    AlignedAllocator( void ) noexcept {}
+
+    template <typename U>
+    AlignedAllocator( const AlignedAllocator<U, Align>& ) noexcept {}
+
+    T*
+    allocate( std::size_t n )
+    {
+        return static_cast<T*>( ::operator new( n * sizeof(T), std::align_val_t(Align) ) );
+    }
+
+    void
+    deallocate( T* p, std::size_t ) noexcept
+    {
+        ::operator delete( p, std::align_val_t(Align) );
+    }
+};
+
+template <typename T, typename U, std::size_t Align>
+bool operator==( const AlignedAllocator<T, Align>&, const AlignedAllocator<U, Align>& ) { return true; }
+
+template <typename T, typename U, std::size_t Align>
+bool operator!=( const AlignedAllocator<T, Align>&, const AlignedAllocator<U, Align>& ) { return false; }
+
+
+#endif
+
+///
@@ -0,0 +1,104 @@
+/* American Option Pricer 18/10/2026
+
+ $$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$
+ $   AmericanPricer.cpp - code   $
+ $$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$
+
+ by W.B. Yates
+ Copyright (c) W.B. Yates. All rights reserved.
+ History:
+
+ */
+
+#include <math.h>
+
+#ifndef __AMERICANPRICER_H__
+#include "AmericanPricer.h"
+#endif
+
+
+AmericanEngine
+AmericanPricer::select( double strike, double assetPrice, double vol, double rate, double T, double yield, bool call, double& approx )
+{
+    if ((call && yield <= 0.0) || (!call && rate <= 0.0))
+        return AmericanEngine::BlackScholes;
+
+    double baw = m_baw.value( strike, assetPrice, vol, rate, T, yield, call );
+    double bjs = m_bjs.value( strike, assetPrice, vol, rate, T, yield, call );
+    approx = 0.5 * (baw + bjs);
+
+    if (fabs(baw - bjs) <= m_tolerance * strike)
+        return AmericanEngine::Approximation;
+    return AmericanEngine::BinomialTree;
+}
+
+double
+AmericanPricer::value( double strike,      // option strike
+                       double assetPrice,  // underlying asset's current value
+                       double vol,         // volatility
+                       double rate,        // risk free rate of interest
+                       double T,           // time to maturity (year fraction)
+                       double yield,       // annualised yield of underlying asset over life of option (continuous compounded)
+                       bool call )
+{
+    double approx = 0.0;
+    m_engine = select( strike, assetPrice, vol, rate, T, yield, call, approx );
+    switch (m_engine)
+    {
+        case AmericanEngine::BlackScholes:
+            return m_bs.value( strike, assetPrice, vol, rate, T, yield, call );
+        case AmericanEngine::Approximation:
+            return approx;
+        case AmericanEngine::BinomialTree:
+            break;
+    }
+    return m_bt.value( strike, assetPrice, vol, rate, T, yield, call );
+}
+
+double
+AmericanPricer::delta( double strike,      // option strike
+                       double assetPrice,  // underlying asset's current value
+                       double vol,         // volatility
+                       double rate,        // risk free rate of interest
+                       double T,           // time to maturity (year fraction)
+                       double yield,       // annualised yield of underlying asset over life of option (continuous compounded)
+                       bool call )
+{
+    double approx = 0.0;
+    m_engine = select( strike, assetPrice, vol, rate, T, yield, call, approx );
+    switch (m_engine)
+    {
+        case AmericanEngine::BlackScholes:
+            return m_bs.delta( strike, assetPrice, vol, rate, T, yield, call );
+        case AmericanEngine::Approximation:
+            return m_baw.delta( strike, assetPrice, vol, rate, T, yield, call );
+        case AmericanEngine::BinomialTree:
+            break;
+    }
+    return m_bt.delta( strike, assetPrice, vol, rate, T, yield, call );
+}
+
+double
+AmericanPricer::gamma( double strike,      // option strike
+                       double assetPrice,  // underlying asset's current value
+                       double vol,         // volatility
+                       double rate,        // risk free rate of interest
+                       double T,           // time to maturity (year fraction)
+                       double yield,       // annualised yield of underlying asset over life of option (continuous compounded)
+                       bool call )
+{
+    double approx = 0.0;
+    m_engine = select( strike, assetPrice, vol, rate, T, yield, call, approx );
+    switch (m_engine)
+    {
+        case AmericanEngine::BlackScholes:
+            return m_bs.gamma( strike, assetPrice, vol, rate, T, yield );
+        case AmericanEngine::Approximation:
+            return m_baw.gamma( strike, assetPrice, vol, rate, T, yield, call );
+        case AmericanEngine::BinomialTree:
+            break;
+    }
+    return m_bt.gamma( strike, assetPrice, vol, rate, T, yield, call );
+}
+
+//
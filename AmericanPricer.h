@@ -0,0 +1,129 @@
+/* American Option Pricer 18/10/2026
+
+ $$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$
+ $   AmericanPricer.h - header   $
+ $$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$
+
+ Copyright (C) 2026  W.B. Yates
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see http://www.gnu.org/licenses/
+
+ History:
+
+ Prices American options with an analytical approximation where that is accurate enough and
+ falls back to the BinomialTree otherwise.
+
+ 1) Calls with yield <= 0 and puts with rate <= 0 are never exercised early and are priced with BlackScholes.
+ 2) Otherwise Barone-Adesi Whaley and Bjerksund Stensland are both evaluated. They are derived
+    differently and their errors are largely unrelated, so the gap between them is used as the
+    error estimate. If the gap is within tolerance() * strike their midpoint is returned
+    (delta and gamma are then the analytical Barone-Adesi Whaley Greeks).
+ 3) Otherwise the BinomialTree is used.
+
+ engine() reports which of these produced the last result.
+
+ Examples
+
+    AmericanPricer ap;
+    ap.tolerance( 0.001 );        // accept approximations that agree to 0.1% of strike
+    ap.tree().timeSteps( 500 );
+    double v = ap.value( 110, 100, 0.3, 0.08, 1.0, 0.0, false );
+    if (ap.engine() == AmericanEngine::BinomialTree) ...
+ */
+
+
+#ifndef __AMERICANPRICER_H__
+#define __AMERICANPRICER_H__
+
+
+#ifndef __BLACKSCHOLES_H__
+#include "BlackScholes.h"
+#endif
+
+#ifndef __BINOMIALTREE_H__
+#include "BinomialTree.h"
+#endif
+
+#ifndef __BARONEADESIWHALEY_H__
+#include "BaroneAdesiWhaley.h"
+#endif
+
+#ifndef __BJERKSUNDSTENSLAND_H__
+#include "BjerksundStensland.h"
+#endif
+
+
+enum class AmericanEngine : int { BlackScholes = 0, Approximation = 1, BinomialTree = 2 };
+
+
+class AmericanPricer
+{
+public:
+
+    AmericanPricer( void ): m_tolerance(0.001), m_engine(AmericanEngine::BlackScholes) {}
+    ~AmericanPricer() {}
+
+    double
+    value( double strike,       // option strike
+           double assetPrice,   // underlying asset's current value
+           double vol,          // volatility
+           double rate,         // risk free rate of interest
+           double T,            // time to maturity (year fraction)
+           double yield = 0.0,  // annualised yield of underlying asset over life of option (continuous compounded)
+           bool call = true );
+
+    double
+    delta( double strike,      // option strike
+           double assetPrice,  // underlying asset's current value
+           double vol,         // volatility
+           double rate,        // risk free rate of interest
+           double T,           // time to maturity (year fraction)
+           double yield = 0.0, // annualised yield of underlying asset over life of option (continuous compounded)
+           bool call = true );
+
+    double
+    gamma( double strike,      // option strike
+           double assetPrice,  // underlying asset's current value
+           double vol,         // volatility
+           double rate,        // risk free rate of interest
+           double T,           // time to maturity (year fraction)
+           double yield = 0.0, // annualised yield of underlying asset over life of option (continuous compounded)
+           bool call = true );
+
+    // the largest accepted gap between the two approximations, as a fraction of strike
+    void tolerance( double t ) { m_tolerance = t; }
+    double tolerance( void ) const { return m_tolerance; }
+
+    // the engine used for the last value, delta or gamma
+    AmericanEngine engine( void ) const { return m_engine; }
+
+    BinomialTree& tree( void ) { return m_bt; }
+
+private:
+
+    AmericanEngine
+    select( double strike, double assetPrice, double vol, double rate, double T, double yield, bool call, double& approx );
+
+    BlackScholes m_bs;
+    BaroneAdesiWhaley m_baw;
+    BjerksundStensland m_bjs;
+    BinomialTree m_bt;
+    double m_tolerance;
+    AmericanEngine m_engine;
+};
+
+
+#endif
+
+///
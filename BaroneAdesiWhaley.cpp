@@ -0,0 +1,289 @@
+/* Barone-Adesi Whaley American Option Approximation 18/10/2026
+
+ $$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$
+ $   BaroneAdesiWhaley.cpp - code   $
+ $$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$
+
+ by W.B. Yates
+ Copyright (c) W.B. Yates. All rights reserved.
+ History:
+
+ */
+
+#include <math.h>
+
+#ifndef __BARONEADESIWHALEY_H__
+#include "BaroneAdesiWhaley.h"
+#endif
+
+
+double
+BaroneAdesiWhaley::criticalPrice( double strike,
+                                  double vol,
+                                  double rate,
+                                  double T,
+                                  double yield,
+                                  bool call ) const
+// see Haug, page 98
+{
+    double b = rate - yield;  // cost of carry
+    double vol2 = vol * vol;
+    double sqrtT = sqrt(T);
+    double n = 2.0 * b / vol2;
+    double m = 2.0 * rate / vol2;
+    double k = 1.0 - exp(-rate * T);
+    double carry = exp((b - rate) * T);
+
+    if (call)
+    {
+        double q2u = (-(n - 1.0) + sqrt((n - 1.0) * (n - 1.0) + 4.0 * m)) / 2.0;
+        double su = strike / (1.0 - 1.0 / q2u);
+        double h2 = -(b * T + 2.0 * vol * sqrtT) * strike / (su - strike);
+        double si = strike + (su - strike) * (1.0 - exp(h2));
+
+        double q2 = (-(n - 1.0) + sqrt((n - 1.0) * (n - 1.0) + 4.0 * m / k)) / 2.0;
+        for (int i = 0; i < 100; ++i)
+        {
+            double d1 = (log(si / strike) + (b + vol2 / 2.0) * T) / (vol * sqrtT);
+            double lhs = si - strike;
+            double rhs = m_bs.value( strike, si, vol, rate, T, yield, true ) + (1.0 - carry * m_bs.N(d1)) * si / q2;
+            if (fabs(lhs - rhs) / strike < 1E-6)
+                break;
+            double bi = carry * m_bs.N(d1) * (1.0 - 1.0 / q2) + (1.0 - carry * m_bs.DN(d1) / (vol * sqrtT)) / q2;
+            si = (strike + rhs - bi * si) / (1.0 - bi);
+        }
+        return si;
+    }
+    else
+    {
+        double q1u = (-(n - 1.0) - sqrt((n - 1.0) * (n - 1.0) + 4.0 * m)) / 2.0;
+        double su = strike / (1.0 - 1.0 / q1u);
+        double h1 = (b * T - 2.0 * vol * sqrtT) * strike / (strike - su);
+        double si = su + (strike - su) * exp(h1);
+
+        double q1 = (-(n - 1.0) - sqrt((n - 1.0) * (n - 1.0) + 4.0 * m / k)) / 2.0;
+        for (int i = 0; i < 100; ++i)
+        {
+            double d1 = (log(si / strike) + (b + vol2 / 2.0) * T) / (vol * sqrtT);
+            double lhs = strike - si;
+            double rhs = m_bs.value( strike, si, vol, rate, T, yield, false ) - (1.0 - carry * m_bs.N(-d1)) * si / q1;
+            if (fabs(lhs - rhs) / strike < 1E-6)
+                break;
+            double bi = -carry * m_bs.N(-d1) * (1.0 - 1.0 / q1) - (1.0 + carry * m_bs.DN(-d1) / (vol * sqrtT)) / q1;
+            si = (strike - rhs + bi * si) / (1.0 + bi);
+        }
+        return si;
+    }
+}
+
+void
+BaroneAdesiWhaley::evaluate( double strike, double assetPrice, double vol, double rate, double T, double yield, bool call,
+                             double& value, double& delta, double& gamma ) const
+{
+    double b = rate - yield;
+
+    value = m_bs.value( strike, assetPrice, vol, rate, T, yield, call );
+    delta = m_bs.delta( strike, assetPrice, vol, rate, T, yield, call );
+    gamma = m_bs.gamma( strike, assetPrice, vol, rate, T, yield );
+
+    // early exercise is never optimal for a call when b >= r, nor for a put when r <= 0
+    if ((call && b >= rate) || (!call && rate <= 0.0))
+        return;
+
+    double vol2 = vol * vol;
+    double sqrtT = sqrt(T);
+    double n = 2.0 * b / vol2;
+    double m = 2.0 * rate / vol2;
+    double k = 1.0 - exp(-rate * T);
+    double carry = exp((b - rate) * T);
+    double sStar = criticalPrice( strike, vol, rate, T, yield, call );
+    double d1 = (log(sStar / strike) + (b + vol2 / 2.0) * T) / (vol * sqrtT);
+
+    double q, a;
+    if (call)
+    {
+        if (assetPrice >= sStar)
+        {
+            value = assetPrice - strike; delta = 1.0; gamma = 0.0;
+            return;
+        }
+        q = (-(n - 1.0) + sqrt((n - 1.0) * (n - 1.0) + 4.0 * m / k)) / 2.0;
+        a = (sStar / q) * (1.0 - carry * m_bs.N(d1));
+    }
+    else
+    {
+        if (assetPrice <= sStar)
+        {
+            value = strike - assetPrice; delta = -1.0; gamma = 0.0;
+            return;
+        }
+        q = (-(n - 1.0) - sqrt((n - 1.0) * (n - 1.0) + 4.0 * m / k)) / 2.0;
+        a = -(sStar / q) * (1.0 - carry * m_bs.N(-d1));
+    }
+
+    // premium a (S/S*)^q and its first two derivatives in S
+    double premium = a * pow( assetPrice / sStar, q );
+    value += premium;
+    delta += premium * q / assetPrice;
+    gamma += premium * q * (q - 1.0) / (assetPrice * assetPrice);
+}
+
+double
+BaroneAdesiWhaley::value( double strike,      // option strike
+                          double assetPrice,  // underlying asset's current value
+                          double vol,         // volatility
+                          double rate,        // risk free rate of interest
+                          double T,           // time to maturity (year fraction)
+                          double yield,       // annualised yield of underlying asset over life of option (continuous compounded)
+                          bool call ) const
+{
+    double v, d, g;
+    evaluate( strike, assetPrice, vol, rate, T, yield, call, v, d, g );
+    return v;
+}
+
+double
+BaroneAdesiWhaley::delta( double strike,      // option strike
+                          double assetPrice,  // underlying asset's current value
+                          double vol,         // volatility
+                          double rate,        // risk free rate of interest
+                          double T,           // time to maturity (year fraction)
+                          double yield,       // annualised yield of underlying asset over life of option (continuous compounded)
+                          bool call ) const
+{
+    double v, d, g;
+    evaluate( strike, assetPrice, vol, rate, T, yield, call, v, d, g );
+    return d;
+}
+
+double
+BaroneAdesiWhaley::gamma( double strike,      // option strike
+                          double assetPrice,  // underlying asset's current value
+                          double vol,         // volatility
+                          double rate,        // risk free rate of interest
+                          double T,           // time to maturity (year fraction)
+                          double yield,       // annualised yield of underlying asset over life of option (continuous compounded)
+                          bool call ) const
+{
+    double v, d, g;
+    evaluate( strike, assetPrice, vol, rate, T, yield, call, v, d, g );
+    return g;
+}
+
+double
+BaroneAdesiWhaley::sensitivity( double strike, double assetPrice, double vol, double rate, double T, double yield, bool call,
+                                Parameter x ) const
+// the value is c(S) + A (S/S*)^q, with A and q functions of S* and the parameters and S* fixed by
+// phi (S* - K) = c(S*) + A; so dS*/dx comes from differentiating that equation implicitly
+{
+    double b = rate - yield;
+    double phi = (call) ? 1.0 : -1.0;
+
+    double dc; // the Black Scholes value's derivative at assetPrice
+    switch (x)
+    {
+        case Time: dc = -m_bs.theta( strike, assetPrice, vol, rate, T, yield, call ); break;
+        case Rate: dc = m_bs.rho( strike, assetPrice, vol, rate, T, yield, call ); break;
+        default:   dc = m_bs.vega( strike, assetPrice, vol, rate, T, yield ); break;
+    }
+
+    if ((call && b >= rate) || (!call && rate <= 0.0))
+        return dc;
+
+    double vol2 = vol * vol;
+    double sqrtT = sqrt(T);
+    double n = 2.0 * b / vol2;
+    double m = 2.0 * rate / vol2;
+    double k = 1.0 - exp(-rate * T);
+    double carry = exp((b - rate) * T);
+    double sStar = criticalPrice( strike, vol, rate, T, yield, call );
+    if (phi * (assetPrice - sStar) >= 0.0)
+        return 0.0; // exercised, worth the intrinsic value whatever x is
+
+    double d1 = (log(sStar / strike) + (b + vol2 / 2.0) * T) / (vol * sqrtT);
+    double root = sqrt((n - 1.0) * (n - 1.0) + 4.0 * m / k);
+    double q = (-(n - 1.0) + phi * root) / 2.0;
+    double nd1 = m_bs.N(phi * d1);
+    double a = phi * (sStar / q) * (1.0 - carry * nd1);
+
+    // partial derivatives in x of n, m / k, carry, d1 (at fixed S*) and c(S*)
+    double dn = 0.0, dmk = 0.0, dcarry = 0.0, dd1, dcStar;
+    switch (x)
+    {
+        case Time:
+            dmk = -m * rate * exp(-rate * T) / (k * k);
+            dcarry = -yield * carry;
+            dd1 = (b + vol2 / 2.0) / (vol * sqrtT) - d1 / (2.0 * T);
+            dcStar = -m_bs.theta( strike, sStar, vol, rate, T, yield, call );
+            break;
+        case Rate:
+            dn = 2.0 / vol2;
+            dmk = dn / k - m * T * exp(-rate * T) / (k * k);
+            dd1 = sqrtT / vol;
+            dcStar = m_bs.rho( strike, sStar, vol, rate, T, yield, call );
+            break;
+        default:
+            dn = -2.0 * n / vol;
+            dmk = -2.0 * m / (vol * k);
+            dd1 = sqrtT - d1 / vol;
+            dcStar = m_bs.vega( strike, sStar, vol, rate, T, yield );
+            break;
+    }
+    double dq = (-dn + phi * ((n - 1.0) * dn + 2.0 * dmk) / root) / 2.0;
+
+    // A's derivatives in x at fixed S*, and in S*
+    double density = (sStar / q) * carry * m_bs.DN(d1);
+    double da = -a * dq / q - phi * (sStar / q) * dcarry * nd1 - density * dd1;
+    double daStar = a / sStar - density / (sStar * vol * sqrtT);
+
+    double dStar = (dcStar + da) / (phi - m_bs.delta( strike, sStar, vol, rate, T, yield, call ) - daStar);
+
+    double premium = a * pow( assetPrice / sStar, q );
+    return dc + premium * ((da + daStar * dStar) / a + dq * log( assetPrice / sStar ) - q * dStar / sStar);
+}
+
+double
+BaroneAdesiWhaley::theta( double strike,      // option strike
+                          double assetPrice,  // underlying asset's current value
+                          double vol,         // volatility
+                          double rate,        // risk free rate of interest
+                          double T,           // time to maturity (year fraction)
+                          double yield,       // annualised yield of underlying asset over life of option (continuous compounded)
+                          bool call ) const
+{
+    // at expiry the value is the payoff, which does not decay
+    if (T <= 0.0)
+        return 0.0;
+    // theta is the derivative with respect to calendar time, i.e. minus the derivative in T
+    return -sensitivity( strike, assetPrice, vol, rate, T, yield, call, Time );
+}
+
+double
+BaroneAdesiWhaley::rho( double strike,      // option strike
+                        double assetPrice,  // underlying asset's current value
+                        double vol,         // volatility
+                        double rate,        // risk free rate of interest
+                        double T,           // time to maturity (year fraction)
+                        double yield,       // annualised yield of underlying asset over life of option (continuous compounded)
+                        bool call ) const
+{
+    if (T <= 0.0)
+        return 0.0;
+    return sensitivity( strike, assetPrice, vol, rate, T, yield, call, Rate );
+}
+
+double
+BaroneAdesiWhaley::vega( double strike,      // option strike
+                         double assetPrice,  // underlying asset's current value
+                         double vol,         // volatility
+                         double rate,        // risk free rate of interest
+                         double T,           // time to maturity (year fraction)
+                         double yield,       // annualised yield of underlying asset over life of option (continuous compounded)
+                         bool call ) const
+{
+    if (T <= 0.0)
+        return 0.0;
+    return sensitivity( strike, assetPrice, vol, rate, T, yield, call, Vol );
+}
+
+//
@@ -0,0 +1,145 @@
+/* Barone-Adesi Whaley American Option Approximation 18/10/2026
+
+ $$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$
+ $   BaroneAdesiWhaley.h - header   $
+ $$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$
+
+ Copyright (C) 2026  W.B. Yates
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see http://www.gnu.org/licenses/
+
+ History:
+
+ Barone-Adesi and Whaley (1987) quadratic approximation for American options
+ (see Hull (6th edition), page 602, and Haug, "The Complete Guide to Option Pricing Formulas", page 97).
+ The American price is the Black Scholes price plus an early exercise premium A (S/S*)^q,
+ where the critical price S* is found by Newton iteration.
+
+ The Greeks are analytical. Theta, rho and vega differentiate the premium through the critical price
+ as well, with the derivative of S* taken implicitly from the equation S* solves; they are 0 when T <= 0.
+
+ Examples
+
+    BaroneAdesiWhaley baw;
+
+    // American put, value is 14.456 (a 2000 step BinomialTree gives 14.497)
+    double yield = 0.0;
+    double T  = 1.0;
+    double assetPrice = 100;
+    double rate = 0.08;
+    double vol = 0.3;
+    double strike = 110;
+    bool call = false;
+    std::cout << "value is " << baw.value(strike, assetPrice, vol, rate, T, yield, call) << std::endl;
+ */
+
+
+#ifndef __BARONEADESIWHALEY_H__
+#define __BARONEADESIWHALEY_H__
+
+
+#ifndef __BLACKSCHOLES_H__
+#include "BlackScholes.h"
+#endif
+
+
+class BaroneAdesiWhaley
+{
+public:
+    BaroneAdesiWhaley() {}
+    ~BaroneAdesiWhaley() {}
+
+    double
+    value( double strike,       // option strike
+           double assetPrice,   // underlying asset's current value
+           double vol,          // volatility
+           double rate,         // risk free rate of interest
+           double T,            // time to maturity (year fraction)
+           double yield = 0.0,  // annualised yield of underlying asset over life of option (continuous compounded)
+           bool call = true ) const;
+
+    double
+    theta( double strike,      // option strike
+           double assetPrice,  // underlying asset's current value
+           double vol,         // volatility
+           double rate,        // risk free rate of interest
+           double T,           // time to maturity (year fraction)
+           double yield = 0.0, // annualised yield of underlying asset over life of option (continuous compounded)
+           bool call = true ) const;
+
+    double
+    delta( double strike,      // option strike
+           double assetPrice,  // underlying asset's current value
+           double vol,         // volatility
+           double rate,        // risk free rate of interest
+           double T,           // time to maturity (year fraction)
+           double yield = 0.0, // annualised yield of underlying asset over life of option (continuous compounded)
+           bool call = true ) const;
+
+    double
+    gamma( double strike,      // option strike
+           double assetPrice,  // underlying asset's current value
+           double vol,         // volatility
+           double rate,        // risk free rate of interest
+           double T,           // time to maturity (year fraction)
+           double yield = 0.0, // annualised yield of underlying asset over life of option (continuous compounded)
+           bool call = true ) const;
+
+    double
+    rho( double strike,      // option strike
+         double assetPrice,  // underlying asset's current value
+         double vol,         // volatility
+         double rate,        // risk free rate of interest
+         double T,           // time to maturity (year fraction)
+         double yield = 0.0, // annualised yield of underlying asset over life of option (continuous compounded)
+         bool call = true ) const;
+
+    double
+    vega( double strike,      // option strike
+          double assetPrice,  // underlying asset's current value
+          double vol,         // volatility
+          double rate,        // risk free rate of interest
+          double T,           // time to maturity (year fraction)
+          double yield = 0.0, // annualised yield of underlying asset over life of option (continuous compounded)
+          bool call = true ) const;
+
+    double // the critical asset price at which early exercise becomes optimal
+    criticalPrice( double strike,
+                   double vol,
+                   double rate,
+                   double T,
+                   double yield = 0.0,
+                   bool call = true ) const;
+
+private:
+
+    enum Parameter { Time, Rate, Vol };
+
+    // the derivative of value() in T, rate or vol
+    double
+    sensitivity( double strike, double assetPrice, double vol, double rate, double T, double yield, bool call,
+                 Parameter x ) const;
+
+    // value, delta and gamma in one pass
+    void
+    evaluate( double strike, double assetPrice, double vol, double rate, double T, double yield, bool call,
+              double& value, double& delta, double& gamma ) const;
+
+    BlackScholes m_bs;
+};
+
+
+#endif
+
+///
@@ -0,0 +1,193 @@
+/* Batch Lattice Engine 18/10/2026
+
+ $$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$
+ $   BatchLattice.h - header   $
+ $$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$
+
+ Copyright (C) 2026  W.B. Yates
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see http://www.gnu.org/licenses/
+
+ History:
+
+ American CRR values (as BinomialTree::value) for many options at once. W independent trees with the
+ same number of steps are laid out side by side, node major and lane minor, and the backward induction
+ runs over all W lanes in lockstep: every lane has its own u, d, discounted probabilities, strike and
+ call/put sign, and early exercise is a max, so the innermost loop is a fixed length W loop without
+ branches that the compiler turns into SIMD instructions. Like BatchKernels::binomialTree each tree is
+ held as two rows of asset prices and option values.
+
+ value() groups options by step count (timeSteps = 0 uses timeSteps()) and fills unused lanes of the last
+ group with copies of a real option. Every option is priced on the lattice whatever its model.
+ W may be 4, 8 or 16; 8 doubles or 16 floats fill an AVX-512 register, 4 doubles an AVX2 one.
+ A BatchLattice holds its workspace and must not be shared between threads.
+
+ Examples
+
+    BatchLattice<double, 8> lattice( 200 );
+    std::vector<double> values( options.size() );
+    lattice.value( options, values );
+ */
+
+
+#ifndef __BATCHLATTICE_H__
+#define __BATCHLATTICE_H__
+
+#include <math.h>
+#include <span>
+#include <vector>
+#include <numeric>
+#include <algorithm>
+
+#ifndef __OPTIONPRICER_H__
+#include "OptionPricer.h"
+#endif
+
+#ifndef __ALIGNEDALLOCATOR_H__
+#include "AlignedAllocator.h"
+#endif
+
+
+template <typename Real = double, int W = 8>
+class BatchLattice
+{
+public:
+
+    static_assert( W == 4 || W == 8 || W == 16, "BatchLattice lanes must be 4, 8 or 16" );
+
+    explicit BatchLattice( int steps = 50 ): m_steps(steps), m_s(), m_v(), m_order() {}
+
+    int
+    timeSteps( void ) const { return m_steps; }
+
+    void
+    timeSteps( int n ) { m_steps = (n > 0) ? n : 1; }
+
+    // values.size() must be at least options.size()
+    void
+    value( std::span<const OptionSpec> options, std::span<double> values )
+    {
+        int n = (int) options.size();
+        if (n == 0 || (int) values.size() < n)
+            return;
+
+        // group options with the same number of steps
+        m_order.resize( n );
+        std::iota( m_order.begin(), m_order.end(), 0 );
+        std::stable_sort( m_order.begin(), m_order.end(), [&]( int a, int b ) { return steps( options[a] ) < steps( options[b] ); } );
+
+        const OptionSpec* lanes[W];
+        int first = 0;
+        while (first < n)
+        {
+            int N = steps( options[m_order[first]] );
+            int count = 0;
+            while (count < W && first + count < n && steps( options[m_order[first + count]] ) == N)
+            {
+                lanes[count] = &options[m_order[first + count]];
+                ++count;
+            }
+            for (int l = count; l < W; ++l)
+            {
+                lanes[l] = lanes[0];
+            }
+
+            Real out[W];
+            group( lanes, N, out );
+            for (int l = 0; l < count; ++l)
+            {
+                values[m_order[first + l]] = (double) out[l];
+            }
+            first += count;
+        }
+    }
+
+private:
+
+    int
+    steps( const OptionSpec& o ) const { return (o.timeSteps > 0) ? o.timeSteps : m_steps; }
+
+    void
+    group( const OptionSpec* const* o, int N, Real* out )
+    {
+        alignas(64) Real d[W], pu[W], pd[W], K[W], sign[W], x[W], u2[W];
+        for (int l = 0; l < W; ++l)
+        {
+            Real dt = Real(o[l]->T) / Real(N);
+            Real u = exp( Real(o[l]->vol) * sqrt( dt ) );
+            Real a = exp( Real(o[l]->rate - o[l]->yield) * dt );
+            Real discount = exp( -Real(o[l]->rate) * dt );
+            d[l] = Real(1) / u;
+            Real p = (a - d[l]) / (u - d[l]);
+            pu[l] = discount * p;
+            pd[l] = discount * (Real(1) - p);
+            K[l] = Real(o[l]->strike);
+            sign[l] = (o[l]->call) ? Real(1) : Real(-1);
+            x[l] = Real(o[l]->assetPrice) * pow( d[l], Real(N) );
+            u2[l] = u * u;
+        }
+
+        m_s.resize( (size_t) (N + 1) * W );
+        m_v.resize( (size_t) (N + 1) * W );
+        Real* s = m_s.data();
+        Real* v = m_v.data();
+
+        // last step: node n is S u^(2n - N)
+        for (int n = 0; n <= N; ++n)
+        {
+            Real* sn = s + n * W;
+            Real* vn = v + n * W;
+            for (int l = 0; l < W; ++l)
+            {
+                sn[l] = x[l];
+                x[l] *= u2[l];
+                Real e = sign[l] * (sn[l] - K[l]);
+                vn[l] = (e > Real(0)) ? e : Real(0);
+            }
+        }
+
+        for (int m = N - 1; m >= 0; --m)
+        {
+            for (int n = 0; n <= m; ++n)
+            {
+                Real* sn = s + n * W;
+                Real* vn = v + n * W;
+                const Real* s1 = sn + W;
+                const Real* v1 = vn + W;
+                for (int l = 0; l < W; ++l)
+                {
+                    sn[l] = s1[l] * d[l];
+                    Real hold = pd[l] * vn[l] + pu[l] * v1[l];
+                    Real e = sign[l] * (sn[l] - K[l]);
+                    vn[l] = (hold > e) ? hold : e;
+                }
+            }
+        }
+
+        for (int l = 0; l < W; ++l)
+        {
+            out[l] = v[l];
+        }
+    }
+
+    int m_steps;
+    std::vector<Real, AlignedAllocator<Real>> m_s;  // asset prices, (steps + 1) x W
+    std::vector<Real, AlignedAllocator<Real>> m_v;  // option values, (steps + 1) x W
+    std::vector<int> m_order;
+};
+
+
+#endif
+
+///
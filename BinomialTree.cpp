@@ -20,7 +20,29 @@
 #include "NearZero.h"
 #endif
 
+#ifndef __BLACKSCHOLES_H__
+#include "BlackScholes.h"
+#endif
+
+#ifndef __BARONEADESIWHALEY_H__
+#include "BaroneAdesiWhaley.h"
+#endif
+
 #include <math.h>
+#include <algorithm>
+
+
+namespace {
+
+// log n!; lgamma_r, as lgamma writes the global signgam and trees run on several threads at once
+inline double
+logFactorial( double n )
+{
+    int sign;
+    return lgamma_r( n + 1.0, &sign );
+}
+
+}
 
 
 double
@@ -33,6 +55,18 @@ BinomialTree::value( double strike, // option strike
                   bool call ) 
 
 {
+    PRICE_STATS_TIMER( StatsModel::BinomialTree );
+    PRICE_STATS_TREE( m_stepNumber - 1 );
+
+    // with pruning an American call without a yield takes the European path, as it is never exercised early
+    bool early = m_american && !(m_pruning && call && yield == 0.0 && rate >= 0.0);
+    if (!early && european( strike, assetPrice, vol, rate, maturity, yield, call ))
+    {
+        if (m_pruning)
+            m_boundary.assign( m_stepNumber - 1, NAN );
+        PRICE_STATS_VALUE( StatsModel::BinomialTree, m_v[0][0] );
+        return m_v[0][0];
+    }
         
     // How many time steps to maturity
     double dt = maturity / double(m_stepNumber-1);
@@ -50,7 +84,7 @@ BinomialTree::value( double strike, // option strike
     
     for (int m = 1; m < m_stepNumber; m++)
     {
-        for (int n = m + 1; n > 0 ;n--)
+        for (int n = m; n > 0 ;n--)
         {
             m_s[m][n] = u * m_s[m - 1][n - 1];
         }
@@ -63,6 +97,43 @@ BinomialTree::value( double strike, // option strike
     }
     
     double discount = exp(-rate * dt);
+    if (!early)
+    {
+        // with p outside (0, 1), a large rate or yield over few steps, the tree is no price at all;
+        // otherwise this is a European value the terminal sum declined (no positive price or strike)
+        if (!(p > 0.0 && p < 1.0))
+        {
+            // and the nodes the Greeks read are NaN too
+            for (int m = std::min( 2, m_stepNumber - 1 ); m >= 0; m--)
+            {
+                for (int n = 0; n <= m; n++)
+                {
+                    m_v[m][n] = NAN;
+                }
+            }
+            PRICE_STATS_VALUE( StatsModel::BinomialTree, NAN );
+            return NAN;
+        }
+        for (int m = m_stepNumber - 2; m >= 0; m--)
+        {
+            for (int n = 0; n <= m; n++)
+            {
+                m_v[m][n] = discount * (((1 - p) * m_v[m+1][n]) + (p * m_v[m+1][n+1]));
+            }
+        }
+        if (m_pruning)
+            m_boundary.assign( m_stepNumber - 1, NAN );
+        PRICE_STATS_VALUE( StatsModel::BinomialTree, m_v[0][0] );
+        return m_v[0][0];
+    }
+
+    if (m_pruning && rate >= 0.0 && yield >= 0.0)
+    {
+        prune( strike, assetPrice, vol * sqrtDt, p, discount, call );
+        PRICE_STATS_VALUE( StatsModel::BinomialTree, m_v[0][0] );
+        return m_v[0][0];
+    }
+
     for (int m = m_stepNumber - 2; m >= 0; m--)
     {
         for (int n = 0; n <= m; n++)
@@ -73,9 +144,359 @@ BinomialTree::value( double strike, // option strike
         }
     }
 
+    PRICE_STATS_VALUE( StatsModel::BinomialTree, m_v[0][0] );
     return m_v[0][0];
 }
 
+bool
+BinomialTree::european( double strike, double assetPrice, double vol, double rate, double maturity, double yield, bool call )
+{
+    int steps = m_stepNumber - 1;
+    int rows = std::min( m_rows, steps );
+    double dt = maturity / double(steps);
+    double logU = vol * sqrt(dt);
+    double u = exp( logU );
+    double d = exp( -logU );
+    double a = exp( (rate - yield) * dt );
+    double p = (a - d) / (u - d);
+    if (!(p > 0.0 && p < 1.0 && assetPrice > 0.0 && strike > 0.0))
+        return false;
+
+    double logP = log( p ), logQ = log( 1.0 - p ), ratio = p / (1.0 - p);
+    double u2 = u * u;
+    // terminal node i, counting up moves, is in the money from here for a call and below it for a put
+    int money = (int) floor( 0.5 * (log( strike / assetPrice ) / logU + steps) ) + 1;
+
+    if ((int) m_w.size() < steps + 1)
+        m_w.resize( steps + 1 );
+    double* w = m_w.data();
+
+    for (int m = rows; m >= 0; --m)
+    {
+        // probabilities of j up moves in the remaining M steps, outwards from the most likely j
+        int M = steps - m;
+        int mode = std::min( (int) ((M + 1) * p), M );
+        w[mode] = exp( logFactorial( M ) - logFactorial( mode ) - logFactorial( M - mode ) + mode * logP + (M - mode) * logQ );
+        double cut = w[mode] * 1E-18;
+        int hi = mode, lo = mode;
+        while (hi < M && w[hi] > cut)
+        {
+            w[hi + 1] = w[hi] * ratio * double(M - hi) / double(hi + 1);
+            ++hi;
+        }
+        while (lo > 0 && w[lo] > cut)
+        {
+            w[lo - 1] = w[lo] / ratio * double(lo) / double(M - lo + 1);
+            --lo;
+        }
+
+        double discount = exp( -rate * dt * M );
+        for (int n = 0; n <= m; ++n)
+        {
+            m_s[m][n] = assetPrice * exp( (2 * n - m) * logU );
+
+            // node n reaches terminal node n + j; only the in the money ones pay
+            int first = lo, last = hi;
+            if (call)
+                first = std::max( first, money - n );
+            else
+                last = std::min( last, money - n - 1 );
+
+            double sum = 0.0;
+            double price = assetPrice * exp( (2 * (n + first) - steps) * logU );
+            for (int j = first; j <= last; ++j)
+            {
+                sum += w[j] * payOff( strike, price, call );
+                price *= u2;
+            }
+            m_v[m][n] = discount * sum;
+        }
+    }
+    return true;
+}
+
+void
+BinomialTree::prune( double strike, double assetPrice, double logU, double p, double discount, bool call )
+{
+    // Backward induction which finds the exercise boundary on each step and computes continuation values
+    // only on its far side. With rates and yield not negative a put is exercised at and below the boundary
+    // node and a call at and above it, and the boundary moves by about one node a step, so it is found by
+    // a short walk from last step's (or the hint's) and the nodes beyond it are their intrinsic values.
+    int steps = m_stepNumber - 1;
+    bool hinted = (int) m_hint.size() == steps;
+    m_boundary.assign( steps, NAN );
+
+    // the boundary node of the step after; none is below the tree for a put, above it for a call
+    int next = (call) ? steps + 1 : -1;
+    for (int m = steps - 1; m >= 0; --m)
+    {
+        Matrix<double>::ConstRow V = m_v[m + 1];
+        Matrix<double>::ConstRow S = m_s[m];
+        auto hold = [&]( int n ) { return discount * (((1 - p) * V[n]) + (p * V[n + 1])); };
+        auto exercised = [&]( int n ) { double x = payOff( strike, S[n], call ); return x > 0.0 && x >= hold( n ); };
+
+        int b = (call) ? next : next - 1;
+        if (hinted && m_hint[m] > 0.0)
+            b = (int) floor( 0.5 * (log( m_hint[m] / assetPrice ) / logU + m) + 0.5 );
+
+        if (call)
+        {
+            b = (b < 0) ? 0 : (b > m + 1) ? m + 1 : b;
+            while (b <= m && !exercised( b ))
+                ++b;
+            while (b > 0 && exercised( b - 1 ))
+                --b;
+            for (int n = 0; n < b; ++n)
+                m_v[m][n] = hold( n );
+            for (int n = b; n <= m; ++n)
+                m_v[m][n] = S[n] - strike;
+        }
+        else
+        {
+            b = (b < -1) ? -1 : (b > m) ? m : b;
+            while (b >= 0 && !exercised( b ))
+                --b;
+            while (b < m && exercised( b + 1 ))
+                ++b;
+            for (int n = 0; n <= b; ++n)
+                m_v[m][n] = strike - S[n];
+            for (int n = b + 1; n <= m; ++n)
+                m_v[m][n] = hold( n );
+        }
+
+        if (b >= 0 && b <= m)
+            m_boundary[m] = S[b];
+        next = b;
+    }
+}
+
+double
+BinomialTree::startVol( double strike, double assetPrice, double marketPrice, double rate, double T, double yield, bool call ) const
+{
+    // BlackScholes::impliedVol inverts call prices, so puts go through put-call parity
+    BlackScholes bs;
+    BaroneAdesiWhaley baw;
+    double parity = assetPrice * exp(-yield * T) - strike * exp(-rate * T);
+
+    double vol = bs.impliedVol( strike, assetPrice, (call) ? marketPrice : marketPrice + parity, rate, T, yield );
+    if (!(vol > 0.0 && vol < 5.0))
+        return 0.3;
+
+    // take off the early exercise premium at that vol and solve again
+    double premium = baw.value( strike, assetPrice, vol, rate, T, yield, call ) - bs.value( strike, assetPrice, vol, rate, T, yield, call );
+    double european = marketPrice - dmax( premium, 0.0 );
+    double v = bs.impliedVol( strike, assetPrice, (call) ? european : european + parity, rate, T, yield );
+    return (v > 0.0 && v < 5.0) ? v : vol;
+}
+
+double
+BinomialTree::impliedVol( double strike,      // option strike
+                          double assetPrice,  // underlying asset's current value
+                          double marketPrice, // market price of option
+                          double rate,        // risk free rate of interest
+                          double T,           // time to maturity (year fraction)
+                          double yield,       // annualised yield of underlying asset over life of option (continuous compounded)
+                          bool call,
+                          double guess )      // starting vol; 0 for none
+{
+    const double LO = 1E-4, HI = 5.0;
+    const double tolerance = 1E-8 * dmax( marketPrice, 1E-4 );
+    int iterations = 0;
+
+    double start = (guess > 0.0) ? guess : startVol( strike, assetPrice, marketPrice, rate, T, yield, call );
+    start = (start < LO) ? LO : (start > HI) ? HI : start;
+
+    double a = start;
+    double fa = value( strike, assetPrice, a, rate, T, yield, call ) - marketPrice;
+    ++iterations;
+    if (fabs(fa) <= tolerance)
+    {
+        PRICE_STATS_IMPLIEDVOL( StatsModel::BinomialTree, iterations, true );
+        return a;
+    }
+
+    // a Newton step with the BlackScholes vega, a little overshot so that a good start brackets the root
+    BlackScholes bs;
+    double vega = bs.vega( strike, assetPrice, a, rate, T, yield );
+    double step = (vega > 1E-12) ? -1.05 * fa / vega : ((fa > 0.0) ? -0.5 * a : a);
+    double b = a + ((step > a) ? a : (step < -0.5 * a) ? -0.5 * a : step);
+    b = (b < LO) ? LO : (b > HI) ? HI : b;
+    double fb = value( strike, assetPrice, b, rate, T, yield, call ) - marketPrice;
+    ++iterations;
+
+    // otherwise widen geometrically in the direction of the root; value rises with vol
+    while (fa * fb > 0.0)
+    {
+        double lo = std::min( a, b ), hi = std::max( a, b );
+        double flo = (lo == a) ? fa : fb, fhi = (hi == a) ? fa : fb;
+        // too dear at the lowest vol or too cheap at the highest cannot be matched
+        if ((flo > 0.0 && lo <= LO) || (fhi < 0.0 && hi >= HI))
+        {
+            PRICE_STATS_IMPLIEDVOL( StatsModel::BinomialTree, iterations, false );
+            return NAN;
+        }
+        a = (flo > 0.0) ? lo : hi;
+        fa = (flo > 0.0) ? flo : fhi;
+        b = (flo > 0.0) ? dmax( lo * 0.5, LO ) : std::min( hi * 2.0, HI );
+        fb = value( strike, assetPrice, b, rate, T, yield, call ) - marketPrice;
+        ++iterations;
+    }
+
+    // Brent's method (Numerical Recipes, zbrent)
+    double c = b, fc = fb, d = b - a, e = d;
+    bool converged = false;
+    for (int i = 0; i < 100; ++i)
+    {
+        if (fb * fc > 0.0)
+        {
+            c = a;
+            fc = fa;
+            d = e = b - a;
+        }
+        if (fabs(fc) < fabs(fb))
+        {
+            a = b; b = c; c = a;
+            fa = fb; fb = fc; fc = fa;
+        }
+
+        double tol = 2.0 * 1E-15 * fabs(b) + 0.5E-8;
+        double m = 0.5 * (c - b);
+        if (fabs(m) <= tol || fabs(fb) <= tolerance)
+        {
+            converged = true;
+            break;
+        }
+
+        if (fabs(e) >= tol && fabs(fa) > fabs(fb))
+        {
+            // secant or inverse quadratic interpolation
+            double p, q, r, t = fb / fa;
+            if (a == c)
+            {
+                p = 2.0 * m * t;
+                q = 1.0 - t;
+            }
+            else
+            {
+                q = fa / fc;
+                r = fb / fc;
+                p = t * (2.0 * m * q * (q - r) - (b - a) * (r - 1.0));
+                q = (q - 1.0) * (r - 1.0) * (t - 1.0);
+            }
+            if (p > 0.0)
+                q = -q;
+            p = fabs(p);
+            if (2.0 * p < std::min( 3.0 * m * q - fabs(tol * q), fabs(e * q) ))
+            {
+                e = d;
+                d = p / q;
+            }
+            else
+            {
+                d = m;
+                e = d;
+            }
+        }
+        else
+        {
+            d = m;
+            e = d;
+        }
+
+        a = b;
+        fa = fb;
+        b += (fabs(d) > tol) ? d : ((m > 0.0) ? tol : -tol);
+        fb = value( strike, assetPrice, b, rate, T, yield, call ) - marketPrice;
+        ++iterations;
+    }
+
+    PRICE_STATS_IMPLIEDVOL( StatsModel::BinomialTree, iterations, converged );
+    return (converged) ? b : NAN;
+}
+
+bool
+BinomialTree::spotLadder( double strike,      // option strike
+                          double assetPrice,  // underlying asset's current value
+                          double vol,         // volatility
+                          double rate,        // risk free rate of interest
+                          double T,           // time to maturity (year fraction)
+                          double yield,       // annualised yield of underlying asset over life of option (continuous compounded)
+                          bool call,
+                          const std::vector<double>& spots,
+                          std::vector<SpotPoint>& ladder )
+{
+    ladder.clear();
+    if (spots.empty() || !(assetPrice > 0.0 && vol > 0.0 && T > 0.0))
+        return false;
+
+    double lo = spots[0], hi = spots[0];
+    for (double x : spots)
+    {
+        lo = (x < lo) ? x : lo;
+        hi = (x > hi) ? x : hi;
+    }
+    if (!(lo > 0.0))
+        return false;
+
+    int steps = m_stepNumber - 1;
+    double dt = T / double(steps);
+    double logU = vol * sqrt(dt);
+
+    // today's row of a tree started k steps earlier holds assetPrice * u^(2j - k), j = 0..k;
+    // keep spare nodes beyond the ladder so every spot lies between two interior nodes
+    double reach = dmax( log( hi / assetPrice ), log( assetPrice / lo ) );
+    int half = (int) ceil( reach / (2.0 * logU) ) + 2;
+    int k = 2 * half;
+
+    int saved = m_stepNumber;
+    m_stepNumber = saved + k;
+    m_rows = k;
+    if (m_s.rows() < m_stepNumber)
+    {
+        m_s.resize( m_stepNumber, m_stepNumber, 0.0 );
+        m_v.resize( m_stepNumber, m_stepNumber, 0.0 );
+    }
+    value( strike, assetPrice, vol, rate, T * double(steps + k) / double(steps), yield, call );
+    m_stepNumber = saved;
+    m_rows = 2;
+
+    Matrix<double>::ConstRow S = m_s[k];
+    Matrix<double>::ConstRow V = m_v[k];
+
+    // delta and gamma at the interior nodes from three point differences on the geometric grid
+    m_greeks.resize( 2 * (k + 1) );
+    double* D = m_greeks.data();
+    double* G = D + k + 1;
+    for (int n = 1; n < k; ++n)
+    {
+        double h1 = S[n] - S[n - 1], h2 = S[n + 1] - S[n];
+        double up = (V[n + 1] - V[n]) / h2, down = (V[n] - V[n - 1]) / h1;
+        D[n] = (up * h1 + down * h2) / (h1 + h2);
+        G[n] = 2.0 * (up - down) / (h1 + h2);
+    }
+
+    ladder.resize( spots.size() );
+    for (size_t i = 0; i < spots.size(); ++i)
+    {
+        // interior nodes j and j + 1 either side of the spot
+        int j = (int) floor( 0.5 * (log( spots[i] / assetPrice ) / logU + k) );
+        j = (j < 1) ? 1 : (j > k - 2) ? k - 2 : j;
+
+        // cubic Hermite value through both nodes' values and deltas; gamma linear between them
+        double h = S[j + 1] - S[j];
+        double t = (spots[i] - S[j]) / h;
+        double t2 = t * t, t3 = t2 * t;
+        double h00 = 2 * t3 - 3 * t2 + 1, h10 = t3 - 2 * t2 + t, h01 = -2 * t3 + 3 * t2, h11 = t3 - t2;
+        double d00 = 6 * t2 - 6 * t, d10 = 3 * t2 - 4 * t + 1, d01 = -6 * t2 + 6 * t, d11 = 3 * t2 - 2 * t;
+
+        ladder[i].assetPrice = spots[i];
+        ladder[i].value = h00 * V[j] + h10 * h * D[j] + h01 * V[j + 1] + h11 * h * D[j + 1];
+        ladder[i].delta = (d00 * V[j] + d01 * V[j + 1]) / h + d10 * D[j] + d11 * D[j + 1];
+        ladder[i].gamma = (1.0 - t) * G[j] + t * G[j + 1];
+    }
+    return true;
+}
+
 double
 BinomialTree::delta( double strike,      // option strike
                       double assetPrice,  // underlying asset's current value
@@ -87,14 +508,7 @@ BinomialTree::delta( double strike,      // option strike
 {
 
     value( strike, assetPrice, vol, rate, maturity, yield, call );
-    
-    double dt = maturity / double(m_stepNumber-1);
-    double sqrtDt = sqrt(dt);
-    double u = exp( vol * sqrtDt );
-    double d = exp( -vol * sqrtDt );    
-
-    double delta = (m_v[1][1] - m_v[1][0]) / ((assetPrice * u) - (assetPrice * d));
-    return delta;
+    return delta();
 }
 
 double
@@ -103,19 +517,27 @@ BinomialTree::gamma( double strike,      // option strike
                     double vol,         // volatility
                     double rate,        // risk free rate of interest
                     double maturity,           // time to maturity (year fraction)
-                    double yield ) // annualised yield of underlying asset over life of option (continuous compounded)
+                    double yield, // annualised yield of underlying asset over life of option (continuous compounded)
+                    bool call )
 {
     
-    value( strike, assetPrice, vol, rate, maturity, yield, true );
-    
-    double dt = maturity / double(m_stepNumber-1);
-    double sqrtDt = sqrt(dt);
-    double u = exp( vol * sqrtDt );
-    double d = exp( -vol * sqrtDt );    
-    
-    double h = 0.5 * ((assetPrice * u * u) - (assetPrice * d * d));
-    double delta1 = (m_v[2][2] - m_v[2][1]) / ((assetPrice * u * u) - assetPrice);
-    double delta2 = (m_v[2][1] - m_v[2][0]) / (assetPrice - (assetPrice * d * d));
+    value( strike, assetPrice, vol, rate, maturity, yield, call );
+    return gamma();
+}
+
+double
+BinomialTree::delta( void ) const
+{
+    // m_s[1] holds S u and S d, m_s[2] S u^2, S and S d^2
+    return (m_v[1][1] - m_v[1][0]) / (m_s[1][1] - m_s[1][0]);
+}
+
+double
+BinomialTree::gamma( void ) const
+{
+    double h = 0.5 * (m_s[2][2] - m_s[2][0]);
+    double delta1 = (m_v[2][2] - m_v[2][1]) / (m_s[2][2] - m_s[0][0]);
+    double delta2 = (m_v[2][1] - m_v[2][0]) / (m_s[0][0] - m_s[2][0]);
     return (delta1 - delta2) / h;
 }
 
@@ -25,6 +25,21 @@
  Cox-Ross-Rubenstein binomial tree option price model (see Hull, 6th edition, page 393)
  Suitable for pricing, for example, American options 
  
+ With american(false) the tree prices European options without building it: the value at a node is the
+ discounted binomial sum of the terminal payoffs below it, and only the few nodes value() and the Greeks
+ read are summed. Coefficients start from the most likely terminal node, in logs, and are carried outwards
+ until they fall below double precision, and out of the money terminal nodes are skipped, so a value costs
+ O(sqrt(N)) rather than O(N^2) and agrees with the full European tree to rounding.
+ Where the up probability is outside (0, 1), a large rate or yield over few steps, a European value()
+ is NaN.
+ 
+ With pruning(true) an American value() tracks the early exercise boundary instead of testing every node:
+ on each step the boundary is found by a short walk from the previous step's, continuation values are
+ computed on one side of it and intrinsic values filled in on the other. An American call without a yield
+ is never exercised early, so it is priced on the European path. boundary() then holds the critical asset
+ price on each step, and passing it back through boundaryHint() starts the next reprice's walks from it.
+ Pruning needs a single boundary, so it is used only when the rate and yield are not negative.
+ 
  Examples
  
  BinomialTree bt;
@@ -40,6 +55,23 @@
  int MAXSTEP = 5
  std::cout << "value is " <<  bt.value(strike, assetPrice, vol, rate, T, yield, call) << std::endl;
 
+ // the same option with European exercise, from the terminal sum
+ bt.american( false );
+ std::cout << "European value is " <<  bt.value(strike, assetPrice, vol, rate, T, yield, call) << std::endl;
+ bt.american( true );
+
+ // an American put with boundary tracking, repriced from the boundary it found
+ bt.pruning( true );
+ double put = bt.value(strike, assetPrice, vol, rate, T, yield, false);
+ bt.boundaryHint( bt.boundary() );
+ put = bt.value(strike, assetPrice * 1.001, vol, rate, T, yield, false);
+
+ // price, delta and gamma at 41 spots from 40 to 60 from one tree build
+ std::vector<double> spots;
+ for (int i = 0; i <= 40; ++i) spots.push_back( 40.0 + 0.5 * i );
+ std::vector<SpotPoint> ladder;
+ bt.spotLadder(strike, assetPrice, vol, rate, T, yield, call, spots, ladder);
+
  */
 #ifndef __BINOMIALTREE_H__
 #define __BINOMIALTREE_H__
@@ -51,13 +83,32 @@
 #include "AMatrix.h"
 #endif
 
+#ifndef __PRICESTATS_H__
+#include "PriceStats.h"
+#endif
+
+struct SpotPoint
+{
+    double assetPrice;
+    double value;
+    double delta;
+    double gamma;
+};
+
 class BinomialTree
 {
 public:
     
     BinomialTree(): m_stepNumber(51), // 50 plus today
                     m_s(m_stepNumber, m_stepNumber, 0.0), 
-                    m_v(m_stepNumber, m_stepNumber, 0.0) {}
+                    m_v(m_stepNumber, m_stepNumber, 0.0),
+                    m_greeks(),
+                    m_american(true),
+                    m_pruning(false),
+                    m_rows(2),
+                    m_w(),
+                    m_boundary(),
+                    m_hint() {}
    
     ~BinomialTree() 
     {
@@ -77,13 +128,19 @@ public:
          double yield = 0.0,  // annualised yield of underlying asset over life of option (continuous compounded)
          bool call = true ) ; 
     
-   /* double 
+    // Volatility at which value() matches marketPrice, by Brent's method on a bracket grown outwards from
+    // a start: guess if it is positive (a neighbouring strike's solution, say), otherwise the BlackScholes
+    // implied vol of marketPrice less a Barone-Adesi Whaley estimate of the early exercise premium.
+    // Returns NaN if marketPrice cannot be matched by a vol in [0.0001, 5].
+    double 
     impliedVol( double strike,         // option strike
                 double assetPrice,     // underlying asset's current value
                 double marketPrice,    // market price of option
                 double rate,           // risk free rate of interest
                 double T,              // time to maturity (year fraction)
-                double yield = 0.0 ) const;  // annualised yield of underlying asset over life of option (continuous compounded) */
+                double yield = 0.0,    // annualised yield of underlying asset over life of option (continuous compounded)
+                bool call = true,
+                double guess = 0.0 );  // starting vol; 0 for none
     
     double
     theta( double strike,      // option strike
@@ -109,7 +166,8 @@ public:
            double vol,         // volatility
            double rate,        // risk free rate of interest
            double T,           // time to maturity (year fraction)
-           double yield = 0.0 ) ; // annualised yield of underlying asset over life of option (continuous compounded)
+           double yield = 0.0, // annualised yield of underlying asset over life of option (continuous compounded)
+           bool call = true );
     
     double
     rho( double strike,      // option strike
@@ -128,21 +186,82 @@ public:
           double T,             // time to maturity (year fraction)
           double yield = 0.0 ); // annualised yield of underlying asset over life of option (continuous compounded)
     
+    // delta and gamma of the last value(), from the differences across its first two steps, as delta()
+    // and gamma() above compute them; NaN where that value was
+    double
+    delta( void ) const;
+    
+    double
+    gamma( void ) const;
+    
     
+    // Value, delta and gamma at each of spots from one tree build. The tree is extended to start k steps
+    // before today (k even, just large enough for its nodes today to span the spots), so today's row holds
+    // values over a ladder of spots with the time step of a timeSteps() tree, and its middle node is
+    // exactly value(). Delta and gamma come from differences along that row, and each spot is interpolated
+    // between its two neighbouring nodes (cubic Hermite in value, linear in gamma) so the profile is
+    // smooth (Pelsser and Vorst, 1994). Returns false if spots is empty or any price, vol or T is not positive.
+    bool
+    spotLadder( double strike,                    // option strike
+                double assetPrice,                // underlying asset's current value
+                double vol,                       // volatility
+                double rate,                      // risk free rate of interest
+                double T,                         // time to maturity (year fraction)
+                double yield,                     // annualised yield of underlying asset over life of option (continuous compounded)
+                bool call,
+                const std::vector<double>& spots, // asset prices of the ladder
+                std::vector<SpotPoint>& ladder ); // one point per spot
+
     int 
     timeSteps( void ) const { return m_stepNumber - 1; }
     
     void 
     timeSteps( const unsigned int ts ) 
     { 
+        if ((int) ts + 1 != m_stepNumber)
+            PRICE_STATS_RESIZE();
         m_stepNumber = ts + 1; // add a step for today
         m_s.resize(m_stepNumber, m_stepNumber, 0.0);
         m_v.resize(m_stepNumber, m_stepNumber, 0.0);
     } 
 
+    // early exercise; when false value() and the Greeks are European, from the terminal sum
+    bool
+    american( void ) const { return m_american; }
+
+    void
+    american( bool a ) { m_american = a; }
+
+    // early exercise boundary tracking for American values
+    bool
+    pruning( void ) const { return m_pruning; }
+
+    void
+    pruning( bool b ) { m_pruning = b; }
+
+    // the critical asset price at each step 0 to timeSteps() - 1 of the last pruned value(), NaN where
+    // no node is exercised: the highest exercised price for a put, the lowest for a call
+    const std::vector<double>&
+    boundary( void ) const { return m_boundary; }
+
+    // a boundary of the same number of steps to start the next pruned value() from; empty for none
+    void
+    boundaryHint( const std::vector<double>& hint ) { m_hint = hint; }
+
         
 private:
     
+    // fills rows 0 to m_rows of m_s and m_v from the terminal sum; false if p is not a probability
+    bool
+    european( double strike, double assetPrice, double vol, double rate, double T, double yield, bool call );
+
+    // backward induction over the continuation region only, given the asset price tree and terminal values
+    void
+    prune( double strike, double assetPrice, double logU, double p, double discount, bool call );
+    
+    double
+    startVol( double strike, double assetPrice, double marketPrice, double rate, double T, double yield, bool call ) const;
+
     inline double 
     dmax(double x, double y) const { return (x > y) ?  x : y; }
     
@@ -155,6 +274,13 @@ private:
     int m_stepNumber;
     Matrix<double> m_s;  // asset price tree
     Matrix<double> m_v;  // option value tree   
+    std::vector<double> m_greeks;  // spotLadder workspace
+    bool m_american;
+    bool m_pruning;
+    int m_rows;                    // rows european() fills, 2 unless spotLadder needs more
+    std::vector<double> m_w;       // european() terminal probabilities
+    std::vector<double> m_boundary;
+    std::vector<double> m_hint;
 };
 
 
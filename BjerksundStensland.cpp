@@ -0,0 +1,293 @@
+/* Bjerksund Stensland American Option Approximation 18/10/2026
+
+ $$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$
+ $   BjerksundStensland.cpp - code   $
+ $$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$
+
+ by W.B. Yates
+ Copyright (c) W.B. Yates. All rights reserved.
+ History:
+
+ */
+
+#include <math.h>
+
+#ifndef __BJERKSUNDSTENSLAND_H__
+#include "BjerksundStensland.h"
+#endif
+
+
+double
+BjerksundStensland::value( double strike,      // option strike
+                           double assetPrice,  // underlying asset's current value
+                           double vol,         // volatility
+                           double rate,        // risk free rate of interest
+                           double T,           // time to maturity (year fraction)
+                           double yield,       // annualised yield of underlying asset over life of option (continuous compounded)
+                           bool call ) const
+{
+    double b = rate - yield;
+    if (call)
+        return callValue( strike, assetPrice, vol, rate, b, T );
+    else return callValue( assetPrice, strike, vol, rate - b, -b, T );
+}
+
+double
+BjerksundStensland::callValue( double strike, double assetPrice, double vol, double rate, double b, double T ) const
+// see Haug (2nd edition), page 104
+{
+    // never optimal to exercise early
+    if (b >= rate)
+        return m_bs.value( strike, assetPrice, vol, rate, T, rate - b, true );
+
+    double vol2 = vol * vol;
+    double t1 = 0.5 * (sqrt(5.0) - 1.0) * T;
+    double beta = (0.5 - b / vol2) + sqrt( (b / vol2 - 0.5) * (b / vol2 - 0.5) + 2.0 * rate / vol2 );
+    double bInfinity = beta / (beta - 1.0) * strike;
+    double b0 = fmax( strike, rate / (rate - b) * strike );
+    double ht1 = -(b * t1 + 2.0 * vol * sqrt(t1)) * strike * strike / ((bInfinity - b0) * b0);
+    double ht2 = -(b * T + 2.0 * vol * sqrt(T)) * strike * strike / ((bInfinity - b0) * b0);
+    double i1 = b0 + (bInfinity - b0) * (1.0 - exp(ht1));
+    double i2 = b0 + (bInfinity - b0) * (1.0 - exp(ht2));
+    double alfa1 = (i1 - strike) * pow( i1, -beta );
+    double alfa2 = (i2 - strike) * pow( i2, -beta );
+
+    double S = assetPrice;
+    if (S >= i2)
+        return S - strike;
+
+    return alfa2 * pow( S, beta ) - alfa2 * phi( S, t1, beta, i2, i2, rate, b, vol )
+         + phi( S, t1, 1.0, i2, i2, rate, b, vol ) - phi( S, t1, 1.0, i1, i2, rate, b, vol )
+         - strike * phi( S, t1, 0.0, i2, i2, rate, b, vol ) + strike * phi( S, t1, 0.0, i1, i2, rate, b, vol )
+         + alfa1 * phi( S, t1, beta, i1, i2, rate, b, vol ) - alfa1 * ksi( S, T, beta, i1, i2, i1, t1, rate, b, vol )
+         + ksi( S, T, 1.0, i1, i2, i1, t1, rate, b, vol ) - ksi( S, T, 1.0, strike, i2, i1, t1, rate, b, vol )
+         - strike * ksi( S, T, 0.0, i1, i2, i1, t1, rate, b, vol ) + strike * ksi( S, T, 0.0, strike, i2, i1, t1, rate, b, vol );
+}
+
+double
+BjerksundStensland::phi( double S, double T, double gamma, double H, double I, double rate, double b, double vol ) const
+{
+    double vol2 = vol * vol;
+    double sqrtT = sqrt(T);
+    double lambda = (-rate + gamma * b + 0.5 * gamma * (gamma - 1.0) * vol2) * T;
+    double d = -(log(S / H) + (b + (gamma - 0.5) * vol2) * T) / (vol * sqrtT);
+    double kappa = 2.0 * b / vol2 + 2.0 * gamma - 1.0;
+    return exp(lambda) * pow( S, gamma ) * (m_bs.N(d) - pow( I / S, kappa ) * m_bs.N(d - 2.0 * log(I / S) / (vol * sqrtT)));
+}
+
+double
+BjerksundStensland::ksi( double S, double T2, double gamma, double H, double I2, double I1, double t1, double rate, double b, double vol ) const
+{
+    double vol2 = vol * vol;
+    double drift = b + (gamma - 0.5) * vol2;
+    double v1 = vol * sqrt(t1);
+    double v2 = vol * sqrt(T2);
+
+    double e1 = (log(S / I1) + drift * t1) / v1;
+    double e2 = (log(I2 * I2 / (S * I1)) + drift * t1) / v1;
+    double e3 = (log(S / I1) - drift * t1) / v1;
+    double e4 = (log(I2 * I2 / (S * I1)) - drift * t1) / v1;
+
+    double f1 = (log(S / H) + drift * T2) / v2;
+    double f2 = (log(I2 * I2 / (S * H)) + drift * T2) / v2;
+    double f3 = (log(I1 * I1 / (S * H)) + drift * T2) / v2;
+    double f4 = (log(S * I1 * I1 / (H * I2 * I2)) + drift * T2) / v2;
+
+    double rho = sqrt(t1 / T2);
+    double lambda = -rate + gamma * b + 0.5 * gamma * (gamma - 1.0) * vol2;
+    double kappa = 2.0 * b / vol2 + (2.0 * gamma - 1.0);
+
+    return exp(lambda * T2) * pow( S, gamma ) * (M( -e1, -f1, rho )
+                                                 - pow( I2 / S, kappa ) * M( -e2, -f2, rho )
+                                                 - pow( I1 / S, kappa ) * M( -e3, -f3, -rho )
+                                                 + pow( I1 / I2, kappa ) * M( -e4, -f4, -rho ));
+}
+
+// the cumulative bivariate normal distribution function
+double
+BjerksundStensland::M( double a, double b, double rho ) const
+// Genz (2004), "Numerical computation of rectangular bivariate and trivariate normal and t probabilities",
+// Gauss-Legendre quadrature of the Drezner-Wesolowsky integral; see also West (2005)
+{
+    static const double W[3][10] = {
+        { 0.1713244923791705, 0.3607615730481384, 0.4679139345726904 },
+        { 0.04717533638651177, 0.1069393259953183, 0.1600783285433464,
+          0.2031674267230659, 0.2334925365383547, 0.2491470458134029 },
+        { 0.01761400713915212, 0.04060142980038694, 0.06267204833410906,
+          0.08327674157670475, 0.1019301198172404, 0.1181945319615184,
+          0.1316886384491766, 0.1420961093183821, 0.1491729864726037, 0.1527533871307259 } };
+
+    static const double X[3][10] = {
+        { -0.9324695142031522, -0.6612093864662647, -0.2386191860831970 },
+        { -0.9815606342467191, -0.9041172563704750, -0.7699026741943050,
+          -0.5873179542866171, -0.3678314989981802, -0.1252334085114692 },
+        { -0.9931285991850949, -0.9639719272779138, -0.9122344282513259,
+          -0.8391169718222188, -0.7463319064601508, -0.6360536807265150,
+          -0.5108670019508271, -0.3737060887154196, -0.2277858511416451, -0.07652652113349733 } };
+
+    const double Pi = 3.141592653589793238462643;
+
+    int ng, lg;
+    if (fabs(rho) < 0.3)
+    {
+        ng = 0; lg = 3;
+    }
+    else if (fabs(rho) < 0.75)
+    {
+        ng = 1; lg = 6;
+    }
+    else
+    {
+        ng = 2; lg = 10;
+    }
+
+    double h = -a;
+    double k = -b;
+    double hk = h * k;
+    double bvn = 0.0;
+
+    if (fabs(rho) < 0.925)
+    {
+        if (fabs(rho) > 0.0)
+        {
+            double hs = (h * h + k * k) / 2.0;
+            double asr = asin(rho);
+            for (int i = 0; i < lg; ++i)
+            {
+                for (int is = -1; is <= 1; is += 2)
+                {
+                    double sn = sin(asr * (is * X[ng][i] + 1.0) / 2.0);
+                    bvn += W[ng][i] * exp((sn * hk - hs) / (1.0 - sn * sn));
+                }
+            }
+            bvn = bvn * asr / (4.0 * Pi);
+        }
+        bvn += m_bs.N(-h) * m_bs.N(-k);
+        return bvn;
+    }
+
+    if (rho < 0.0)
+    {
+        k = -k;
+        hk = -hk;
+    }
+
+    if (fabs(rho) < 1.0)
+    {
+        double as = (1.0 - rho) * (1.0 + rho);
+        double aa = sqrt(as);
+        double bs = (h - k) * (h - k);
+        double c = (4.0 - hk) / 8.0;
+        double d = (12.0 - hk) / 16.0;
+        double asr = -(bs / as + hk) / 2.0;
+        if (asr > -100.0)
+            bvn = aa * exp(asr) * (1.0 - c * (bs - as) * (1.0 - d * bs / 5.0) / 3.0 + c * d * as * as / 5.0);
+        if (-hk < 100.0)
+        {
+            double bb = sqrt(bs);
+            bvn -= exp(-hk / 2.0) * sqrt(2.0 * Pi) * m_bs.N(-bb / aa) * bb * (1.0 - c * bs * (1.0 - d * bs / 5.0) / 3.0);
+        }
+        aa /= 2.0;
+        for (int i = 0; i < lg; ++i)
+        {
+            for (int is = -1; is <= 1; is += 2)
+            {
+                double xs = aa * (is * X[ng][i] + 1.0);
+                xs *= xs;
+                double rs = sqrt(1.0 - xs);
+                asr = -(bs / xs + hk) / 2.0;
+                if (asr > -100.0)
+                    bvn += aa * W[ng][i] * exp(asr) * (exp(-hk * (1.0 - rs) / (2.0 * (1.0 + rs))) / rs - (1.0 + c * xs * (1.0 + d * xs)));
+            }
+        }
+        bvn = -bvn / (2.0 * Pi);
+    }
+
+    if (rho > 0.0)
+        bvn += m_bs.N(-fmax(h, k));
+    else
+    {
+        bvn = -bvn;
+        if (k > h)
+            bvn += m_bs.N(k) - m_bs.N(h);
+    }
+    return bvn;
+}
+
+double
+BjerksundStensland::delta( double strike,      // option strike
+                           double assetPrice,  // underlying asset's current value
+                           double vol,         // volatility
+                           double rate,        // risk free rate of interest
+                           double T,           // time to maturity (year fraction)
+                           double yield,       // annualised yield of underlying asset over life of option (continuous compounded)
+                           bool call ) const
+{
+    double h = 1E-4 * assetPrice;
+    double f0 = value( strike, assetPrice - h, vol, rate, T, yield, call );
+    double f1 = value( strike, assetPrice + h, vol, rate, T, yield, call );
+    return (f1 - f0) / (2.0 * h);
+}
+
+double
+BjerksundStensland::gamma( double strike,      // option strike
+                           double assetPrice,  // underlying asset's current value
+                           double vol,         // volatility
+                           double rate,        // risk free rate of interest
+                           double T,           // time to maturity (year fraction)
+                           double yield,       // annualised yield of underlying asset over life of option (continuous compounded)
+                           bool call ) const
+{
+    double h = 1E-3 * assetPrice;
+    double f0 = value( strike, assetPrice - h, vol, rate, T, yield, call );
+    double f1 = value( strike, assetPrice, vol, rate, T, yield, call );
+    double f2 = value( strike, assetPrice + h, vol, rate, T, yield, call );
+    return (f2 - 2.0 * f1 + f0) / (h * h);
+}
+
+double
+BjerksundStensland::theta( double strike,      // option strike
+                           double assetPrice,  // underlying asset's current value
+                           double vol,         // volatility
+                           double rate,        // risk free rate of interest
+                           double T,           // time to maturity (year fraction)
+                           double yield,       // annualised yield of underlying asset over life of option (continuous compounded)
+                           bool call ) const
+{
+    double deltaT = (T > 0.002) ? 0.001 : T / 2.0;
+    double f0 = value( strike, assetPrice, vol, rate, T + deltaT, yield, call );
+    double f1 = value( strike, assetPrice, vol, rate, T - deltaT, yield, call );
+    return (f1 - f0) / (2.0 * deltaT);
+}
+
+double
+BjerksundStensland::rho( double strike,      // option strike
+                         double assetPrice,  // underlying asset's current value
+                         double vol,         // volatility
+                         double rate,        // risk free rate of interest
+                         double T,           // time to maturity (year fraction)
+                         double yield,       // annualised yield of underlying asset over life of option (continuous compounded)
+                         bool call ) const
+{
+    double deltaR = 0.0001;
+    double f0 = value( strike, assetPrice, vol, rate - deltaR, T, yield, call );
+    double f1 = value( strike, assetPrice, vol, rate + deltaR, T, yield, call );
+    return (f1 - f0) / (2.0 * deltaR);
+}
+
+double
+BjerksundStensland::vega( double strike,      // option strike
+                          double assetPrice,  // underlying asset's current value
+                          double vol,         // volatility
+                          double rate,        // risk free rate of interest
+                          double T,           // time to maturity (year fraction)
+                          double yield,       // annualised yield of underlying asset over life of option (continuous compounded)
+                          bool call ) const
+{
+    double deltaV = 0.0001;
+    double f0 = value( strike, assetPrice, vol - deltaV, rate, T, yield, call );
+    double f1 = value( strike, assetPrice, vol + deltaV, rate, T, yield, call );
+    return (f1 - f0) / (2.0 * deltaV);
+}
+
+//
@@ -21,6 +21,10 @@
 #include "NearZero.h"
 #endif
 
+#ifndef __PRICESTATS_H__
+#include "PriceStats.h"
+#endif
+
 double 
 Black::value( double strike,       // option strike
                     double forwardPrice, // underlying asset's forward value
@@ -29,14 +33,19 @@ Black::value( double strike,       // option strike
                     double T,            // time to maturity (year fraction)
                     bool call ) const  
 {
+    PRICE_STATS_TIMER( StatsModel::Black );
 
 	double term =  vol * sqrt(T);
 	double d1 = ( log(forwardPrice / strike) + (((vol * vol) / 2.0)) * T ) / term;	
 	double d2 = d1 - term;
 
+    double v;
     if (call)
-		return exp(-rate * T) * ((forwardPrice * N(d1)) - (strike * N(d2)));
-	else return exp(-rate * T) * ((strike * N(-d2)) - (forwardPrice * N(-d1)));
+		v = exp(-rate * T) * ((forwardPrice * N(d1)) - (strike * N(d2)));
+	else v = exp(-rate * T) * ((strike * N(-d2)) - (forwardPrice * N(-d1)));
+
+    PRICE_STATS_VALUE( StatsModel::Black, v );
+    return v;
 }
 
 double 
@@ -67,6 +76,8 @@ Black::impliedVol( double strike,       // option strike
         vol = vol - (p1 / p2);
     }
     
+    PRICE_STATS_IMPLIEDVOL( StatsModel::Black, 100 - iterations, iterations > 0 );
+
     return vol;   
 }
 
@@ -158,7 +169,7 @@ Black::N( double x ) const
     
 	L = fabs(x);
 	K = 1.0 / (1.0 + 0.2316419 * L);
-	w = 1.0 - 1.0 / sqrt(2 * Pi) * exp(-L * L / 2) * (a1 * K + a2 * K * K + a3 * pow(K,3) + a4 * pow(K,4) + a5 * pow(K,5));
+	w = 1.0 - 1.0 / sqrt(2 * Pi) * exp(-L * L / 2) * (K * (a1 + K * (a2 + K * (a3 + K * (a4 + K * a5))))); // Horner form of a1 K + ... + a5 K^5
 	
 	if ( x < 0 )
 	{
@@ -21,6 +21,10 @@
 #include "NearZero.h"
 #endif
 
+#ifndef __PRICESTATS_H__
+#include "PriceStats.h"
+#endif
+
 double 
 BlackScholes::value( double strike,      // option strike
                            double assetPrice,  // asset's current value
@@ -30,15 +34,21 @@ BlackScholes::value( double strike,      // option strike
                            double yield,       // annualised yield of underlying asset over life of option (continuous compounded)
                            bool call )  const
 {
+    PRICE_STATS_TIMER( StatsModel::BlackScholes );
+
     double modPrice = assetPrice * exp(-yield * T);
 	
 	double term =  vol * sqrt(T);
 	double d1 = ( log(assetPrice / strike) + (rate - yield + ((vol * vol) / 2.0)) * T ) / term;	
 	double d2 = d1 - term;
     
+    double v;
 	if (call)
-		return modPrice * N(d1) - strike * exp(-rate * T) * N(d2);
-	else return strike * exp(-rate * T) * N(-d2) - modPrice * N(-d1);
+		v = modPrice * N(d1) - strike * exp(-rate * T) * N(d2);
+	else v = strike * exp(-rate * T) * N(-d2) - modPrice * N(-d1);
+
+    PRICE_STATS_VALUE( StatsModel::BlackScholes, v );
+    return v;
 }
 
 double 
@@ -78,6 +88,8 @@ BlackScholes::impliedVol( double strike,      // option strike
         vol = vol - (p1 / p2);
     }
     
+    PRICE_STATS_IMPLIEDVOL( StatsModel::BlackScholes, 100 - iterations, iterations > 0 );
+
     return vol;   
 }
 
@@ -173,7 +185,7 @@ BlackScholes::N( double x ) const
     
 	L = fabs(x);
 	K = 1.0 / (1.0 + 0.2316419 * L);
-	w = 1.0 - 1.0 / sqrt(2 * Pi) * exp(-L * L / 2) * (a1 * K + a2 * K *K + a3 * pow(K,3) + a4 * pow(K,4) + a5 * pow(K,5));
+	w = 1.0 - 1.0 / sqrt(2 * Pi) * exp(-L * L / 2) * (K * (a1 + K * (a2 + K * (a3 + K * (a4 + K * a5))))); // Horner form of a1 K + ... + a5 K^5
 	
 	if ( x < 0 )
 	{
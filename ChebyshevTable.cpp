@@ -0,0 +1,534 @@
+/* Chebyshev American Option Table 18/10/2026
+
+ $$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$
+ $   ChebyshevTable.cpp - code   $
+ $$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$
+
+ by W.B. Yates
+ Copyright (c) W.B. Yates. All rights reserved.
+ History:
+
+ */
+
+#include <math.h>
+#include <string.h>
+#include <stdio.h>
+#include <bit>
+#include <algorithm>
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#ifndef __CHEBYSHEVTABLE_H__
+#include "ChebyshevTable.h"
+#endif
+
+#ifndef __BINOMIALTREE_H__
+#include "BinomialTree.h"
+#endif
+
+#ifndef __TASKPOOL_H__
+#include "TaskPool.h"
+#endif
+
+
+static_assert( sizeof(ChebyshevHeader) == 256, "ChebyshevHeader must be 256 bytes" );
+static_assert( std::endian::native == std::endian::little, "ChebyshevTable files are little-endian and used in place" );
+
+namespace {
+
+const char MAGIC[8] = { 'O', 'P', 'D', 'C', 'H', 'E', 'B', 0 };
+const uint32_t VERSION = 1;
+const int MAXDEGREE = 15;
+const int CORNERS = 16;       // of a four dimensional cell
+const int PROBES = 32;        // further checks per cell
+const double SAFETY = 2.0;    // on the largest error seen, as the probes can miss the worst point
+
+uint64_t
+fnv1a( const unsigned char* p, uint64_t n )
+{
+    uint64_t h = 14695981039346656037ULL;
+    for (uint64_t i = 0; i < n; ++i)
+    {
+        h ^= p[i];
+        h *= 1099511628211ULL;
+    }
+    return h;
+}
+
+// Chebyshev polynomials T_k(t) and their first two derivatives, k = 0..n-1
+void
+basis( double t, int n, double* T, double* dT, double* d2T )
+{
+    T[0] = 1.0; dT[0] = 0.0; if (d2T) d2T[0] = 0.0;
+    if (n == 1)
+        return;
+    T[1] = t; dT[1] = 1.0; if (d2T) d2T[1] = 0.0;
+    for (int k = 2; k < n; ++k)
+    {
+        T[k]  = 2.0 * t * T[k - 1] - T[k - 2];
+        dT[k] = 2.0 * T[k - 1] + 2.0 * t * dT[k - 1] - dT[k - 2];
+        if (d2T)
+            d2T[k] = 4.0 * dT[k - 1] + 2.0 * t * d2T[k - 1] - d2T[k - 2];
+    }
+}
+
+// the j-th Chebyshev-Gauss point of n on [-1, 1]
+inline double
+node( int j, int n )
+{
+    return cos( M_PI * (j + 0.5) / n );
+}
+
+}
+
+
+ChebyshevTable::ChebyshevTable( void ): m_header(), m_stride(), m_storage(), m_coeffs(nullptr), m_estimates(nullptr), m_map(nullptr), m_mapSize(0)
+{
+    memset( &m_header, 0, sizeof(m_header) );
+}
+
+ChebyshevTable::~ChebyshevTable()
+{
+    clear();
+}
+
+void
+ChebyshevTable::clear( void )
+{
+    if (m_map)
+        munmap( m_map, m_mapSize );
+    m_map = nullptr;
+    m_mapSize = 0;
+    m_storage.clear();
+    m_coeffs = nullptr;
+    m_estimates = nullptr;
+    memset( &m_header, 0, sizeof(m_header) );
+}
+
+void
+ChebyshevTable::header( const ChebyshevGrid& grid, bool call, int treeSteps )
+{
+    memset( &m_header, 0, sizeof(m_header) );
+    memcpy( m_header.magic, MAGIC, sizeof(MAGIC) );
+    m_header.version = VERSION;
+    m_header.headerSize = sizeof(ChebyshevHeader);
+    m_header.call = (call) ? 1 : 0;
+    m_header.treeSteps = treeSteps;
+
+    uint64_t cells = 1;
+    for (int d = 0; d < 4; ++d)
+    {
+        m_header.cells[d] = std::max( 1, grid.cells[d] );
+        m_header.degree[d] = std::max( 1, std::min( MAXDEGREE, grid.degree[d] ) );
+        m_header.lo[d] = grid.lo[d];
+        m_header.hi[d] = grid.hi[d];
+        cells *= m_header.cells[d];
+    }
+
+    m_stride[3] = 1;
+    for (int d = 2; d >= 0; --d)
+    {
+        m_stride[d] = m_stride[d + 1] * (int) (m_header.degree[d + 1] + 1);
+    }
+
+    m_header.coeffOffset = sizeof(ChebyshevHeader);
+    m_header.coeffCount = cells * cellSize();
+    m_header.estimateOffset = m_header.coeffOffset + m_header.coeffCount * sizeof(double);
+}
+
+void
+ChebyshevTable::build( const ChebyshevGrid& grid, bool call, int treeSteps, int threads )
+{
+    clear();
+    header( grid, call, treeSteps );
+
+    int n[4];
+    int cells[4];
+    double width[4];
+    for (int d = 0; d < 4; ++d)
+    {
+        n[d] = m_header.degree[d] + 1;
+        cells[d] = m_header.cells[d];
+        width[d] = (m_header.hi[d] - m_header.lo[d]) / cells[d];
+    }
+    int nCells = cells[0] * cells[1] * cells[2] * cells[3];
+    int size = cellSize();
+
+    m_storage.assign( m_header.coeffCount + nCells, 0.0 );
+    double* coeffs = m_storage.data();
+    double* estimates = coeffs + m_header.coeffCount;
+
+    TaskPool pool( threads );
+    std::vector<BinomialTree> trees( pool.threads() );
+    for (BinomialTree& bt : trees)
+    {
+        bt.timeSteps( treeSteps );
+    }
+
+    pool.run( nCells, [&]( int cell, int worker )
+    {
+        BinomialTree& bt = trees[worker];
+        double* c = coeffs + (long) cell * size;
+
+        int idx[4];
+        int rem = cell;
+        for (int d = 3; d >= 0; --d)
+        {
+            idx[d] = rem % cells[d];
+            rem /= cells[d];
+        }
+        double lo[4];
+        for (int d = 0; d < 4; ++d)
+        {
+            lo[d] = m_header.lo[d] + idx[d] * width[d];
+        }
+
+        // strike 1, T 1: vol = x1, rate = x2, yield = x3
+        auto sample = [&]( const double* t )
+        {
+            double x[4];
+            for (int d = 0; d < 4; ++d)
+            {
+                x[d] = lo[d] + 0.5 * width[d] * (t[d] + 1.0);
+            }
+            return bt.value( 1.0, exp(x[0]), x[1], x[2], 1.0, x[3], call );
+        };
+
+        // sample at the tensor Chebyshev points
+        for (int j = 0; j < size; ++j)
+        {
+            double t[4];
+            for (int d = 0; d < 4; ++d)
+            {
+                t[d] = node( (j / m_stride[d]) % n[d], n[d] );
+            }
+            c[j] = sample( t );
+        }
+
+        // discrete cosine transform along each dimension in turn
+        std::vector<double> line(MAXDEGREE + 1);
+        for (int d = 0; d < 4; ++d)
+        {
+            int nd = n[d];
+            int stride = m_stride[d];
+            for (int j = 0; j < size; ++j)
+            {
+                if ((j / stride) % nd != 0)
+                    continue; // only start from the first point of each line
+                for (int k = 0; k < nd; ++k)
+                {
+                    double s = 0.0;
+                    for (int i = 0; i < nd; ++i)
+                    {
+                        s += c[j + i * stride] * cos( M_PI * k * (i + 0.5) / nd );
+                    }
+                    line[k] = s * ((k == 0) ? 1.0 : 2.0) / nd;
+                }
+                for (int k = 0; k < nd; ++k)
+                {
+                    c[j + k * stride] = line[k];
+                }
+            }
+        }
+
+        // truncation estimate: the highest order coefficients in any dimension
+        double tail = 0.0;
+        for (int j = 0; j < size; ++j)
+        {
+            bool top = false;
+            for (int d = 0; d < 4; ++d)
+            {
+                top = top || ((j / m_stride[d]) % n[d] == n[d] - 1);
+            }
+            if (top)
+                tail += fabs(c[j]);
+        }
+
+        // check against the tree away from the sample points: the cell's corners, where interpolation
+        // error is usually largest, then points spread through it
+        double err = 0.0;
+        for (int s = 0; s < CORNERS + PROBES; ++s)
+        {
+            double t[4];
+            double x[4];
+            for (int d = 0; d < 4; ++d)
+            {
+                // R4 low discrepancy sequence over the cell
+                static const double alpha[4] = { 0.8191725134, 0.6710436067, 0.5497004779, 0.4502995221 };
+                double u = (s < CORNERS) ? double((s >> d) & 1) : fmod( 0.5 + (s - CORNERS + 1) * alpha[d], 1.0 );
+                t[d] = 2.0 * u - 1.0;
+                x[d] = lo[d] + 0.5 * width[d] * (t[d] + 1.0);
+            }
+            double series = 0.0;
+            {
+                double T0[MAXDEGREE + 1], T1[MAXDEGREE + 1], T2[MAXDEGREE + 1], T3[MAXDEGREE + 1];
+                double D[MAXDEGREE + 1];
+                basis( t[0], n[0], T0, D, nullptr );
+                basis( t[1], n[1], T1, D, nullptr );
+                basis( t[2], n[2], T2, D, nullptr );
+                basis( t[3], n[3], T3, D, nullptr );
+                for (int j = 0; j < size; ++j)
+                {
+                    series += c[j] * T0[(j / m_stride[0]) % n[0]] * T1[(j / m_stride[1]) % n[1]]
+                                   * T2[(j / m_stride[2]) % n[2]] * T3[j % n[3]];
+                }
+            }
+            double tree = bt.value( 1.0, exp(x[0]), x[1], x[2], 1.0, x[3], call );
+            err = std::max( err, fabs(series - tree) );
+        }
+        estimates[cell] = SAFETY * (err + tail);
+    });
+
+    m_coeffs = coeffs;
+    m_estimates = estimates;
+    double worst = 0.0;
+    for (int c = 0; c < nCells; ++c)
+    {
+        worst = std::max( worst, estimates[c] );
+    }
+    m_header.errorEstimate = worst;
+    m_header.checksum = fnv1a( (const unsigned char*) m_storage.data(), m_storage.size() * sizeof(double) );
+}
+
+bool
+ChebyshevTable::save( const char* path ) const
+{
+    if (empty())
+        return false;
+
+    FILE* fp = fopen( path, "wb" );
+    if (!fp)
+        return false;
+
+    uint64_t nCells = (uint64_t) m_header.cells[0] * m_header.cells[1] * m_header.cells[2] * m_header.cells[3];
+
+    bool ok = fwrite( &m_header, sizeof(m_header), 1, fp ) == 1
+           && fwrite( m_coeffs, sizeof(double), m_header.coeffCount, fp ) == m_header.coeffCount
+           && fwrite( m_estimates, sizeof(double), nCells, fp ) == nCells;
+    return (fclose( fp ) == 0) && ok;
+}
+
+bool
+ChebyshevTable::validate( const unsigned char* base, uint64_t size )
+{
+    if (size < sizeof(ChebyshevHeader))
+        return false;
+
+    ChebyshevHeader h;
+    memcpy( &h, base, sizeof(h) );
+    if (memcmp( h.magic, MAGIC, sizeof(MAGIC) ) != 0 || h.version != VERSION || h.headerSize != sizeof(ChebyshevHeader))
+        return false;
+
+    uint64_t cells = 1;
+    for (int d = 0; d < 4; ++d)
+    {
+        if (h.cells[d] == 0 || h.degree[d] == 0 || h.degree[d] > (uint32_t) MAXDEGREE || !(h.hi[d] > h.lo[d]))
+            return false;
+        cells *= h.cells[d];
+    }
+
+    uint64_t cellSize = (uint64_t) (h.degree[0] + 1) * (h.degree[1] + 1) * (h.degree[2] + 1) * (h.degree[3] + 1);
+    if (h.coeffOffset != sizeof(ChebyshevHeader) || h.coeffCount != cells * cellSize
+        || h.estimateOffset != h.coeffOffset + h.coeffCount * sizeof(double)
+        || size < h.estimateOffset + cells * sizeof(double))
+        return false;
+
+    uint64_t payload = h.estimateOffset + cells * sizeof(double) - h.coeffOffset;
+    if (fnv1a( base + h.coeffOffset, payload ) != h.checksum)
+        return false;
+
+    ChebyshevGrid grid;
+    for (int d = 0; d < 4; ++d)
+    {
+        grid.lo[d] = h.lo[d];
+        grid.hi[d] = h.hi[d];
+        grid.cells[d] = h.cells[d];
+        grid.degree[d] = h.degree[d];
+    }
+    header( grid, h.call != 0, h.treeSteps );
+    m_header.errorEstimate = h.errorEstimate;
+    m_header.checksum = h.checksum;
+
+    m_coeffs = (const double*) (base + h.coeffOffset);
+    m_estimates = (const double*) (base + h.estimateOffset);
+    return true;
+}
+
+bool
+ChebyshevTable::load( const char* path )
+{
+    clear();
+
+    int fd = open( path, O_RDONLY );
+    if (fd < 0)
+        return false;
+
+    struct stat st;
+    if (fstat( fd, &st ) != 0 || st.st_size <= 0)
+    {
+        close( fd );
+        return false;
+    }
+
+    void* p = mmap( nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0 );
+    close( fd );
+    if (p == MAP_FAILED)
+        return false;
+
+    m_map = p;
+    m_mapSize = st.st_size;
+    if (!validate( (const unsigned char*) p, m_mapSize ))
+    {
+        clear();
+        return false;
+    }
+    return true;
+}
+
+bool
+ChebyshevTable::attach( const void* data, uint64_t size )
+{
+    clear();
+    if (((uintptr_t) data % alignof(double)) != 0 || !validate( (const unsigned char*) data, size ))
+    {
+        clear();
+        return false;
+    }
+    return true;
+}
+
+bool
+ChebyshevTable::value( double strike,      // option strike
+                       double assetPrice,  // underlying asset's current value
+                       double vol,         // volatility
+                       double rate,        // risk free rate of interest
+                       double T,           // time to maturity (year fraction)
+                       double yield,       // annualised yield of underlying asset (continuous compounded)
+                       ChebyshevResult& r,
+                       bool greeks ) const
+{
+    if (empty())
+        return false;
+
+    double sqrtT = sqrt(T);
+    double x[4] = { log(assetPrice / strike), vol * sqrtT, rate * T, yield * T };
+
+    int n[4];
+    int cell = 0;
+    double t[4];
+    double scale[4];
+    for (int d = 0; d < 4; ++d)
+    {
+        if (!(x[d] >= m_header.lo[d] && x[d] <= m_header.hi[d]))
+            return false;
+
+        n[d] = m_header.degree[d] + 1;
+        int cells = m_header.cells[d];
+        double width = (m_header.hi[d] - m_header.lo[d]) / cells;
+        int c = std::min( cells - 1, (int) ((x[d] - m_header.lo[d]) / width) );
+        t[d] = 2.0 * (x[d] - (m_header.lo[d] + c * width)) / width - 1.0;
+        scale[d] = 2.0 / width;
+        cell = cell * cells + c;
+    }
+
+    const double* c = m_coeffs + (long) cell * cellSize();
+
+    if (!greeks)
+    {
+        double T0[MAXDEGREE + 1], T1[MAXDEGREE + 1], T2[MAXDEGREE + 1], T3[MAXDEGREE + 1], D[MAXDEGREE + 1];
+        basis( t[0], n[0], T0, D, nullptr );
+        basis( t[1], n[1], T1, D, nullptr );
+        basis( t[2], n[2], T2, D, nullptr );
+        basis( t[3], n[3], T3, D, nullptr );
+
+        double f = 0.0;
+        for (int k0 = 0; k0 < n[0]; ++k0)
+        {
+            double C = 0.0;
+            for (int k1 = 0; k1 < n[1]; ++k1)
+            {
+                double B = 0.0;
+                for (int k2 = 0; k2 < n[2]; ++k2)
+                {
+                    const double* row = c + k0 * m_stride[0] + k1 * m_stride[1] + k2 * m_stride[2];
+                    double A = 0.0;
+                    for (int k3 = 0; k3 < n[3]; ++k3)
+                    {
+                        A += row[k3] * T3[k3];
+                    }
+                    B += A * T2[k2];
+                }
+                C += B * T1[k1];
+            }
+            f += C * T0[k0];
+        }
+        r.value = strike * f;
+        r.errorEstimate = strike * m_estimates[cell];
+        return true;
+    }
+
+    double T0[MAXDEGREE + 1], D0[MAXDEGREE + 1], DD0[MAXDEGREE + 1];
+    double T1[MAXDEGREE + 1], D1[MAXDEGREE + 1];
+    double T2[MAXDEGREE + 1], D2[MAXDEGREE + 1];
+    double T3[MAXDEGREE + 1], D3[MAXDEGREE + 1];
+    basis( t[0], n[0], T0, D0, DD0 );
+    basis( t[1], n[1], T1, D1, nullptr );
+    basis( t[2], n[2], T2, D2, nullptr );
+    basis( t[3], n[3], T3, D3, nullptr );
+
+    // contract the innermost dimension first, carrying the derivative terms we need
+    double f = 0.0, f0 = 0.0, f00 = 0.0, f1 = 0.0, f2 = 0.0, f3 = 0.0;
+    for (int k0 = 0; k0 < n[0]; ++k0)
+    {
+        double C = 0.0, C1 = 0.0, C2 = 0.0, C3 = 0.0;
+        for (int k1 = 0; k1 < n[1]; ++k1)
+        {
+            double B = 0.0, B2 = 0.0, B3 = 0.0;
+            for (int k2 = 0; k2 < n[2]; ++k2)
+            {
+                const double* row = c + k0 * m_stride[0] + k1 * m_stride[1] + k2 * m_stride[2];
+                double A = 0.0, A3 = 0.0;
+                for (int k3 = 0; k3 < n[3]; ++k3)
+                {
+                    A  += row[k3] * T3[k3];
+                    A3 += row[k3] * D3[k3];
+                }
+                B  += A * T2[k2];
+                B2 += A * D2[k2];
+                B3 += A3 * T2[k2];
+            }
+            C  += B * T1[k1];
+            C1 += B * D1[k1];
+            C2 += B2 * T1[k1];
+            C3 += B3 * T1[k1];
+        }
+        f   += C * T0[k0];
+        f0  += C * D0[k0];
+        f00 += C * DD0[k0];
+        f1  += C1 * T0[k0];
+        f2  += C2 * T0[k0];
+        f3  += C3 * T0[k0];
+    }
+
+    // derivatives in x rather than t
+    f0  *= scale[0];
+    f00 *= scale[0] * scale[0];
+    f1  *= scale[1];
+    f2  *= scale[2];
+    f3  *= scale[3];
+
+    // V = strike * f(log(S/K), vol sqrt(T), rate T, yield T)
+    r.value = strike * f;
+    r.delta = strike * f0 / assetPrice;
+    r.gamma = strike * (f00 - f0) / (assetPrice * assetPrice);
+    r.vega  = strike * f1 * sqrtT;
+    r.rho   = strike * f2 * T;
+    r.theta = -strike * (f1 * vol / (2.0 * sqrtT) + f2 * rate + f3 * yield);
+    r.errorEstimate = strike * m_estimates[cell];
+    return true;
+}
+
+//
@@ -0,0 +1,167 @@
+/* Chebyshev American Option Table 18/10/2026
+
+ $$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$
+ $   ChebyshevTable.h - header   $
+ $$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$
+
+ Copyright (C) 2026  W.B. Yates
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see http://www.gnu.org/licenses/
+
+ History:
+
+ Precomputed BinomialTree prices for American options as piecewise tensor Chebyshev interpolants.
+
+ With a fixed number of steps the Cox-Ross-Rubinstein price divided by strike depends only on
+
+    x0 = log(assetPrice / strike), x1 = vol * sqrt(T), x2 = rate * T, x3 = yield * T
+
+ so one four dimensional table covers every strike and maturity. The domain is cut into cells and
+ each cell holds a tensor Chebyshev series of modest degree, which keeps an evaluation to a few hundred
+ multiply-adds. Delta, gamma, vega, theta and rho come from differentiating the series.
+
+ build() samples the tree (in parallel) at the Chebyshev points of every cell, then checks every cell
+ against the tree at its corners and 32 other off-node points. A cell's error estimate is twice the
+ largest of these checks plus the size of the highest order coefficients. It has a safety margin but is
+ not a guarantee, as a probe can miss the worst point; errorEstimate() is the largest. It is measured from
+ the tree with treeSteps(), not from the continuous American price.
+
+ save() writes a versioned little-endian file which load() maps read-only and uses in place.
+
+    offset  0   ChebyshevHeader (256 bytes)
+    offset 256  double coefficients[cells][degree0+1][degree1+1][degree2+1][degree3+1]
+                double cellEstimate[cells]
+
+ Examples
+
+    ChebyshevTable table;
+    if (table.load( "american_put.cheb" ))
+    {
+        ChebyshevResult r;
+        if (table.value( 110, 100, 0.3, 0.08, 1.0, 0.0, r ))
+            std::cout << "value is " << r.value << " +/- " << r.errorEstimate << std::endl;
+    }
+ */
+
+
+#ifndef __CHEBYSHEVTABLE_H__
+#define __CHEBYSHEVTABLE_H__
+
+#include <stdint.h>
+#include <vector>
+
+
+struct ChebyshevHeader
+{
+    char     magic[8];       // "OPDCHEB"
+    uint32_t version;
+    uint32_t headerSize;
+    uint32_t call;           // 1 call, 0 put
+    uint32_t treeSteps;      // BinomialTree steps used to sample
+    uint32_t cells[4];       // cells per dimension
+    uint32_t degree[4];      // Chebyshev degree per dimension
+    double   lo[4];          // domain of (log moneyness, vol * sqrt(T), rate * T, yield * T)
+    double   hi[4];
+    double   errorEstimate;  // largest cell estimate
+    uint64_t coeffOffset;    // bytes from start of file
+    uint64_t coeffCount;
+    uint64_t estimateOffset;
+    uint64_t checksum;       // FNV-1a of everything after the header
+    char     reserved[256 - 160];
+};
+
+struct ChebyshevResult
+{
+    double value = 0.0;
+    double delta = 0.0;
+    double gamma = 0.0;
+    double vega = 0.0;
+    double theta = 0.0;
+    double rho = 0.0;
+    double errorEstimate = 0.0; // of value, in price units
+};
+
+struct ChebyshevGrid
+{
+    double lo[4] = { -1.0, 0.02, 0.0, 0.0 };
+    double hi[4] = { 1.0, 1.2, 0.25, 0.15 };
+    int cells[4] = { 16, 8, 2, 2 };
+    int degree[4] = { 6, 6, 3, 3 };
+};
+
+
+class ChebyshevTable
+{
+public:
+
+    ChebyshevTable( void );
+    ~ChebyshevTable();
+
+    ChebyshevTable( const ChebyshevTable& ) = delete;
+    ChebyshevTable& operator=( const ChebyshevTable& ) = delete;
+
+    // offline: sample a BinomialTree with treeSteps steps over grid and fit the interpolants
+    void
+    build( const ChebyshevGrid& grid, bool call, int treeSteps, int threads = 0 );
+
+    bool
+    save( const char* path ) const;
+
+    bool // map a file written by save(); the coefficients are used in place
+    load( const char* path );
+
+    bool // use a table already in memory (shared memory for example); data must outlive the table
+    attach( const void* data, uint64_t size );
+
+    void
+    clear( void );
+
+    bool // false if the inputs are outside the table, in which case r is untouched
+    value( double strike,       // option strike
+           double assetPrice,   // underlying asset's current value
+           double vol,          // volatility
+           double rate,         // risk free rate of interest
+           double T,            // time to maturity (year fraction)
+           double yield,        // annualised yield of underlying asset (continuous compounded)
+           ChebyshevResult& r,
+           bool greeks = true ) const; // false fills in only value and errorEstimate
+
+    bool call( void ) const { return m_header.call != 0; }
+    int treeSteps( void ) const { return (int) m_header.treeSteps; }
+    double errorEstimate( void ) const { return m_header.errorEstimate; }
+    bool empty( void ) const { return m_coeffs == nullptr; }
+
+private:
+
+    int cellSize( void ) const { return m_stride[0] * (int) (m_header.degree[0] + 1); }
+
+    bool
+    validate( const unsigned char* base, uint64_t size );
+
+    void
+    header( const ChebyshevGrid& grid, bool call, int treeSteps );
+
+    ChebyshevHeader m_header;
+    int m_stride[4];                 // within a cell
+    std::vector<double> m_storage;   // owned coefficients and estimates after build()
+    const double* m_coeffs;
+    const double* m_estimates;
+    void* m_map;
+    uint64_t m_mapSize;
+};
+
+
+#endif
+
+///
@@ -0,0 +1,53 @@
+/* Chebyshev Table Tool 18/10/2026
+
+ $$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$
+ $   ChebyshevTool.cpp - code   $
+ $$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$
+
+ by W.B. Yates
+ Copyright (c) W.B. Yates. All rights reserved.
+ History:
+
+ Offline builder for ChebyshevTable files. Built as its own program, e.g.
+
+    c++ -std=c++20 -O2 ChebyshevTool.cpp ChebyshevTable.cpp BinomialTree.cpp BlackScholes.cpp \
+        BaroneAdesiWhaley.cpp TaskPool.cpp PriceStats.cpp -o chebtool -lpthread
+    ./chebtool american_put.cheb put 1000
+
+ usage: chebtool <file> <call|put> [treeSteps] [threads]
+ */
+
+#include <iostream>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef __CHEBYSHEVTABLE_H__
+#include "ChebyshevTable.h"
+#endif
+
+int
+main( int argc, const char* argv[] )
+{
+    if (argc < 3 || (strcmp( argv[2], "call" ) != 0 && strcmp( argv[2], "put" ) != 0))
+    {
+        std::cerr << "usage: " << argv[0] << " <file> <call|put> [treeSteps] [threads]" << std::endl;
+        return 1;
+    }
+
+    bool call = strcmp( argv[2], "call" ) == 0;
+    int steps = (argc > 3) ? atoi( argv[3] ) : 1000;
+    int threads = (argc > 4) ? atoi( argv[4] ) : 0;
+
+    ChebyshevGrid grid;
+    ChebyshevTable table;
+    table.build( grid, call, steps, threads );
+    if (!table.save( argv[1] ))
+    {
+        std::cerr << "failed to write " << argv[1] << std::endl;
+        return 1;
+    }
+
+    std::cout << "wrote " << argv[1] << " (" << (call ? "call" : "put") << ", " << steps
+              << " steps), error estimate " << table.errorEstimate() << " per unit strike" << std::endl;
+    return 0;
+}
@@ -0,0 +1,255 @@
+/* Deadline Aware Pricing 18/10/2026
+
+ $$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$
+ $   DeadlineScheduler.cpp - code   $
+ $$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$
+
+ by W.B. Yates
+ Copyright (c) W.B. Yates. All rights reserved.
+ History:
+
+ */
+
+#include <math.h>
+#include <limits>
+#include <iterator>
+#include <numeric>
+#include <algorithm>
+
+#ifndef __DEADLINESCHEDULER_H__
+#include "DeadlineScheduler.h"
+#endif
+
+#ifndef __PRICINGSCHEDULER_H__
+#include "PricingScheduler.h"
+#endif
+
+
+namespace {
+
+const double APPROXIMATION_COST = 12.0;  // a Barone-Adesi Whaley value, in BlackScholes values
+const double MIN_SAMPLE = 16.0;          // trees cheaper than this are too quick to time
+
+// the steps of the rung after one of last steps on the ladder down from n, 0 when there is none; each
+// rung has about 1/sqrt(2) the steps, and half the nodes, of the one before
+int
+nextRung( int n, int last, int minSteps )
+{
+    for (double r = n; r >= 1.0; r *= M_SQRT1_2)
+    {
+        int k = (int) lround( r );
+        if (k < last)
+            return (k >= minSteps) ? k : 0;
+    }
+    return 0;
+}
+
+inline double
+elapsed( std::chrono::steady_clock::time_point start )
+{
+    return std::chrono::duration<double, std::nano>( std::chrono::steady_clock::now() - start ).count();
+}
+
+}
+
+
+DeadlineScheduler::DeadlineScheduler( int threads, bool pin ): m_pool(threads, pin),
+                                                               m_workers(),
+                                                               m_order(),
+                                                               m_deadline(),
+                                                               m_floor(),
+                                                               m_slack(),
+                                                               m_next(0),
+                                                               m_inflight(0.0),
+                                                               m_nsPerUnit(100.0),
+                                                               m_count(),
+                                                               m_late(0),
+                                                               m_treeSteps(BinomialTree().timeSteps()),
+                                                               m_minSteps(32),
+                                                               m_headroom(1.25)
+{
+    m_workers.resize( m_pool.threads() );
+    calibrate();
+}
+
+void
+DeadlineScheduler::calibrate( void )
+{
+    OptionSpec o;
+    o.model = OptionModel::BinomialTree;
+    o.call = false;
+    o.strike = 100.0;
+    o.assetPrice = 100.0;
+    o.vol = 0.3;
+    o.rate = 0.05;
+    o.T = 1.0;
+    o.yield = 0.02;
+    o.timeSteps = 100;
+
+    OptionPricer pricer;
+    pricer.value( o ); // size the tree
+
+    const int n = 4;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < n; ++i)
+    {
+        o.assetPrice = 98.0 + i;
+        pricer.value( o );
+    }
+    m_nsPerUnit = elapsed( start ) / (n * PricingScheduler::cost( o, 0 ));
+}
+
+double
+DeadlineScheduler::choose( const OptionSpec& o, double budget, int& steps, AccuracyTier& tier ) const
+{
+    double unit = m_nsPerUnit.load() * m_headroom;
+
+    steps = 0;
+    tier = AccuracyTier::Exact;
+    if (o.model != OptionModel::BinomialTree)
+        return 1.0;
+
+    int n = (o.timeSteps > 0) ? o.timeSteps : m_treeSteps;
+    double cost = 0.0;
+    OptionSpec s = o;
+    for (int k = n; k > 0; k = nextRung( n, k, m_minSteps ))
+    {
+        steps = k;
+        s.timeSteps = k;
+        cost = PricingScheduler::cost( s, 0 );
+        if (cost * unit <= budget)
+            break;
+    }
+
+    tier = (steps == n) ? AccuracyTier::Exact : AccuracyTier::Reduced;
+    if (cost * unit <= budget || cost <= APPROXIMATION_COST)
+        return cost;
+
+    steps = 0;
+    tier = AccuracyTier::Approximation;
+    return APPROXIMATION_COST;
+}
+
+void
+DeadlineScheduler::prepare( int n )
+{
+    OptionSpec o;
+    o.model = OptionModel::BinomialTree;
+    o.strike = 100.0;
+    o.assetPrice = 100.0;
+    o.vol = 0.3;
+    o.rate = 0.05;
+    o.T = 1.0;
+
+    for (int k = n; k > 0; k = nextRung( n, k, m_minSteps ))
+    {
+        if (std::find( m_steps.begin(), m_steps.end(), k ) != m_steps.end())
+            continue;
+
+        // one value sizes and touches all of the tree's workspace
+        m_steps.push_back( k );
+        o.timeSteps = k;
+        for (Worker& w : m_workers)
+            w.trees.emplace_back().value( o );
+    }
+}
+
+void
+DeadlineScheduler::drain( int w, std::span<const OptionSpec> options, std::span<DeadlineResult> results, std::chrono::steady_clock::time_point start )
+{
+    Worker& worker = m_workers[w];
+    double workers = threads();
+    int n = (int) m_order.size();
+
+    for (int k = m_next++; k < n; k = m_next++)
+    {
+        int i = m_order[k];
+        const OptionSpec& o = options[i];
+        DeadlineResult& r = results[i];
+
+        // the time to this deadline, and what the workers can spare before each later one
+        double now = elapsed( start );
+        double budget = std::min( m_deadline[i] - now, m_slack[k] - now * workers + m_floor[k + 1] - m_inflight.load() );
+
+        double cost = choose( o, budget, r.steps, r.tier );
+        double estimate = cost * m_nsPerUnit.load() * m_headroom;
+        m_inflight += estimate;
+        bool sized = false;
+
+        if (r.tier == AccuracyTier::Approximation)
+            r.value = worker.baw.value( o.strike, o.assetPrice, o.vol, o.rate, o.T, o.yield, o.call );
+        else if (o.model == OptionModel::BinomialTree)
+        {
+            // price() prepared a tree of these steps, so none is sized here
+            OptionPricer& tree = worker.trees[std::distance( m_steps.begin(), std::find( m_steps.begin(), m_steps.end(), r.steps ) )];
+            sized = tree.binomialTree().timeSteps() == r.steps;
+            OptionSpec s = o;
+            s.timeSteps = r.steps;
+            r.value = tree.value( s );
+        }
+        else r.value = worker.closedForm.value( o );
+
+        double done = elapsed( start );
+        m_inflight -= estimate;
+
+        // moving average of the cost of a unit, from the trees that were not sized on the way
+        if (r.steps > 0 && sized && cost >= MIN_SAMPLE)
+            m_nsPerUnit = 0.9 * m_nsPerUnit.load() + 0.1 * (done - now) / cost;
+
+        r.finish = done * 1E-3;
+        r.late = done > m_deadline[i];
+        ++m_count[(int) r.tier];
+        if (r.late)
+            ++m_late;
+    }
+}
+
+void
+DeadlineScheduler::price( std::span<const OptionSpec> options, std::span<const double> deadlines, std::span<DeadlineResult> results )
+{
+    if (options.empty() || deadlines.size() < options.size() || results.size() < options.size())
+        return;
+
+    int n = (int) options.size();
+
+    // a tree for every rung the batch can use, sized before the clock starts
+    int ladder = 0;
+    for (int i = 0; i < n; ++i)
+    {
+        const OptionSpec& o = options[i];
+        int steps = (o.timeSteps > 0) ? o.timeSteps : m_treeSteps;
+        if (o.model == OptionModel::BinomialTree && steps != ladder)
+            prepare( ladder = steps );
+    }
+
+    auto start = std::chrono::steady_clock::now();
+
+    // earliest deadline first
+    m_deadline.resize( n );
+    for (int i = 0; i < n; ++i)
+        m_deadline[i] = (isnan( deadlines[i] )) ? std::numeric_limits<double>::infinity() : deadlines[i] * 1E3;
+
+    m_order.resize( n );
+    std::iota( m_order.begin(), m_order.end(), 0 );
+    std::stable_sort( m_order.begin(), m_order.end(), [this]( int a, int b ) { return m_deadline[a] < m_deadline[b]; } );
+
+    // what the queue needs at its cheapest, and the least slack from each entry on
+    double unit = m_nsPerUnit.load() * m_headroom;
+    double workers = threads();
+    int steps;
+    AccuracyTier tier;
+
+    m_floor.assign( n + 1, 0.0 );
+    for (int k = 0; k < n; ++k)
+        m_floor[k + 1] = m_floor[k] + choose( options[m_order[k]], -1.0, steps, tier ) * unit;
+
+    m_slack.assign( n + 1, std::numeric_limits<double>::infinity() );
+    for (int k = n - 1; k >= 0; --k)
+        m_slack[k] = std::min( m_slack[k + 1], m_deadline[m_order[k]] * workers - m_floor[k + 1] );
+
+    m_next = 0;
+    m_inflight = 0.0;
+    m_pool.run( threads(), [&]( int, int w ) { drain( w, options, results, start ); } );
+}
+
+//
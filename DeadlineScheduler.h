@@ -0,0 +1,180 @@
+/* Deadline Aware Pricing 18/10/2026
+
+ $$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$
+ $   DeadlineScheduler.h - header   $
+ $$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$
+
+ Copyright (C) 2026  W.B. Yates
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see http://www.gnu.org/licenses/
+
+ History:
+
+ Prices a batch of OptionSpecs, each with a deadline, giving up accuracy rather than time when the
+ batch cannot all be priced exactly before its deadlines.
+
+ Options are queued earliest deadline first and taken from the queue by the workers of a TaskPool. A
+ closed form option is always priced exactly. A BinomialTree option is priced with the most accurate
+ rung of a ladder whose estimated time fits the time it has: its own timeSteps (or treeSteps()), then
+ trees of about 1/sqrt(2) as many steps, each costing half as much as the one before, down to
+ minSteps(), and finally the Barone-Adesi Whaley approximation. An option none of these fits is
+ priced with the cheapest of them, as soon as possible.
+
+ The time an option has is the least of the time to its own deadline and, for every later deadline in
+ the queue, the time the workers have until then less what the options between need at their cheapest
+ rung and what the other workers are still estimated to be doing. So an early option takes only the
+ slack that the options behind it can spare.
+
+ Times are estimated from PricingScheduler::cost (units of one BlackScholes value; the approximation
+ counts as 12), times nsPerUnit() and headroom(). nsPerUnit() is measured at construction by
+ calibrate() and then follows a moving average of the trees priced.
+
+ A cold tree takes several times its estimate, so each worker keeps a tree for every rung step count it
+ has been asked for, and price() builds any a batch needs and does not have before it starts the clock
+ on the deadlines. Only the first batch with a new timeSteps pays for this.
+
+ Each DeadlineResult reports its tier (Exact, Reduced or Approximation), the tree steps it used, when
+ it was ready and whether that was after its deadline. count() and late() total them per tier.
+
+ Examples
+
+    DeadlineScheduler scheduler;                 // one worker per core
+    std::vector<OptionSpec> batch = ...;
+    std::vector<double> deadlines = ...;         // microseconds from the call
+    std::vector<DeadlineResult> results( batch.size() );
+    scheduler.price( batch, deadlines, results );
+    if (results[0].tier == AccuracyTier::Approximation) ...
+ */
+
+
+#ifndef __DEADLINESCHEDULER_H__
+#define __DEADLINESCHEDULER_H__
+
+#include <span>
+#include <deque>
+#include <atomic>
+#include <chrono>
+#include <vector>
+#include <cstdint>
+
+#ifndef __OPTIONPRICER_H__
+#include "OptionPricer.h"
+#endif
+
+#ifndef __BARONEADESIWHALEY_H__
+#include "BaroneAdesiWhaley.h"
+#endif
+
+#ifndef __TASKPOOL_H__
+#include "TaskPool.h"
+#endif
+
+
+enum class AccuracyTier : uint8_t { Exact = 0, Reduced = 1, Approximation = 2 };
+
+struct DeadlineResult
+{
+    double value = 0.0;
+    double finish = 0.0;     // microseconds from the call to price() when the value was ready
+    int steps = 0;           // tree time steps used; 0 for a closed form or the approximation
+    AccuracyTier tier = AccuracyTier::Exact;
+    bool late = false;       // ready after its deadline
+};
+
+
+class DeadlineScheduler
+{
+public:
+
+    explicit DeadlineScheduler( int threads = 0, bool pin = false ); // 0 uses one thread per core
+
+    // deadlines[i] is options[i]'s, in microseconds from the call (NaN for none); both deadlines
+    // and results must hold at least options.size() entries
+    void
+    price( std::span<const OptionSpec> options, std::span<const double> deadlines, std::span<DeadlineResult> results );
+
+    // time a 100 step tree to set nsPerUnit()
+    void
+    calibrate( void );
+
+    int
+    threads( void ) const { return m_pool.threads(); }
+
+    int
+    treeSteps( void ) const { return m_treeSteps; }
+
+    void
+    treeSteps( int n ) { m_treeSteps = (n > 0) ? n : 1; }
+
+    int // fewest steps of a reduced tree
+    minSteps( void ) const { return m_minSteps; }
+
+    void
+    minSteps( int n ) { m_minSteps = (n > 0) ? n : 1; }
+
+    double // estimates are multiplied by this before they are compared with the time left
+    headroom( void ) const { return m_headroom; }
+
+    void
+    headroom( double h ) { m_headroom = (h > 0.0) ? h : 1.0; }
+
+    double // estimated nanoseconds per unit of cost
+    nsPerUnit( void ) const { return m_nsPerUnit.load(); }
+
+    long // results of a tier since construction
+    count( AccuracyTier t ) const { return m_count[(int) t].load(); }
+
+    long // results ready after their deadline since construction
+    late( void ) const { return m_late.load(); }
+
+private:
+
+    struct alignas(64) Worker
+    {
+        std::deque<OptionPricer> trees;    // trees[j] has m_steps[j] steps, so no tree is resized between options
+        OptionPricer closedForm;
+        BaroneAdesiWhaley baw;
+    };
+
+    double // the cost of the most accurate rung for o estimated to fit budget nanoseconds, or the cheapest
+    choose( const OptionSpec& o, double budget, int& steps, AccuracyTier& tier ) const;
+
+    // builds each worker a tree for every rung of the ladder down from n steps it does not have yet
+    void
+    prepare( int n );
+
+    void
+    drain( int w, std::span<const OptionSpec> options, std::span<DeadlineResult> results, std::chrono::steady_clock::time_point start );
+
+    TaskPool m_pool;
+    std::vector<Worker> m_workers;
+    std::vector<int> m_steps;          // the steps of each worker's trees
+    std::vector<int> m_order;          // option indices, earliest deadline first
+    std::vector<double> m_deadline;    // per option, nanoseconds
+    std::vector<double> m_floor;       // m_floor[k]: cheapest estimates of queue entries 0..k-1, nanoseconds
+    std::vector<double> m_slack;       // m_slack[k]: least over j >= k of deadline j * threads - m_floor[j + 1]
+    std::atomic<int> m_next;
+    std::atomic<double> m_inflight;    // estimates of the options being priced
+    std::atomic<double> m_nsPerUnit;
+    std::atomic<long> m_count[3];
+    std::atomic<long> m_late;
+    int m_treeSteps;
+    int m_minSteps;
+    double m_headroom;
+};
+
+
+#endif
+
+///
@@ -0,0 +1,578 @@
+/* Heston Stochastic Volatility Model 18/10/2026
+
+ $$$$$$$$$$$$$$$$$$$$$$$$$
+ $   Heston.cpp - code   $
+ $$$$$$$$$$$$$$$$$$$$$$$$$
+
+ by W.B. Yates
+ Copyright (c) W.B. Yates. All rights reserved.
+ History:
+
+ */
+
+#include <math.h>
+#include <algorithm>
+#include <numeric>
+
+#ifndef __HESTON_H__
+#include "Heston.h"
+#endif
+
+#ifndef __MATRIX_H__
+#include "AMatrix.h"
+#endif
+
+
+namespace {
+
+    typedef std::complex<double> Complex;
+
+    const double PI = 3.14159265358979323846;
+
+    const int CACHE_SIZE = 16;     // expiries kept per Heston
+    const double COS_WIDTH = 12.0; // COS interval half width in standard deviations of the log return
+
+    // in place radix 2 FFT, X_u = sum_j x_j exp(-2 pi i j u / n); n a power of two
+    void
+    fft( std::vector<Complex>& x )
+    {
+        int n = (int) x.size();
+        for (int i = 1, j = 0; i < n; ++i)
+        {
+            int bit = n >> 1;
+            for (; j & bit; bit >>= 1)
+            {
+                j ^= bit;
+            }
+            j ^= bit;
+            if (i < j)
+                std::swap( x[i], x[j] );
+        }
+
+        for (int len = 2; len <= n; len <<= 1)
+        {
+            Complex w = std::polar( 1.0, -2.0 * PI / len );
+            for (int i = 0; i < n; i += len)
+            {
+                Complex wk = 1.0;
+                for (int k = 0; k < len / 2; ++k)
+                {
+                    Complex t = x[i + k + len / 2] * wk;
+                    x[i + k + len / 2] = x[i + k] - t;
+                    x[i + k] += t;
+                    wk *= w;
+                }
+            }
+        }
+    }
+
+    // solve the n x n system a x = b in place by Gaussian elimination with partial pivoting
+    bool
+    solve( int n, std::vector<double>& a, std::vector<double>& b )
+    {
+        for (int c = 0; c < n; ++c)
+        {
+            int p = c;
+            for (int r = c + 1; r < n; ++r)
+            {
+                if (fabs( a[r * n + c] ) > fabs( a[p * n + c] ))
+                    p = r;
+            }
+            if (a[p * n + c] == 0.0)
+                return false;
+            for (int k = 0; k < n; ++k)
+            {
+                std::swap( a[c * n + k], a[p * n + k] );
+            }
+            std::swap( b[c], b[p] );
+
+            for (int r = c + 1; r < n; ++r)
+            {
+                double f = a[r * n + c] / a[c * n + c];
+                for (int k = c; k < n; ++k)
+                {
+                    a[r * n + k] -= f * a[c * n + k];
+                }
+                b[r] -= f * b[c];
+            }
+        }
+        for (int c = n - 1; c >= 0; --c)
+        {
+            for (int k = c + 1; k < n; ++k)
+            {
+                b[c] -= a[c * n + k] * b[k];
+            }
+            b[c] /= a[c * n + c];
+        }
+        return true;
+    }
+
+    bool
+    valid( const HestonParams& p )
+    {
+        return p.v0 >= 0.0 && p.theta > 0.0 && p.kappa > 0.0 && p.sigma > 0.0 && fabs( p.rho ) < 1.0;
+    }
+
+    // unconstrained coordinates for the calibration
+    void
+    toCoordinates( const HestonParams& p, double* x )
+    {
+        x[0] = log( std::max( p.v0, 1E-8 ) );
+        x[1] = log( p.theta );
+        x[2] = log( p.kappa );
+        x[3] = log( p.sigma );
+        x[4] = atanh( std::clamp( p.rho, -0.999, 0.999 ) );
+    }
+
+    HestonParams
+    fromCoordinates( const double* x )
+    {
+        HestonParams p;
+        p.v0 = exp( x[0] );
+        p.theta = exp( x[1] );
+        p.kappa = exp( x[2] );
+        p.sigma = exp( x[3] );
+        p.rho = tanh( x[4] );
+        return p;
+    }
+}
+
+
+Heston::Heston( void ): m_params(), m_cosCount(256), m_fftSize(4096), m_fftSpacing(0.25), m_alpha(1.5),
+                        m_cache(), m_next(0), m_bs()
+{
+}
+
+Heston::Heston( const HestonParams& p ): m_params(p), m_cosCount(256), m_fftSize(4096), m_fftSpacing(0.25), m_alpha(1.5),
+                                         m_cache(), m_next(0), m_bs()
+{
+}
+
+void
+Heston::fftSize( int n )
+{
+    int size = 16;
+    while (size < n)
+    {
+        size *= 2;
+    }
+    m_fftSize = size;
+}
+
+Complex
+Heston::characteristic( Complex u, double rate, double T, double yield ) const
+{
+    const HestonParams& p = m_params;
+    Complex iu( -u.imag(), u.real() );
+    double s2 = p.sigma * p.sigma;
+
+    Complex xi = p.kappa - p.sigma * p.rho * iu;
+    Complex d = sqrt( xi * xi + s2 * (iu + u * u) );
+    Complex g = (xi - d) / (xi + d);
+    Complex e = exp( -d * T );
+
+    Complex c = (p.kappa * p.theta / s2) * ((xi - d) * T - 2.0 * log( (1.0 - g * e) / (1.0 - g) ));
+    Complex v = (p.v0 / s2) * (xi - d) * (1.0 - e) / (1.0 - g * e);
+    return exp( iu * (rate - yield) * T + c + v );
+}
+
+const Heston::Expiry&
+Heston::expiry( HestonMethod method, double rate, double T, double yield, double range )
+{
+    int count = (method == HestonMethod::COS) ? m_cosCount : m_fftSize;
+    for (const Expiry& e : m_cache)
+    {
+        if (e.method == method && e.T == T && e.rate == rate && e.yield == yield && e.count == count
+            && e.params == m_params && (method == HestonMethod::FFT || e.range == range))
+            return e;
+    }
+
+    if ((int) m_cache.size() < CACHE_SIZE)
+    {
+        m_cache.emplace_back();
+        m_next = (int) m_cache.size() - 1;
+    }
+    Expiry& e = m_cache[m_next];
+    m_next = (m_next + 1) % CACHE_SIZE;
+
+    e.params = m_params;
+    e.method = method;
+    e.rate = rate;
+    e.T = T;
+    e.yield = yield;
+    e.range = range;
+    e.count = count;
+    if (method == HestonMethod::COS)
+        buildCOS( e );
+    else buildFFT( e );
+    return e;
+}
+
+void
+Heston::buildCOS( Expiry& e ) const
+{
+    const HestonParams& p = m_params;
+    double T = e.T;
+    double k = p.kappa, th = p.theta, s = p.sigma, r = p.rho, v0 = p.v0;
+    double ek = exp( -k * T );
+
+    // first two cumulants of the log return (Fang and Oosterlee, 2008, table 11)
+    double c1 = (e.rate - e.yield) * T + (1.0 - ek) * (th - v0) / (2.0 * k) - 0.5 * th * T;
+    double c2 = (1.0 / (8.0 * k * k * k))
+                * (s * T * k * ek * (v0 - th) * (8.0 * k * r - 4.0 * s)
+                   + k * r * s * (1.0 - ek) * (16.0 * th - 8.0 * v0)
+                   + 2.0 * th * k * T * (-4.0 * k * r * s + s * s + 4.0 * k * k)
+                   + s * s * ((th - 2.0 * v0) * ek * ek + th * (6.0 * ek - 7.0) + 2.0 * v0)
+                   + 8.0 * k * k * (v0 - th) * (1.0 - ek));
+    if (!(c2 > 0.0))
+        c2 = th * T;
+
+    double width = COS_WIDTH * sqrt( c2 );
+    double a = c1 - width - e.range;
+    double b = c1 + width + e.range;
+    e.a = a;
+    e.b = b;
+
+    // put payoff coefficients U_k = 2 / (b - a) (psi_k(a, 0) - chi_k(a, 0))
+    int n = e.count;
+    e.coef.resize( n );
+    for (int j = 0; j < n; ++j)
+    {
+        double u = j * PI / (b - a);
+        double chi = (cos( -u * a ) - exp( a ) + u * sin( -u * a )) / (1.0 + u * u);
+        double psi = (j == 0) ? -a : sin( -u * a ) / u;
+        double U = 2.0 / (b - a) * (psi - chi);
+        e.coef[j] = characteristic( Complex( u, 0.0 ), e.rate, T, e.yield ) * U;
+    }
+    e.coef[0] *= 0.5;
+    e.grid.clear();
+}
+
+void
+Heston::buildFFT( Expiry& e ) const
+{
+    int n = e.count;
+    double eta = m_fftSpacing;
+    double lambda = 2.0 * PI / (n * eta);
+    double half = 0.5 * n * lambda;
+    double alpha = m_alpha;
+    double df = exp( -e.rate * e.T );
+
+    // call values per unit spot at log(K / S) = -half + lambda u (Carr and Madan, 1999), Simpson weights
+    std::vector<Complex> x(n);
+    for (int j = 0; j < n; ++j)
+    {
+        double v = eta * j;
+        Complex phi = characteristic( Complex( v, -(alpha + 1.0) ), e.rate, e.T, e.yield );
+        Complex psi = df * phi / Complex( alpha * alpha + alpha - v * v, (2.0 * alpha + 1.0) * v );
+        double w = (j == 0) ? 1.0 / 3.0 : (j & 1) ? 4.0 / 3.0 : 2.0 / 3.0;
+        x[j] = std::polar( 1.0, v * half ) * psi * (eta * w);
+    }
+    fft( x );
+
+    e.grid.resize( n );
+    for (int u = 0; u < n; ++u)
+    {
+        double k = -half + lambda * u;
+        e.grid[u] = exp( -alpha * k ) / PI * x[u].real();
+    }
+    e.a = -half;
+    e.b = lambda;
+    e.coef.clear();
+}
+
+bool
+Heston::values( double assetPrice, double rate, double T, double yield,
+                std::span<const double> strikes, std::span<double> prices, bool call, HestonMethod method )
+{
+    if (prices.size() < strikes.size() || !(assetPrice > 0.0) || !(T > 0.0) || !valid( m_params ))
+        return false;
+    for (double K : strikes)
+    {
+        if (!(K > 0.0))
+            return false;
+    }
+
+    double spotDf = assetPrice * exp( -yield * T );
+    double df = exp( -rate * T );
+
+    if (method == HestonMethod::COS)
+    {
+        double range = 0.0;
+        for (double K : strikes)
+        {
+            range = std::max( range, fabs( log( assetPrice / K ) ) );
+        }
+        range = 0.5 * ceil( 2.0 * range + 1E-12 );   // steps of 0.5, so nearby grids share a cache entry
+
+        const Expiry& e = expiry( method, rate, T, yield, range );
+        int n = (int) e.coef.size();
+        for (size_t i = 0; i < strikes.size(); ++i)
+        {
+            double K = strikes[i];
+            double z = log( assetPrice / K ) - e.a;
+            Complex step = std::polar( 1.0, PI * z / (e.b - e.a) );
+            Complex rot = 1.0, sum = 0.0;
+            for (int j = 0; j < n; ++j)
+            {
+                sum += e.coef[j] * rot;
+                rot *= step;
+            }
+            double put = std::max( K * df * sum.real(), 0.0 );
+            prices[i] = (call) ? std::max( put + spotDf - K * df, 0.0 ) : put;
+        }
+        return true;
+    }
+
+    const Expiry& e = expiry( method, rate, T, yield, 0.0 );
+    int n = (int) e.grid.size();
+    for (size_t i = 0; i < strikes.size(); ++i)
+    {
+        double K = strikes[i];
+        double pos = (log( K / assetPrice ) - e.a) / e.b;
+        int j = (int) floor( pos );
+        if (j < 1 || j + 2 >= n)
+        {
+            prices[i] = NAN;
+            continue;
+        }
+
+        // cubic Lagrange through grid points j-1 .. j+2
+        double t = pos - j;
+        double w0 = -t * (t - 1.0) * (t - 2.0) / 6.0;
+        double w1 = (t + 1.0) * (t - 1.0) * (t - 2.0) / 2.0;
+        double w2 = -(t + 1.0) * t * (t - 2.0) / 2.0;
+        double w3 = (t + 1.0) * t * (t - 1.0) / 6.0;
+        double c = assetPrice * (w0 * e.grid[j - 1] + w1 * e.grid[j] + w2 * e.grid[j + 1] + w3 * e.grid[j + 2]);
+        c = std::max( c, 0.0 );
+        prices[i] = (call) ? c : std::max( c - spotDf + K * df, 0.0 );
+    }
+    return true;
+}
+
+double
+Heston::value( double strike, double assetPrice, double rate, double T, double yield, bool call )
+{
+    double v = NAN;
+    values( assetPrice, rate, T, yield, std::span<const double>( &strike, 1 ), std::span<double>( &v, 1 ), call );
+    return v;
+}
+
+bool
+Heston::impliedVols( double assetPrice, double rate, double T, double yield,
+                     std::span<const double> strikes, std::span<double> vols, HestonMethod method )
+{
+    if (!values( assetPrice, rate, T, yield, strikes, vols, true, method ))
+        return false;
+
+    for (size_t i = 0; i < strikes.size(); ++i)
+    {
+        double K = strikes[i];
+        double c = vols[i];
+        double lower = std::max( assetPrice * exp( -yield * T ) - K * exp( -rate * T ), 0.0 );
+        if (!(c > lower && c < assetPrice * exp( -yield * T )))
+        {
+            vols[i] = NAN;
+            continue;
+        }
+
+        double vol = m_bs.impliedVol( K, assetPrice, c, rate, T, yield );
+        bool ok = vol > 0.0 && fabs( m_bs.value( K, assetPrice, vol, rate, T, yield, true ) - c ) <= 1E-6 * assetPrice;
+        vols[i] = (ok) ? vol : NAN;
+    }
+    return true;
+}
+
+
+HestonCalibrator::HestonCalibrator( int threads ): m_pool(threads), m_models(), m_strikes(), m_values(),
+                                                   m_order(), m_groups(), m_method(HestonMethod::COS),
+                                                   m_maxIterations(50), m_iterations(0)
+{
+    m_models.resize( m_pool.threads() );
+    m_strikes.resize( m_pool.threads() );
+    m_values.resize( m_pool.threads() );
+}
+
+void
+HestonCalibrator::evaluate( double assetPrice, double rate, double yield, std::span<const HestonQuote> quotes,
+                            const std::vector<HestonParams>& sets, std::vector<double>& out )
+{
+    int n = (int) quotes.size();
+    int groups = (int) m_groups.size() - 1;
+    out.assign( sets.size() * n, NAN );
+
+    // one task per (parameter set, expiry)
+    m_pool.run( (int) sets.size() * groups, [&]( int task, int w )
+    {
+        int s = task / groups;
+        int g = task % groups;
+        int first = m_groups[g], last = m_groups[g + 1];
+        double T = quotes[m_order[first]].T;
+
+        std::vector<double>& strikes = m_strikes[w];
+        std::vector<double>& puts = m_values[w];
+        strikes.clear();
+        for (int i = first; i < last; ++i)
+        {
+            strikes.push_back( quotes[m_order[i]].strike );
+        }
+        puts.resize( strikes.size() );
+
+        Heston& model = m_models[w];
+        model.params( sets[s] );
+        if (!model.values( assetPrice, rate, T, yield, strikes, puts, false, m_method ))
+            return;
+
+        double spotDf = assetPrice * exp( -yield * T );
+        double df = exp( -rate * T );
+        for (int i = first; i < last; ++i)
+        {
+            const HestonQuote& q = quotes[m_order[i]];
+            double p = puts[i - first];
+            out[(size_t) s * n + m_order[i]] = (q.call) ? p + spotDf - q.strike * df : p;
+        }
+    });
+}
+
+double
+HestonCalibrator::calibrate( double assetPrice, double rate, double yield, std::span<const HestonQuote> quotes, HestonParams& p )
+{
+    const int P = 5;
+    int n = (int) quotes.size();
+    m_iterations = 0;
+    if (n == 0)
+        return NAN;
+
+    // group the quotes by expiry
+    m_order.resize( n );
+    std::iota( m_order.begin(), m_order.end(), 0 );
+    std::sort( m_order.begin(), m_order.end(), [&]( int a, int b )
+    {
+        return (quotes[a].T != quotes[b].T) ? quotes[a].T < quotes[b].T : quotes[a].strike < quotes[b].strike;
+    });
+    m_groups.assign( 1, 0 );
+    for (int i = 1; i < n; ++i)
+    {
+        if (quotes[m_order[i]].T != quotes[m_order[i - 1]].T)
+            m_groups.push_back( i );
+    }
+    m_groups.push_back( n );
+
+    double weights = 0.0;
+    std::vector<double> sw(n);
+    for (int i = 0; i < n; ++i)
+    {
+        sw[i] = sqrt( std::max( quotes[i].weight, 0.0 ) );
+        weights += quotes[i].weight;
+    }
+
+    auto cost = [&]( const double* model, std::vector<double>* r )
+    {
+        double sum = 0.0;
+        for (int i = 0; i < n; ++i)
+        {
+            double e = sw[i] * (model[i] - quotes[i].marketPrice);
+            if (r)
+                (*r)[i] = e;
+            sum += e * e;
+        }
+        return (isfinite( sum )) ? sum : HUGE_VAL;
+    };
+
+    double x[P];
+    toCoordinates( p, x );
+    std::vector<HestonParams> sets(P + 1);
+    std::vector<double> out, trial, r(n), rBump(n);
+    Matrix<double> J(n, P, 0.0);
+    std::vector<double> A(P * P), g(P);
+
+    const double h = 1E-5;
+    double lambda = 1E-3;
+    evaluate( assetPrice, rate, yield, quotes, std::vector<HestonParams>( 1, fromCoordinates( x ) ), out );
+    double best = cost( out.data(), &r );
+
+    for (m_iterations = 0; m_iterations < m_maxIterations; ++m_iterations)
+    {
+        // forward difference Jacobian; the base and the five bumps in one parallel evaluation
+        sets[0] = fromCoordinates( x );
+        for (int j = 0; j < P; ++j)
+        {
+            double xb[P];
+            std::copy( x, x + P, xb );
+            xb[j] += h;
+            sets[j + 1] = fromCoordinates( xb );
+        }
+        evaluate( assetPrice, rate, yield, quotes, sets, out );
+        best = cost( out.data(), &r );
+        for (int j = 0; j < P; ++j)
+        {
+            cost( out.data() + (size_t) (j + 1) * n, &rBump );
+            for (int i = 0; i < n; ++i)
+            {
+                J[i][j] = (rBump[i] - r[i]) / h;
+            }
+        }
+
+        for (int j = 0; j < P; ++j)
+        {
+            g[j] = 0.0;
+            for (int i = 0; i < n; ++i)
+            {
+                g[j] += J[i][j] * r[i];
+            }
+            for (int k = 0; k < P; ++k)
+            {
+                double s = 0.0;
+                for (int i = 0; i < n; ++i)
+                {
+                    s += J[i][j] * J[i][k];
+                }
+                A[j * P + k] = s;
+            }
+        }
+
+        // damp until a step lowers the error
+        bool improved = false;
+        double step = 0.0;
+        while (lambda < 1E10)
+        {
+            std::vector<double> a = A, d(P);
+            for (int j = 0; j < P; ++j)
+            {
+                a[j * P + j] += lambda * (A[j * P + j] + 1E-12);
+                d[j] = -g[j];
+            }
+            if (!solve( P, a, d ))
+            {
+                lambda *= 10.0;
+                continue;
+            }
+
+            double xt[P];
+            step = 0.0;
+            for (int j = 0; j < P; ++j)
+            {
+                xt[j] = x[j] + d[j];
+                step = std::max( step, fabs( d[j] ) );
+            }
+            evaluate( assetPrice, rate, yield, quotes, std::vector<HestonParams>( 1, fromCoordinates( xt ) ), trial );
+            double c = cost( trial.data(), nullptr );
+            if (c < best)
+            {
+                improved = (best - c) > 1E-12 * best && step > 1E-10;
+                std::copy( xt, xt + P, x );
+                best = c;
+                lambda = std::max( lambda * 0.1, 1E-12 );
+                break;
+            }
+            lambda *= 10.0;
+        }
+        if (!improved)
+            break;
+    }
+
+    p = fromCoordinates( x );
+    return (weights > 0.0) ? sqrt( best / weights ) : NAN;
+}
+
+//
@@ -0,0 +1,247 @@
+/* Heston Stochastic Volatility Model 18/10/2026
+
+ $$$$$$$$$$$$$$$$$$$$$$$$$
+ $   Heston.h - header   $
+ $$$$$$$$$$$$$$$$$$$$$$$$$
+
+ Copyright (C) 2026  W.B. Yates
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see http://www.gnu.org/licenses/
+
+ History:
+
+ Heston (1993) European options, priced a whole expiry's strike grid at a time from the characteristic
+ function of the log return (in the "little trap" form of Albrecher et al., 2007, which is continuous in u).
+
+    dS = (r - q) S dt + sqrt(v) S dW1,   dv = kappa (theta - v) dt + sigma sqrt(v) dW2,   dW1 dW2 = rho dt
+
+ HestonMethod::COS (Fang and Oosterlee, 2008) expands the density of log(S_T / K) in cosCount() cosine
+ terms on an interval set from the first two cumulants; a grid of N strikes costs N x cosCount() complex
+ multiplies once the characteristic function and payoff coefficients are known. Puts are priced and calls
+ follow by put-call parity. HestonMethod::FFT (Carr and Madan, 1999) prices calls at fftSize() log strikes
+ spaced 2 pi / (fftSize() fftSpacing()) apart in one FFT, and each requested strike is interpolated
+ (cubic) from that grid.
+
+ The work that depends only on the expiry (characteristic function values and payoff coefficients for
+ COS, the whole price grid for FFT) is cached, keyed by the parameters, rate, yield and T, and by the
+ moneyness range for COS. Prices scale with the spot, so the cache holds across spot moves, and repeated
+ grids for one expiry (calls and puts, impliedVols(), a new strike list) reuse it. A Heston holds its
+ cache as mutable workspace, so use one per thread.
+
+ HestonCalibrator fits the five parameters to a set of quotes by Levenberg-Marquardt on the price errors,
+ in coordinates that keep v0, theta, kappa and sigma positive and rho in (-1, 1). Each Jacobian is a base
+ evaluation and five bumped ones, and every (parameter set, expiry) pair is a task on a TaskPool, one
+ Heston per worker.
+
+ Examples
+
+    Heston heston( HestonParams{ 0.04, 0.04, 1.5, 0.5, -0.7 } );   // v0, theta, kappa, sigma, rho
+    std::vector<double> strikes = { 80, 90, 100, 110, 120 }, vols(strikes.size());
+    heston.impliedVols( 100.0, 0.03, 1.0, 0.0, strikes, vols );     // the smile, via BlackScholes::impliedVol
+
+    HestonCalibrator calibrator;
+    HestonParams p = heston.params();
+    double rms = calibrator.calibrate( 100.0, 0.03, 0.0, quotes, p );
+ */
+
+
+#ifndef __HESTON_H__
+#define __HESTON_H__
+
+#include <span>
+#include <vector>
+#include <complex>
+
+#ifndef __BLACKSCHOLES_H__
+#include "BlackScholes.h"
+#endif
+
+#ifndef __TASKPOOL_H__
+#include "TaskPool.h"
+#endif
+
+
+struct HestonParams
+{
+    double v0 = 0.04;     // initial variance
+    double theta = 0.04;  // long run variance
+    double kappa = 1.0;   // mean reversion speed
+    double sigma = 0.3;   // volatility of variance
+    double rho = -0.5;    // correlation of spot and variance
+
+    bool
+    operator==( const HestonParams& p ) const = default;
+};
+
+enum class HestonMethod : int { COS = 0, FFT = 1 };
+
+struct HestonQuote
+{
+    double strike = 0.0;
+    double T = 0.0;            // time to maturity (year fraction)
+    double marketPrice = 0.0;
+    bool call = true;
+    double weight = 1.0;
+};
+
+
+class Heston
+{
+public:
+
+    Heston( void );
+    explicit Heston( const HestonParams& p );
+    ~Heston() {}
+
+    double
+    value( double strike,       // option strike
+           double assetPrice,   // underlying asset's current value
+           double rate,         // risk free rate of interest
+           double T,            // time to maturity (year fraction)
+           double yield = 0.0,  // annualised yield of underlying asset (continuous compounded)
+           bool call = true );
+
+    // prices[i] for strikes[i]; returns false (and leaves prices alone) for bad inputs
+    bool
+    values( double assetPrice,                 // underlying asset's current value
+            double rate,                       // risk free rate of interest
+            double T,                          // time to maturity (year fraction)
+            double yield,                      // annualised yield of underlying asset (continuous compounded)
+            std::span<const double> strikes,
+            std::span<double> prices,
+            bool call = true,
+            HestonMethod method = HestonMethod::COS );
+
+    // BlackScholes implied vols of the values; NaN where a value is outside the BlackScholes bounds
+    bool
+    impliedVols( double assetPrice, double rate, double T, double yield,
+                 std::span<const double> strikes,
+                 std::span<double> vols,
+                 HestonMethod method = HestonMethod::COS );
+
+    // E[exp(i u log(S_T / S_0))]
+    std::complex<double>
+    characteristic( std::complex<double> u, double rate, double T, double yield ) const;
+
+    const HestonParams&
+    params( void ) const { return m_params; }
+
+    void
+    params( const HestonParams& p ) { m_params = p; }
+
+    int
+    cosCount( void ) const { return m_cosCount; }
+
+    void
+    cosCount( int n ) { m_cosCount = (n > 8) ? n : 8; }
+
+    int
+    fftSize( void ) const { return m_fftSize; }
+
+    void
+    fftSize( int n ); // rounded up to a power of two
+
+    double
+    fftSpacing( void ) const { return m_fftSpacing; }
+
+    void
+    fftSpacing( double eta ) { m_fftSpacing = eta; }
+
+    void
+    clearCache( void ) { m_cache.clear(); m_next = 0; }
+
+private:
+
+    struct Expiry
+    {
+        HestonParams params;
+        HestonMethod method = HestonMethod::COS;
+        double rate = 0.0;
+        double T = 0.0;
+        double yield = 0.0;
+        double range = 0.0;                         // COS: |log(S/K)| covered
+        int count = 0;                              // COS terms or FFT size
+        double a = 0.0;                             // COS interval, or FFT first log strike
+        double b = 0.0;                             // COS interval end, or FFT log strike spacing
+        std::vector<std::complex<double>> coef;     // COS: phi(u_k) U_k
+        std::vector<double> grid;                   // FFT: call values per unit spot
+    };
+
+    const Expiry&
+    expiry( HestonMethod method, double rate, double T, double yield, double range );
+
+    void
+    buildCOS( Expiry& e ) const;
+
+    void
+    buildFFT( Expiry& e ) const;
+
+    HestonParams m_params;
+    int m_cosCount;
+    int m_fftSize;
+    double m_fftSpacing;
+    double m_alpha;
+    std::vector<Expiry> m_cache;
+    int m_next;
+    BlackScholes m_bs;
+};
+
+
+class HestonCalibrator
+{
+public:
+
+    explicit HestonCalibrator( int threads = 0 ); // 0 uses one thread per core
+
+    // fits p (which is also the start) to quotes; returns the weighted rms price error, NaN if no quotes
+    double
+    calibrate( double assetPrice, double rate, double yield, std::span<const HestonQuote> quotes, HestonParams& p );
+
+    int
+    maxIterations( void ) const { return m_maxIterations; }
+
+    void
+    maxIterations( int n ) { m_maxIterations = n; }
+
+    int
+    iterations( void ) const { return m_iterations; }  // of the last calibrate()
+
+    HestonMethod
+    method( void ) const { return m_method; }
+
+    void
+    method( HestonMethod m ) { m_method = m; }
+
+private:
+
+    // model values of the quotes for each parameter set in sets; out is sets x quotes
+    void
+    evaluate( double assetPrice, double rate, double yield, std::span<const HestonQuote> quotes,
+              const std::vector<HestonParams>& sets, std::vector<double>& out );
+
+    TaskPool m_pool;
+    std::vector<Heston> m_models;               // one per worker
+    std::vector<std::vector<double>> m_strikes; // per worker scratch
+    std::vector<std::vector<double>> m_values;
+    std::vector<int> m_order;                   // quotes by expiry
+    std::vector<int> m_groups;                  // expiry g is m_order[m_groups[g]] .. m_order[m_groups[g+1]-1]
+    HestonMethod m_method;
+    int m_maxIterations;
+    int m_iterations;
+};
+
+
+#endif
+
+///
@@ -0,0 +1,84 @@
+/* American Implied Volatility Chain 18/10/2026
+
+ $$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$
+ $   ImpliedVolChain.cpp - code   $
+ $$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$
+
+ by W.B. Yates
+ Copyright (c) W.B. Yates. All rights reserved.
+ History:
+
+ */
+
+#include <math.h>
+#include <numeric>
+#include <algorithm>
+
+#ifndef __IMPLIEDVOLCHAIN_H__
+#include "ImpliedVolChain.h"
+#endif
+
+
+ImpliedVolChain::ImpliedVolChain( int threads ): m_pool(threads),
+                                                 m_trees(),
+                                                 m_order(),
+                                                 m_runs(),
+                                                 m_steps(BinomialTree().timeSteps()),
+                                                 m_minRun(8)
+{
+    m_trees.resize( m_pool.threads() );
+}
+
+void
+ImpliedVolChain::solve( double assetPrice,  // underlying asset's current value
+                        double rate,        // risk free rate of interest
+                        double T,           // time to maturity (year fraction)
+                        double yield,       // annualised yield of underlying asset (continuous compounded)
+                        std::span<const ChainQuote> quotes,
+                        std::span<double> vols )
+{
+    int n = (int) quotes.size();
+    if (n == 0 || (int) vols.size() < n)
+        return;
+
+    m_order.resize( n );
+    std::iota( m_order.begin(), m_order.end(), 0 );
+    std::sort( m_order.begin(), m_order.end(), [&]( int a, int b )
+    {
+        if (quotes[a].call != quotes[b].call)
+            return quotes[a].call;
+        return quotes[a].strike < quotes[b].strike;
+    });
+
+    // about two runs per thread, never shorter than minRun() and never mixing calls and puts
+    int calls = (int) (std::partition_point( m_order.begin(), m_order.end(), [&]( int i ) { return quotes[i].call; } ) - m_order.begin());
+    int length = std::max( m_minRun, (n + 2 * m_pool.threads() - 1) / (2 * m_pool.threads()) );
+    m_runs.assign( 1, 0 );
+    for (int at = 0; at < n; )
+    {
+        int end = std::min( at + length, (at < calls) ? calls : n );
+        m_runs.push_back( end );
+        at = end;
+    }
+
+    for (BinomialTree& tree : m_trees)
+    {
+        if (tree.timeSteps() != m_steps)
+            tree.timeSteps( m_steps );
+    }
+
+    m_pool.run( (int) m_runs.size() - 1, [&]( int r, int w )
+    {
+        BinomialTree& tree = m_trees[w];
+        double guess = 0.0;
+        for (int k = m_runs[r]; k < m_runs[r + 1]; ++k)
+        {
+            const ChainQuote& q = quotes[m_order[k]];
+            double vol = tree.impliedVol( q.strike, assetPrice, q.marketPrice, rate, T, yield, q.call, guess );
+            vols[m_order[k]] = vol;
+            guess = (isnan( vol )) ? 0.0 : vol;
+        }
+    });
+}
+
+//
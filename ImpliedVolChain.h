@@ -0,0 +1,105 @@
+/* American Implied Volatility Chain 18/10/2026
+
+ $$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$
+ $   ImpliedVolChain.h - header   $
+ $$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$
+
+ Copyright (C) 2026  W.B. Yates
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see http://www.gnu.org/licenses/
+
+ History:
+
+ BinomialTree implied vols for a chain of American quotes on one underlying and expiry.
+
+ The quotes are visited in strike order (calls and puts separately) and cut into contiguous runs which
+ are solved on a TaskPool, one BinomialTree per worker. The first quote of a run starts from the
+ de-Americanized BlackScholes vol; each later quote starts from its neighbour's solution, which is
+ usually within a Brent step or two of its own. Runs are at least minRun() quotes long, so a chain of
+ a few hundred strikes is split into a handful of warm started sweeps per thread.
+
+ Examples
+
+    ImpliedVolChain chain;                     // one thread per core
+    chain.timeSteps( 200 );
+    std::vector<ChainQuote> quotes = ...;      // strike, price, call
+    std::vector<double> vols( quotes.size() );
+    chain.solve( assetPrice, rate, T, yield, quotes, vols );   // NaN where a quote cannot be matched
+ */
+
+
+#ifndef __IMPLIEDVOLCHAIN_H__
+#define __IMPLIEDVOLCHAIN_H__
+
+#include <span>
+#include <vector>
+
+#ifndef __BINOMIALTREE_H__
+#include "BinomialTree.h"
+#endif
+
+#ifndef __TASKPOOL_H__
+#include "TaskPool.h"
+#endif
+
+
+struct ChainQuote
+{
+    double strike = 0.0;
+    double marketPrice = 0.0;
+    bool call = true;
+};
+
+
+class ImpliedVolChain
+{
+public:
+
+    explicit ImpliedVolChain( int threads = 0 ); // 0 uses one thread per core
+
+    // vols.size() must be at least quotes.size()
+    void
+    solve( double assetPrice,                   // underlying asset's current value
+           double rate,                         // risk free rate of interest
+           double T,                            // time to maturity (year fraction)
+           double yield,                        // annualised yield of underlying asset (continuous compounded)
+           std::span<const ChainQuote> quotes,
+           std::span<double> vols );
+
+    int
+    timeSteps( void ) const { return m_steps; }
+
+    void
+    timeSteps( int n ) { m_steps = (n > 0) ? n : 1; }
+
+    int
+    minRun( void ) const { return m_minRun; }
+
+    void
+    minRun( int n ) { m_minRun = (n > 0) ? n : 1; }
+
+private:
+
+    TaskPool m_pool;
+    std::vector<BinomialTree> m_trees;  // one per worker
+    std::vector<int> m_order;           // quote indices, calls then puts, by strike
+    std::vector<int> m_runs;            // run r solves m_order[m_runs[r]] .. m_order[m_runs[r+1]-1]
+    int m_steps;
+    int m_minRun;
+};
+
+
+#endif
+
+///
@@ -0,0 +1,188 @@
+/* Streaming Implied Volatility 18/10/2026
+
+ $$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$
+ $   ImpliedVolStream.cpp - code   $
+ $$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$
+
+ by W.B. Yates
+ Copyright (c) W.B. Yates. All rights reserved.
+ History:
+
+ */
+
+#include <math.h>
+
+#ifndef __IMPLIEDVOLSTREAM_H__
+#include "ImpliedVolStream.h"
+#endif
+
+
+namespace {
+
+const double VOL_MIN = 1E-4;
+const double VOL_MAX = 10.0;
+const int MAX_ITERATIONS = 64;
+const double INV_SQRT_2PI = 0.398942280401432677940;
+
+// N(x) as BatchKernels::N, given e = exp(-x * x / 2)
+inline double
+normal( double x, double e )
+{
+    const double a1 = 0.31938153, a2 = -0.356563782, a3 = 1.781477937, a4 = -1.821255978, a5 = 1.330274429;
+    double K = 1.0 / (1.0 + 0.2316419 * fabs( x ));
+    double w = 1.0 - INV_SQRT_2PI * e * (K * (a1 + K * (a2 + K * (a3 + K * (a4 + K * a5)))));
+    return (x < 0.0) ? 1.0 - w : w;
+}
+
+// Corrado and Miller (1996), from the call value (or the put's via parity) in forward terms
+double
+coldStart( double price, double forward, double strike, double discount, double sqrtT, bool call )
+{
+    double S = discount * forward, X = discount * strike;
+    double C = (call) ? price : price + S - X;
+    double a = C - 0.5 * (S - X);
+    double b = a * a - (S - X) * (S - X) / M_PI;
+    double vol = sqrt( 2.0 * M_PI ) / (S + X) * (a + sqrt( (b > 0.0) ? b : 0.0 )) / sqrtT;
+    return (vol > 1E-3 && vol < 5.0) ? vol : 0.3;
+}
+
+}
+
+
+ImpliedVolStream::ImpliedVolStream( double maxAge ): m_table(),
+                                                     m_maxAge(maxAge),
+                                                     m_tolerance(1E-6),
+                                                     m_evaluations(0)
+{
+}
+
+int
+ImpliedVolStream::addContract( const VolContract& c )
+{
+    m_table.emplace_back();
+    Slot& s = m_table.back();
+    s.vol = NAN;
+    s.vega = 0.0;
+    s.mid = NAN;
+    s.underlying = NAN;
+    s.time = -INFINITY;
+    contract( (int) m_table.size() - 1, c );
+    return (int) m_table.size() - 1;
+}
+
+void
+ImpliedVolStream::contract( int id, const VolContract& c )
+{
+    Slot& s = m_table[id];
+    s.strike = c.strike;
+    s.sqrtT = sqrt( c.T );
+    s.discount = exp( -c.rate * c.T );
+    s.growth = (c.black) ? 1.0 : exp( (c.rate - c.yield) * c.T );
+    s.call = c.call;
+    // the same quote now means another vol
+    s.mid = NAN;
+}
+
+void
+ImpliedVolStream::process( std::span<const VolUpdate> updates, double now, std::span<VolResult> results )
+{
+    if (results.size() < updates.size())
+        return;
+
+    for (size_t i = 0; i < updates.size(); ++i)
+    {
+        results[i] = solve( m_table[updates[i].contract], updates[i], now );
+    }
+}
+
+VolResult
+ImpliedVolStream::solve( Slot& s, const VolUpdate& u, double now )
+{
+    VolResult r;
+    r.vol = s.vol;
+    r.vega = s.vega;
+
+    if (u.bid > 0.0 && u.ask > 0.0 && u.bid > u.ask)
+    {
+        r.status = VolStatus::Crossed;
+        return r;
+    }
+    if (u.time < s.time || now - u.time > m_maxAge)
+    {
+        r.status = VolStatus::Stale;
+        return r;
+    }
+    s.time = u.time;
+
+    double mid = (u.bid > 0.0 && u.ask > 0.0) ? 0.5 * (u.bid + u.ask) : (u.bid > 0.0) ? u.bid : u.ask;
+    if (mid == s.mid && u.underlying == s.underlying)
+    {
+        r.status = VolStatus::Unchanged;
+        return r;
+    }
+
+    // no arbitrage bounds: between the discounted intrinsic value and the discounted forward (or strike)
+    double F = u.underlying * s.growth, K = s.strike, D = s.discount;
+    double intrinsic = D * ((s.call) ? F - K : K - F);
+    if (!(mid > intrinsic && mid > 0.0 && mid < D * ((s.call) ? F : K)))
+    {
+        r.status = VolStatus::Arbitrage;
+        return r;
+    }
+
+    double logFK = log( F / K );
+    double sign = (s.call) ? 1.0 : -1.0;
+    double v = (isnan( s.vol )) ? coldStart( mid, F, K, D, s.sqrtT, s.call ) : s.vol;
+    double lo = VOL_MIN, hi = VOL_MAX, vega = 0.0;
+    bool converged = false;
+
+    while (!converged && r.iterations < MAX_ITERATIONS)
+    {
+        double term = v * s.sqrtT;
+        double d1 = (logFK + 0.5 * term * term) / term;
+        double d2 = d1 - term;
+        // one exp: the density at d2 is the density at d1 times F / K
+        double e1 = exp( -0.5 * d1 * d1 ), e2 = e1 * F / K;
+        double value = D * sign * (F * normal( sign * d1, e1 ) - K * normal( sign * d2, e2 ));
+        vega = D * F * s.sqrtT * INV_SQRT_2PI * e1;
+        ++r.iterations;
+
+        double diff = value - mid;
+        if (diff == 0.0)
+            break;
+        if (diff > 0.0)
+            hi = v;
+        else
+            lo = v;
+
+        // Newton, accepted once the error it leaves is below tolerance; bisection when it leaves the bracket
+        double step = diff / vega;
+        double next = v - step;
+        double error = 0.5 * fabs( d1 * d2 ) / v * step * step;
+        if (!(next > lo && next < hi))
+        {
+            next = 0.5 * (lo + hi);
+            error = hi - lo;
+        }
+        converged = error <= m_tolerance;
+        v = next;
+    }
+    m_evaluations += r.iterations;
+
+    r.vega = vega;
+    if (!converged && r.iterations == MAX_ITERATIONS)
+    {
+        r.status = VolStatus::Failed;
+        return r;
+    }
+
+    s.vol = v;
+    s.vega = vega;
+    s.mid = mid;
+    s.underlying = u.underlying;
+    r.vol = v;
+    r.status = VolStatus::Solved;
+    return r;
+}
+
+//
@@ -0,0 +1,162 @@
+/* Streaming Implied Volatility 18/10/2026
+
+ $$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$
+ $   ImpliedVolStream.h - header   $
+ $$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$
+
+ Copyright (C) 2026  W.B. Yates
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see http://www.gnu.org/licenses/
+
+ History:
+
+ BlackScholes and Black implied vols for a stream of quote updates, one contract at a time.
+
+ BlackScholes::impliedVol and Black::impliedVol start every solve from vol = 0.5. Between two ticks a
+ contract's vol barely moves, so here each contract keeps its last vol and the vega there in one 128
+ byte slot of a flat table, with the contract's strike, sqrt(T) and discount factors precomputed. An
+ update is usually one Newton step from the last vol: one value and vega evaluation, costing a single
+ exp. The step is accepted when the second order error it leaves, 0.5 |d1 d2| / vol * step^2, is below
+ tolerance(); otherwise Newton continues, falling back to bisection whenever a step leaves the bracket
+ its evaluations have established. A contract's first quote starts from the Corrado and Miller (1996)
+ approximation.
+
+ Quotes which cannot be solved are flagged and left alone: a crossed bid and ask, a quote older than
+ maxAge() or than the contract's last one (stale), a price outside the no arbitrage bounds, or the same
+ mid and underlying as the last solve (unchanged, the last vol is returned).
+
+ Values use the approximation of N(x) in BlackScholes and Black, so the vols invert their value().
+
+ Examples
+
+    ImpliedVolStream stream;
+    int c = stream.addContract( VolContract{ 100.0, 0.5, 0.05, 0.01, true } );
+    std::vector<VolUpdate> updates = ...;    // contract, bid, ask, underlying, time
+    std::vector<VolResult> results( updates.size() );
+    stream.process( updates, now, results );
+    double vol = results[0].vol;             // Solved, or the last vol with another status
+ */
+
+
+#ifndef __IMPLIEDVOLSTREAM_H__
+#define __IMPLIEDVOLSTREAM_H__
+
+#include <span>
+#include <vector>
+#include <cstdint>
+
+
+enum class VolStatus : uint8_t { Solved = 0, Unchanged, Stale, Crossed, Arbitrage, Failed };
+
+struct VolContract
+{
+    double strike = 0.0;
+    double T = 0.0;         // time to maturity (year fraction)
+    double rate = 0.0;      // risk free rate of interest
+    double yield = 0.0;     // annualised yield of underlying asset (continuous compounded); ignored for Black
+    bool call = true;
+    bool black = false;     // the underlying is a forward price, as Black
+};
+
+struct VolUpdate
+{
+    int contract = 0;
+    double bid = 0.0;       // 0 for none; the mid is then the ask
+    double ask = 0.0;       // 0 for none; the mid is then the bid
+    double underlying = 0.0;
+    double time = 0.0;      // quote time, in the units of maxAge()
+};
+
+struct VolResult
+{
+    double vol = 0.0;       // the contract's last solved vol, unless Solved; NaN if it has none
+    double vega = 0.0;      // at the last evaluated vol, per unit of vol
+    VolStatus status = VolStatus::Solved;
+    int iterations = 0;     // value and vega evaluations
+};
+
+
+class ImpliedVolStream
+{
+public:
+
+    explicit ImpliedVolStream( double maxAge = 5.0 );
+    ~ImpliedVolStream() {}
+
+    int // returns the contract's id
+    addContract( const VolContract& c );
+
+    // redefine a contract (a new T as time passes, say); its solver state is kept as the next start
+    void
+    contract( int id, const VolContract& c );
+
+    // results.size() must be at least updates.size(); updates are applied in order
+    void
+    process( std::span<const VolUpdate> updates, double now, std::span<VolResult> results );
+
+    double
+    vol( int id ) const { return m_table[id].vol; }
+
+    double
+    vega( int id ) const { return m_table[id].vega; }
+
+    int
+    size( void ) const { return (int) m_table.size(); }
+
+    double
+    maxAge( void ) const { return m_maxAge; }
+
+    void
+    maxAge( double a ) { m_maxAge = a; }
+
+    double // in vol
+    tolerance( void ) const { return m_tolerance; }
+
+    void
+    tolerance( double t ) { m_tolerance = t; }
+
+    long // value and vega evaluations since construction
+    evaluations( void ) const { return m_evaluations; }
+
+private:
+
+    // one contract's constants and solver state
+    struct alignas(64) Slot
+    {
+        double strike;
+        double sqrtT;
+        double discount;   // exp(-rate T)
+        double growth;     // forward / underlying: exp((rate - yield) T), or 1 for Black
+        double vol;        // last solution, NaN for none
+        double vega;       // at vol, returned with quotes left unsolved
+        double mid;        // last solved quote
+        double underlying;
+        double time;       // last quote time
+        bool call;
+    };
+    static_assert( sizeof(Slot) == 128, "a contract's slot is two cache lines" );
+
+    VolResult
+    solve( Slot& s, const VolUpdate& u, double now );
+
+    std::vector<Slot> m_table;
+    double m_maxAge;
+    double m_tolerance;
+    long m_evaluations;
+};
+
+
+#endif
+
+///
@@ -0,0 +1,376 @@
+/* Lazy Option and Option Book 18/10/2026
+
+ $$$$$$$$$$$$$$$$$$$$$$$$$
+ $   Option.cpp - code   $
+ $$$$$$$$$$$$$$$$$$$$$$$$$
+
+ by W.B. Yates
+ Copyright (c) W.B. Yates. All rights reserved.
+ History:
+
+ */
+
+#include <math.h>
+
+#ifndef __OPTION_H__
+#include "Option.h"
+#endif
+
+#ifndef __BATCHKERNELS_H__
+#include "BatchKernels.h"
+#endif
+
+
+namespace {
+
+    typedef std::uint32_t Mask;
+
+    Mask bit( int n ) { return Mask(1) << n; }
+
+    const Mask ALL_INPUTS = bit( Option::INPUTS ) - 1;
+    const Mask ALL_NODES = bit( Option::NODES ) - 1;
+
+    // the dependency graph for one kind of model: the inputs and nodes each node reads directly, closed
+    // into the set of nodes every input dirties and the set of nodes every node needs
+    struct Graph
+    {
+        Mask affected[Option::INPUTS];
+        Mask needs[Option::NODES];
+
+        Graph( const Mask* inputs, const Mask* nodes )
+        {
+            Mask reach[Option::NODES];
+            for (int n = 0; n < Option::NODES; ++n)
+            {
+                // the node order is topological, so earlier closures are complete
+                reach[n] = inputs[n];
+                needs[n] = nodes[n];
+                for (int m = 0; m < n; ++m)
+                {
+                    if (nodes[n] & bit( m ))
+                    {
+                        reach[n] |= reach[m];
+                        needs[n] |= needs[m];
+                    }
+                }
+            }
+            for (int i = 0; i < Option::INPUTS; ++i)
+            {
+                affected[i] = 0;
+                for (int n = 0; n < Option::NODES; ++n)
+                {
+                    if (reach[n] & bit( i ))
+                        affected[i] |= bit( n );
+                }
+            }
+        }
+    };
+
+    const Mask IN_S = bit( Option::Spot ), IN_K = bit( Option::Strike ), IN_V = bit( Option::Vol );
+    const Mask IN_R = bit( Option::Rate ), IN_T = bit( Option::Time ), IN_Q = bit( Option::Yield );
+
+    const Mask LM = bit( Option::LogMoneyness ), ST = bit( Option::SqrtT ), VST = bit( Option::VolSqrtT );
+    const Mask DISC = bit( Option::Discount ), DIV = bit( Option::Dividend ), ND1 = bit( Option::D1 );
+    const Mask ND2 = bit( Option::D2 ), NORM = bit( Option::Normals ), LAT = bit( Option::Lattice );
+
+    // inputs and nodes read by each node of a closed form option; Black's "dividend" discount reads the rate
+    Graph
+    closedForm( bool black )
+    {
+        const Mask inputs[Option::NODES] = { IN_S | IN_K, IN_T, IN_V, IN_R | IN_T, ((black) ? IN_R : IN_Q) | IN_T,
+                                             IN_R | IN_Q | IN_V | IN_T, 0, 0, 0,
+                                             IN_S | IN_K, 0, IN_S, IN_S, IN_S | IN_K | IN_V | IN_R | IN_Q, IN_K | IN_T };
+        const Mask nodes[Option::NODES] = { 0, 0, ST, 0, 0, LM | VST, ND1 | VST, ND1 | ND2, 0,
+                                            NORM | DISC | DIV, NORM | DIV, NORM | DIV | VST, NORM | DIV | ST,
+                                            NORM | DISC | DIV | ST, NORM | DISC };
+        return Graph( inputs, nodes );
+    }
+
+    // a tree's value, delta and gamma come from one lattice; theta, vega and rho are separate builds
+    Graph
+    tree( void )
+    {
+        const Mask inputs[Option::NODES] = { 0, 0, 0, 0, 0, 0, 0, 0, ALL_INPUTS, 0, 0, 0, ALL_INPUTS, ALL_INPUTS, ALL_INPUTS };
+        const Mask nodes[Option::NODES] = { 0, 0, 0, 0, 0, 0, 0, 0, 0, LAT, LAT, LAT, 0, 0, 0 };
+        return Graph( inputs, nodes );
+    }
+
+    const Graph&
+    graph( OptionModel model )
+    {
+        static const Graph graphs[3] = { closedForm( false ), closedForm( true ), tree() };
+        return graphs[(int) model];
+    }
+
+    // tree workspace shared by every Option on a thread
+    thread_local OptionPricer pricer;
+}
+
+
+Option::Option( void ): m_spec(), m_dirty(ALL_NODES), m_computed(0),
+                        m_logMoneyness(0.0), m_sqrtT(0.0), m_volSqrtT(0.0), m_discount(0.0), m_dividend(0.0),
+                        m_d1(0.0), m_d2(0.0), m_nd1(0.0), m_nd2(0.0), m_pdf(0.0), m_out()
+{
+}
+
+Option::Option( const OptionSpec& spec ): m_spec(spec), m_dirty(ALL_NODES), m_computed(0),
+                                          m_logMoneyness(0.0), m_sqrtT(0.0), m_volSqrtT(0.0), m_discount(0.0), m_dividend(0.0),
+                                          m_d1(0.0), m_d2(0.0), m_nd1(0.0), m_nd2(0.0), m_pdf(0.0), m_out()
+{
+}
+
+void
+Option::set( Input input, double& field, double x )
+{
+    if (field == x)
+        return;
+    field = x;
+    m_dirty |= graph( m_spec.model ).affected[input];
+}
+
+double
+Option::get( Node n )
+{
+    // a clean output is current even if nodes upstream of it are dirty, as after OptionBook's batched
+    // values, so it needs none of them
+    if (!(m_dirty & bit( n )))
+        return (n >= Value) ? m_out[n - Value] : NAN;
+
+    Mask work = (graph( m_spec.model ).needs[n] | bit( n )) & m_dirty;
+    for (int m = 0; work; ++m)
+    {
+        if (work & bit( m ))
+        {
+            compute( (Node) m );
+            work &= ~bit( m );
+        }
+    }
+    m_dirty &= ~((graph( m_spec.model ).needs[n] | bit( n )));
+    return (n >= Value) ? m_out[n - Value] : NAN;
+}
+
+void
+Option::compute( Node n )
+{
+    const OptionSpec& o = m_spec;
+    double sign = (o.call) ? 1.0 : -1.0;
+    double q = (o.model == OptionModel::Black) ? o.rate : o.yield;
+    ++m_computed;
+
+    if (!closedForm() && n >= Lattice)
+    {
+        BinomialTree& bt = pricer.binomialTree();
+        if (o.timeSteps > 0 && o.timeSteps != bt.timeSteps())
+            bt.timeSteps( o.timeSteps );
+
+        switch (n)
+        {
+            case Lattice:
+                // delta and gamma from the tree's first two steps, as BinomialTree::delta() and gamma() take them
+                if (o.assetPrice > 0.0 && o.vol > 0.0 && o.T > 0.0)
+                {
+                    m_out[Value - Value] = bt.value( o.strike, o.assetPrice, o.vol, o.rate, o.T, o.yield, o.call );
+                    m_out[Delta - Value] = bt.delta();
+                    m_out[Gamma - Value] = bt.gamma();
+                }
+                else
+                {
+                    m_out[Value - Value] = m_out[Delta - Value] = m_out[Gamma - Value] = NAN;
+                }
+                break;
+            case Theta: m_out[Theta - Value] = pricer.theta( o ); break;
+            case Vega:  m_out[Vega - Value] = pricer.vega( o ); break;
+            case Rho:   m_out[Rho - Value] = pricer.rho( o ); break;
+            default:    break;   // value, delta and gamma are set with the lattice
+        }
+        return;
+    }
+
+    switch (n)
+    {
+        case LogMoneyness: m_logMoneyness = log( o.assetPrice / o.strike ); break;
+        case SqrtT:        m_sqrtT = sqrt( o.T ); break;
+        case VolSqrtT:     m_volSqrtT = o.vol * m_sqrtT; break;
+        case Discount:     m_discount = exp( -o.rate * o.T ); break;
+        case Dividend:     m_dividend = exp( -q * o.T ); break;
+        case D1:           m_d1 = (m_logMoneyness + (o.rate - q + 0.5 * o.vol * o.vol) * o.T) / m_volSqrtT; break;
+        case D2:           m_d2 = m_d1 - m_volSqrtT; break;
+        case Normals:
+            m_nd1 = BatchKernels::N( sign * m_d1 );
+            m_nd2 = BatchKernels::N( sign * m_d2 );
+            m_pdf = exp( -0.5 * m_d1 * m_d1 ) * 0.398942280401432677940;
+            break;
+        case Lattice:
+            break;
+        case Value:
+            m_out[Value - Value] = sign * (o.assetPrice * m_dividend * m_nd1 - o.strike * m_discount * m_nd2);
+            break;
+        case Delta:
+            m_out[Delta - Value] = sign * m_dividend * m_nd1;
+            break;
+        case Gamma:
+            m_out[Gamma - Value] = m_dividend * m_pdf / (o.assetPrice * m_volSqrtT);
+            break;
+        case Vega:
+            m_out[Vega - Value] = o.assetPrice * m_dividend * m_pdf * m_sqrtT;
+            break;
+        case Theta:
+            m_out[Theta - Value] = -(o.assetPrice * m_dividend * m_pdf * o.vol) / (2.0 * m_sqrtT)
+                                   + sign * (q * o.assetPrice * m_dividend * m_nd1 - o.rate * o.strike * m_discount * m_nd2);
+            break;
+        case Rho:
+            m_out[Rho - Value] = sign * o.strike * o.T * m_discount * m_nd2;
+            break;
+        default:
+            break;
+    }
+}
+
+
+OptionBook::OptionBook( double rate ): m_rate(rate), m_spot(), m_yield(), m_members(), m_options(), m_underlying(),
+                                       m_queued(), m_stale(), m_batchSize(16), m_batch(),
+                                       m_K(), m_S(), m_vol(), m_r(), m_T(), m_q(), m_value(), m_call()
+{
+}
+
+int
+OptionBook::addUnderlying( double price, double yield )
+{
+    m_spot.push_back( price );
+    m_yield.push_back( yield );
+    m_members.emplace_back();
+    return (int) m_spot.size() - 1;
+}
+
+int
+OptionBook::addOption( int underlying, const OptionSpec& spec )
+{
+    OptionSpec o = spec;
+    o.assetPrice = m_spot[underlying];
+    o.yield = m_yield[underlying];
+    o.rate = m_rate;
+
+    int h = (int) m_options.size();
+    m_options.emplace_back( o );
+    m_underlying.push_back( underlying );
+    m_members[underlying].push_back( h );
+    m_queued.push_back( 0 );
+    touch( h );
+    return h;
+}
+
+void
+OptionBook::touch( int handle )
+{
+    if (!m_queued[handle] && m_options[handle].dirty( Option::Value ))
+    {
+        m_queued[handle] = 1;
+        m_stale.push_back( handle );
+    }
+}
+
+void
+OptionBook::underlyingPrice( int underlying, double price )
+{
+    m_spot[underlying] = price;
+    for (int h : m_members[underlying])
+    {
+        m_options[h].assetPrice( price );
+        touch( h );
+    }
+}
+
+void
+OptionBook::underlyingYield( int underlying, double yield )
+{
+    m_yield[underlying] = yield;
+    for (int h : m_members[underlying])
+    {
+        m_options[h].yield( yield );
+        touch( h );
+    }
+}
+
+void
+OptionBook::rate( double r )
+{
+    m_rate = r;
+    for (int h = 0; h < size(); ++h)
+    {
+        m_options[h].rate( r );
+        touch( h );
+    }
+}
+
+void
+OptionBook::vol( int handle, double v )
+{
+    m_options[handle].vol( v );
+    touch( handle );
+}
+
+void
+OptionBook::elapse( double years )
+{
+    for (int h = 0; h < size(); ++h)
+    {
+        m_options[h].T( m_options[h].T() - years );
+        touch( h );
+    }
+}
+
+void
+OptionBook::refresh( void )
+{
+    // gather the stale closed form options into columns when there are enough of them
+    m_batch.clear();
+    for (int h : m_stale)
+    {
+        if (m_options[h].closedForm())
+            m_batch.push_back( h );
+    }
+
+    int n = (int) m_batch.size();
+    if (n >= m_batchSize)
+    {
+        m_K.resize( n ); m_S.resize( n ); m_vol.resize( n ); m_r.resize( n );
+        m_T.resize( n ); m_q.resize( n ); m_call.resize( n ); m_value.resize( n );
+        for (int i = 0; i < n; ++i)
+        {
+            const OptionSpec& o = m_options[m_batch[i]].spec();
+            m_K[i] = o.strike;
+            m_S[i] = o.assetPrice;
+            m_vol[i] = o.vol;
+            m_r[i] = o.rate;
+            m_T[i] = o.T;
+            m_q[i] = (o.model == OptionModel::Black) ? o.rate : o.yield;
+            m_call[i] = (o.call) ? 1 : 0;
+        }
+        BatchKernels::blackScholes( n, m_K.data(), m_S.data(), m_vol.data(), m_r.data(), m_T.data(), m_q.data(), m_call.data(), m_value.data() );
+        for (int i = 0; i < n; ++i)
+        {
+            m_options[m_batch[i]].store( Option::Value, m_value[i] );
+        }
+    }
+
+    // the rest (trees, or a small closed form batch) one at a time; a batched value is clean already
+    for (int h : m_stale)
+    {
+        if (m_options[h].dirty( Option::Value ))
+            m_options[h].value();
+        m_queued[h] = 0;
+    }
+    m_stale.clear();
+}
+
+void
+OptionBook::values( std::span<double> values )
+{
+    refresh();
+    for (int h = 0; h < size(); ++h)
+    {
+        values[h] = m_options[h].value();
+    }
+}
+
+//
@@ -0,0 +1,251 @@
+/* Lazy Option and Option Book 18/10/2026
+
+ $$$$$$$$$$$$$$$$$$$$$$$$$
+ $   Option.h - header   $
+ $$$$$$$$$$$$$$$$$$$$$$$$$
+
+ Copyright (C) 2026  W.B. Yates
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see http://www.gnu.org/licenses/
+
+ History:
+
+ An option class embedding the models, as main.cpp suggests, which recomputes only what its last input
+ changes touched.
+
+ An Option's inputs (spot, strike, vol, rate, T, yield) feed a fixed graph of cached nodes: log moneyness,
+ sqrt(T), vol sqrt(T), the two discount factors, d1, d2, the normal terms, and for BinomialTree options the
+ lattice; then the value and Greeks. Nodes are numbered in topological order and each holds a dirty bit.
+ Setting an input dirties exactly the nodes downstream of it (a precomputed mask per input), and reading
+ an output recomputes, in order, only the dirty nodes it depends on. So a vol change on a BlackScholes
+ option costs vol sqrt(T), d1, d2 and the normals, not the discount factors or the log; a rate change
+ leaves the log, sqrt(T) and the yield discount alone. Nothing is recomputed until it is read.
+
+ Black options are BlackScholes options on the forward with yield = rate. A BinomialTree option takes
+ value, delta and gamma from one value() build, delta and gamma from its first two steps as
+ BinomialTree::delta() and gamma() do, and theta, vega and rho as OptionPricer does; its
+ lattice depends on every input. Tree workspace is one BinomialTree per thread, shared by all Options.
+
+ An OptionBook holds Options on shared underlyings and a book wide rate. Moving an underlying or the rate
+ sets that input on each Option depending on it and queues those Options as stale. values() brings every
+ value up to date; when batchSize() or more closed form Options are stale their values are computed
+ together by BatchKernels::blackScholes from gathered columns, and the trees are revalued one at a time.
+ A batched value leaves the nodes upstream of it dirty; they are computed only if a Greek is read.
+
+ Examples
+
+    OptionSpec spec = ...;
+    Option o( spec );
+    double v = o.value();       // computes everything value needs
+    o.vol( 0.25 );
+    double g = o.gamma();       // recomputes vol sqrt(T), d1, d2, normals and gamma only
+
+    OptionBook book( 0.05 );
+    int ibm = book.addUnderlying( 150.0 );
+    int h = book.addOption( ibm, spec );
+    book.underlyingPrice( ibm, 151.0 );
+    std::vector<double> values( book.size() );
+    book.values( values );
+ */
+
+
+#ifndef __OPTION_H__
+#define __OPTION_H__
+
+#include <span>
+#include <vector>
+#include <cstdint>
+
+#ifndef __OPTIONPRICER_H__
+#include "OptionPricer.h"
+#endif
+
+
+class Option
+{
+public:
+
+    enum Input : int { Spot = 0, Strike, Vol, Rate, Time, Yield, INPUTS };
+
+    // in topological order
+    enum Node : int { LogMoneyness = 0, SqrtT, VolSqrtT, Discount, Dividend, D1, D2, Normals, Lattice,
+                      Value, Delta, Gamma, Vega, Theta, Rho, NODES };
+
+    Option( void );
+    explicit Option( const OptionSpec& spec );
+    ~Option() {}
+
+    const OptionSpec&
+    spec( void ) const { return m_spec; }
+
+    // inputs; setting an input to its current value dirties nothing
+    double assetPrice( void ) const { return m_spec.assetPrice; }
+    void assetPrice( double s ) { set( Spot, m_spec.assetPrice, s ); }
+
+    double strike( void ) const { return m_spec.strike; }
+    void strike( double k ) { set( Strike, m_spec.strike, k ); }
+
+    double vol( void ) const { return m_spec.vol; }
+    void vol( double v ) { set( Vol, m_spec.vol, v ); }
+
+    double rate( void ) const { return m_spec.rate; }
+    void rate( double r ) { set( Rate, m_spec.rate, r ); }
+
+    double T( void ) const { return m_spec.T; }
+    void T( double t ) { set( Time, m_spec.T, t ); }
+
+    double yield( void ) const { return m_spec.yield; }
+    void yield( double q ) { set( Yield, m_spec.yield, q ); }
+
+    // outputs, recomputed on demand
+    double value( void ) { return get( Value ); }
+    double delta( void ) { return get( Delta ); }
+    double gamma( void ) { return get( Gamma ); }
+    double vega( void ) { return get( Vega ); }    // per unit of vol
+    double theta( void ) { return get( Theta ); }
+    double rho( void ) { return get( Rho ); }      // per unit of rate
+
+    double d1( void ) { get( D1 ); return m_d1; }  // closed form models only
+    double d2( void ) { get( D2 ); return m_d2; }
+
+    bool
+    closedForm( void ) const { return m_spec.model != OptionModel::BinomialTree; }
+
+    bool
+    dirty( Node n ) const { return (m_dirty >> n) & 1u; }
+
+    long // nodes computed since construction
+    computed( void ) const { return m_computed; }
+
+private:
+
+    friend class OptionBook;
+
+    void
+    set( Input input, double& field, double x );
+
+    double
+    get( Node n );
+
+    void
+    compute( Node n );
+
+    // for OptionBook's batched values
+    void
+    store( Node n, double x ) { m_out[n - Value] = x; m_dirty &= ~(1u << n); }
+
+    OptionSpec m_spec;
+    std::uint32_t m_dirty;
+    long m_computed;
+
+    double m_logMoneyness;
+    double m_sqrtT;
+    double m_volSqrtT;
+    double m_discount;
+    double m_dividend;
+    double m_d1;
+    double m_d2;
+    double m_nd1, m_nd2, m_pdf;   // N(d1), N(d2) (of -d1, -d2 for a put) and the density at d1
+    double m_out[NODES - Value];  // value, delta, gamma, vega, theta, rho
+};
+
+
+class OptionBook
+{
+public:
+
+    explicit OptionBook( double rate = 0.0 );
+    ~OptionBook() {}
+
+    int // returns the underlying's id
+    addUnderlying( double price, double yield = 0.0 );
+
+    int // returns a handle; the option's assetPrice, yield and rate are taken from the book
+    addOption( int underlying, const OptionSpec& spec );
+
+    void
+    underlyingPrice( int underlying, double price );
+
+    double
+    underlyingPrice( int underlying ) const { return m_spot[underlying]; }
+
+    void
+    underlyingYield( int underlying, double yield );
+
+    double
+    underlyingYield( int underlying ) const { return m_yield[underlying]; }
+
+    void
+    rate( double r );
+
+    double
+    rate( void ) const { return m_rate; }
+
+    void
+    vol( int handle, double v );
+
+    // moves every option's time to maturity on by years
+    void
+    elapse( double years );
+
+    Option&
+    option( int handle ) { return m_options[handle]; }
+
+    const Option&
+    option( int handle ) const { return m_options[handle]; }
+
+    int
+    size( void ) const { return (int) m_options.size(); }
+
+    int // options with an input change since their value was last brought up to date
+    stale( void ) const { return (int) m_stale.size(); }
+
+    // values[h] for every handle; values.size() must be at least size()
+    void
+    values( std::span<double> values );
+
+    int
+    batchSize( void ) const { return m_batchSize; }
+
+    void
+    batchSize( int n ) { m_batchSize = (n > 1) ? n : 1; }
+
+private:
+
+    void
+    touch( int handle );
+
+    void
+    refresh( void );
+
+    double m_rate;
+    std::vector<double> m_spot;
+    std::vector<double> m_yield;
+    std::vector<std::vector<int>> m_members;   // handles per underlying
+    std::vector<Option> m_options;
+    std::vector<int> m_underlying;             // per handle
+    std::vector<char> m_queued;                // per handle, on m_stale
+    std::vector<int> m_stale;
+    int m_batchSize;
+
+    // gathered columns for the batched closed form values
+    std::vector<int> m_batch;
+    std::vector<double> m_K, m_S, m_vol, m_r, m_T, m_q, m_value;
+    std::vector<unsigned char> m_call;
+};
+
+
+#endif
+
+///
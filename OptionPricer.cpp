@@ -0,0 +1,126 @@
+/* Option Pricer 18/10/2026
+
+ $$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$
+ $   OptionPricer.cpp - code   $
+ $$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$
+
+ by W.B. Yates
+ Copyright (c) W.B. Yates. All rights reserved.
+ History:
+
+ */
+
+#ifndef __OPTIONPRICER_H__
+#include "OptionPricer.h"
+#endif
+
+
+double
+OptionPricer::value( const OptionSpec& o )
+{
+    switch (o.model)
+    {
+        case OptionModel::BlackScholes:
+            return m_bs.value( o.strike, o.assetPrice, o.vol, o.rate, o.T, o.yield, o.call );
+        case OptionModel::Black:
+            return m_black.value( o.strike, o.assetPrice, o.vol, o.rate, o.T, o.call );
+        case OptionModel::BinomialTree:
+            steps( o );
+            return m_bt.value( o.strike, o.assetPrice, o.vol, o.rate, o.T, o.yield, o.call );
+    }
+    return 0.0;
+}
+
+double
+OptionPricer::delta( const OptionSpec& o )
+{
+    switch (o.model)
+    {
+        case OptionModel::BlackScholes:
+            return m_bs.delta( o.strike, o.assetPrice, o.vol, o.rate, o.T, o.yield, o.call );
+        case OptionModel::Black:
+            return m_black.delta( o.strike, o.assetPrice, o.vol, o.rate, o.T, o.call );
+        case OptionModel::BinomialTree:
+            steps( o );
+            return m_bt.delta( o.strike, o.assetPrice, o.vol, o.rate, o.T, o.yield, o.call );
+    }
+    return 0.0;
+}
+
+double
+OptionPricer::gamma( const OptionSpec& o )
+{
+    switch (o.model)
+    {
+        case OptionModel::BlackScholes:
+            return m_bs.gamma( o.strike, o.assetPrice, o.vol, o.rate, o.T, o.yield );
+        case OptionModel::Black:
+            return m_black.gamma( o.strike, o.assetPrice, o.vol, o.rate, o.T );
+        case OptionModel::BinomialTree:
+            steps( o );
+            return m_bt.gamma( o.strike, o.assetPrice, o.vol, o.rate, o.T, o.yield, o.call );
+    }
+    return 0.0;
+}
+
+double
+OptionPricer::vega( const OptionSpec& o )
+{
+    switch (o.model)
+    {
+        case OptionModel::BlackScholes:
+            return m_bs.vega( o.strike, o.assetPrice, o.vol, o.rate, o.T, o.yield );
+        case OptionModel::Black:
+            return m_black.vega( o.strike, o.assetPrice, o.vol, o.rate, o.T );
+        case OptionModel::BinomialTree:
+        {
+            // central difference; BinomialTree::vega is scaled per vol point
+            double deltaV = 0.0001;
+            steps( o );
+            double f0 = m_bt.value( o.strike, o.assetPrice, o.vol - deltaV, o.rate, o.T, o.yield, o.call );
+            double f1 = m_bt.value( o.strike, o.assetPrice, o.vol + deltaV, o.rate, o.T, o.yield, o.call );
+            return (f1 - f0) / (2.0 * deltaV);
+        }
+    }
+    return 0.0;
+}
+
+double
+OptionPricer::theta( const OptionSpec& o )
+{
+    switch (o.model)
+    {
+        case OptionModel::BlackScholes:
+            return m_bs.theta( o.strike, o.assetPrice, o.vol, o.rate, o.T, o.yield, o.call );
+        case OptionModel::Black:
+            return m_black.theta( o.strike, o.assetPrice, o.vol, o.rate, o.T, o.call );
+        case OptionModel::BinomialTree:
+            steps( o );
+            return m_bt.theta( o.strike, o.assetPrice, o.vol, o.rate, o.T, o.yield, o.call );
+    }
+    return 0.0;
+}
+
+double
+OptionPricer::rho( const OptionSpec& o )
+{
+    switch (o.model)
+    {
+        case OptionModel::BlackScholes:
+            return m_bs.rho( o.strike, o.assetPrice, o.vol, o.rate, o.T, o.yield, o.call );
+        case OptionModel::Black:
+            return m_black.rho( o.strike, o.assetPrice, o.vol, o.rate, o.T, o.call );
+        case OptionModel::BinomialTree:
+        {
+            // central difference; BinomialTree::rho is scaled per rate point
+            double deltaR = 0.0001;
+            steps( o );
+            double f0 = m_bt.value( o.strike, o.assetPrice, o.vol, o.rate - deltaR, o.T, o.yield, o.call );
+            double f1 = m_bt.value( o.strike, o.assetPrice, o.vol, o.rate + deltaR, o.T, o.yield, o.call );
+            return (f1 - f0) / (2.0 * deltaR);
+        }
+    }
+    return 0.0;
+}
+
+//
@@ -0,0 +1,128 @@
+/* Option Pricer 18/10/2026
+
+ $$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$
+ $   OptionPricer.h - header   $
+ $$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$
+
+ Copyright (C) 2026  W.B. Yates
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see http://www.gnu.org/licenses/
+
+ History:
+
+ A single description of an option (OptionSpec) that can be priced by any of the three models,
+ and a small pricer that holds one instance of each model and dispatches on OptionSpec::model.
+
+ BinomialTree keeps its lattice as mutable workspace, so an OptionPricer must not be shared
+ between threads; use one per thread.
+
+ For the Black model assetPrice is the forward price and yield is ignored.
+
+ Examples
+
+    OptionPricer pricer;
+    OptionSpec o;
+
+    // for these params option price is 4.49 (see Hull, Example 17.1, page 394)
+    o.model = OptionModel::BinomialTree;
+    o.strike = 50;
+    o.assetPrice = 50;
+    o.vol = 0.4;
+    o.rate = 0.1;
+    o.T = 0.4167;
+    o.timeSteps = 5;
+    std::cout << "value is " << pricer.value(o) << std::endl;
+ */
+
+
+#ifndef __OPTIONPRICER_H__
+#define __OPTIONPRICER_H__
+
+
+#ifndef __BLACKSCHOLES_H__
+#include "BlackScholes.h"
+#endif
+
+#ifndef __BLACK_H__
+#include "Black.h"
+#endif
+
+#ifndef __BINOMIALTREE_H__
+#include "BinomialTree.h"
+#endif
+
+
+enum class OptionModel : int { BlackScholes = 0, Black = 1, BinomialTree = 2 };
+
+struct OptionSpec
+{
+    OptionModel model = OptionModel::BlackScholes;
+    bool   call = true;
+    double strike = 0.0;      // option strike
+    double assetPrice = 0.0;  // underlying asset's current value (forward value for Black)
+    double vol = 0.0;         // volatility
+    double rate = 0.0;        // risk free rate of interest
+    double T = 0.0;           // time to maturity (year fraction)
+    double yield = 0.0;       // annualised yield of underlying asset (continuous compounded); ignored by Black
+    int    timeSteps = 0;     // BinomialTree only; 0 means use the tree's current setting
+};
+
+
+class OptionPricer
+{
+public:
+
+    OptionPricer() {}
+    ~OptionPricer() {}
+
+    double
+    value( const OptionSpec& o );
+
+    double // rate of change of option price with respect to price of underlying asset
+    delta( const OptionSpec& o );
+
+    double // rate of change of delta
+    gamma( const OptionSpec& o );
+
+    double // rate of change of option price with respect to volatility (per unit of vol)
+    vega( const OptionSpec& o );
+
+    double // rate of change of option price with respect to time
+    theta( const OptionSpec& o );
+
+    double // rate of change of option price with respect to risk free interest rate (per unit of rate)
+    rho( const OptionSpec& o );
+
+    BlackScholes& blackScholes( void ) { return m_bs; }
+    Black& black( void ) { return m_black; }
+    BinomialTree& binomialTree( void ) { return m_bt; }
+
+private:
+
+    void
+    steps( const OptionSpec& o )
+    {
+        if (o.timeSteps > 0 && o.timeSteps != m_bt.timeSteps())
+            m_bt.timeSteps( o.timeSteps );
+    }
+
+    BlackScholes m_bs;
+    Black m_black;
+    BinomialTree m_bt;
+};
+
+
+#endif
+
+///
@@ -0,0 +1,158 @@
+/* Option Record Format 18/10/2026
+
+ $$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$
+ $   OptionRecord.cpp - code   $
+ $$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$
+
+ by W.B. Yates
+ Copyright (c) W.B. Yates. All rights reserved.
+ History:
+
+ */
+
+#include <math.h>
+#include <string.h>
+
+#ifndef __OPTIONRECORD_H__
+#include "OptionRecord.h"
+#endif
+
+
+namespace {
+
+RecordHeader*
+check( const void* block, size_t size, uint32_t magic, size_t columnBytes )
+{
+    if (!block || size < sizeof(RecordHeader))
+        return nullptr;
+
+    RecordHeader* h = (RecordHeader*) block;
+    if (h->magic != magic || h->version != RECORD_VERSION || h->headerSize != sizeof(RecordHeader))
+        return nullptr;
+    if (h->stride < h->count || (h->stride & 7u) != 0)
+        return nullptr;
+    if (h->bytes != sizeof(RecordHeader) + (uint64_t) h->stride * columnBytes || h->bytes > size)
+        return nullptr;
+    return h;
+}
+
+RecordHeader*
+header( void* buf, size_t size, uint32_t magic, uint32_t count, size_t columnBytes )
+{
+    uint32_t stride = OptionColumns::stride( count );
+    size_t bytes = sizeof(RecordHeader) + (size_t) stride * columnBytes;
+    if (!buf || size < bytes || stride < count)
+        return nullptr;
+
+    memset( buf, 0, bytes );
+    RecordHeader* h = (RecordHeader*) buf;
+    h->magic = magic;
+    h->version = RECORD_VERSION;
+    h->headerSize = sizeof(RecordHeader);
+    h->count = count;
+    h->stride = stride;
+    h->bytes = bytes;
+    return h;
+}
+
+}
+
+
+OptionColumns::OptionColumns( const void* block, size_t size ): m_header(nullptr), m_base(nullptr)
+{
+    m_header = check( block, size, OPTION_BLOCK_MAGIC, COLUMN_BYTES );
+    if (m_header)
+        m_base = (char*) m_header + sizeof(RecordHeader);
+}
+
+OptionColumns
+OptionColumns::create( void* buf, size_t size, uint32_t count )
+{
+    OptionColumns c;
+    c.m_header = header( buf, size, OPTION_BLOCK_MAGIC, count, COLUMN_BYTES );
+    if (c.m_header)
+        c.m_base = (char*) c.m_header + sizeof(RecordHeader);
+    return c;
+}
+
+OptionSpec
+OptionColumns::option( uint32_t i ) const
+{
+    OptionSpec o;
+    o.model = (OptionModel) model()[i];
+    o.call = call()[i] != 0;
+    o.strike = strike()[i];
+    o.assetPrice = assetPrice()[i];
+    o.vol = vol()[i];
+    o.rate = rate()[i];
+    o.T = T()[i];
+    o.yield = yield()[i];
+    o.timeSteps = timeSteps()[i];
+    return o;
+}
+
+void
+OptionColumns::option( uint32_t i, const OptionSpec& o, uint8_t g ) const
+{
+    option( i, o, (o.model == OptionModel::BinomialTree) ? OptionStyle::American : OptionStyle::European, g );
+}
+
+void
+OptionColumns::option( uint32_t i, const OptionSpec& o, OptionStyle s, uint8_t g ) const
+{
+    model()[i] = (uint8_t) o.model;
+    call()[i] = (o.call) ? 1 : 0;
+    style()[i] = (uint8_t) s;
+    greeks()[i] = g;
+    strike()[i] = o.strike;
+    assetPrice()[i] = o.assetPrice;
+    vol()[i] = o.vol;
+    rate()[i] = o.rate;
+    T()[i] = o.T;
+    yield()[i] = o.yield;
+    timeSteps()[i] = o.timeSteps;
+}
+
+ResultColumns::ResultColumns( const void* block, size_t size ): m_header(nullptr), m_base(nullptr)
+{
+    m_header = check( block, size, RESULT_BLOCK_MAGIC, COLUMN_BYTES );
+    if (m_header)
+        m_base = (char*) m_header + sizeof(RecordHeader);
+}
+
+ResultColumns
+ResultColumns::create( void* buf, size_t size, uint32_t count )
+{
+    ResultColumns c;
+    c.m_header = header( buf, size, RESULT_BLOCK_MAGIC, count, COLUMN_BYTES );
+    if (!c.m_header)
+        return c;
+
+    c.m_base = (char*) c.m_header + sizeof(RecordHeader);
+    for (int k = 0; k < 6; ++k)
+    {
+        double* v = c.column( k );
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            v[i] = NAN;
+        }
+    }
+    memset( c.status(), (int) RecordStatus::Invalid, count );
+    return c;
+}
+
+void
+ResultColumns::copy( const ResultColumns& src, uint32_t from, uint32_t to, uint32_t n ) const
+{
+    if (!valid() || !src.valid() || from + n > src.count() || to + n > count())
+        return;
+
+    for (int k = 0; k < 6; ++k)
+    {
+        memcpy( column( k ) + to, src.column( k ) + from, n * sizeof(double) );
+    }
+    memcpy( greeks() + to, src.greeks() + from, n );
+    memcpy( status() + to, src.status() + from, n );
+}
+
+//
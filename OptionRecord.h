@@ -0,0 +1,218 @@
+/* Option Record Format 18/10/2026
+
+ $$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$
+ $   OptionRecord.h - header   $
+ $$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$
+
+ Copyright (C) 2026  W.B. Yates
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see http://www.gnu.org/licenses/
+
+ History:
+
+ A fixed layout, versioned, little-endian block format for batches of option inputs and results,
+ used in place from a file mapping, shared memory or a socket buffer.
+
+ A block is a 64 byte RecordHeader followed by one column per field (structure of arrays). Every column
+ holds stride() elements, stride() being count() rounded up to a multiple of 8, so when the block starts
+ on a 64 byte boundary every double column does too and can be passed straight to BatchKernels.
+
+    options:  strike, assetPrice, vol, rate, yield, T   (double; assetPrice is the forward for Black)
+              timeSteps                                 (int32; BinomialTree only, 0 for the default)
+              model, call, style, greeks                (uint8; OptionModel, 1 call / 0 put,
+                                                         OptionStyle, requested GREEK_ bits)
+    results:  value, delta, gamma, vega, theta, rho     (double)
+              greeks, status                            (uint8; GREEK_ bits present, RecordStatus)
+
+ OptionColumns and ResultColumns are views: they check the header and size once, then every accessor
+ is a pointer into the buffer. The views are only as writable as the memory behind them.
+
+ Examples
+
+    std::vector<char> buf( OptionColumns::bytes( n ) );
+    OptionColumns in = OptionColumns::create( buf.data(), buf.size(), n );
+    for (uint32_t i = 0; i < n; ++i)
+        in.option( i, specs[i] );
+    ...
+    OptionColumns view( mapped, mappedSize );       // e.g. a memory mapped file
+    if (view.valid())
+        BatchKernels::blackScholes( view.count(), view.strike(), view.assetPrice(), ... );
+ */
+
+
+#ifndef __OPTIONRECORD_H__
+#define __OPTIONRECORD_H__
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+
+#ifndef __OPTIONPRICER_H__
+#include "OptionPricer.h"
+#endif
+
+static_assert( std::endian::native == std::endian::little, "option record blocks are little-endian and used in place" );
+
+
+const uint32_t OPTION_BLOCK_MAGIC = 0x424f504f; // "OPOB"
+const uint32_t RESULT_BLOCK_MAGIC = 0x4252504f; // "OPRB"
+const uint16_t RECORD_VERSION     = 1;
+
+enum class OptionStyle : uint8_t { European = 0, American = 1 };
+
+enum class RecordStatus : uint8_t { Ok = 0, Invalid = 1, Unsupported = 2 };
+
+const uint8_t GREEK_DELTA = 1;
+const uint8_t GREEK_GAMMA = 2;
+const uint8_t GREEK_VEGA  = 4;
+const uint8_t GREEK_THETA = 8;
+const uint8_t GREEK_RHO   = 16;
+const uint8_t GREEK_ALL   = 31;
+
+
+struct RecordHeader
+{
+    uint32_t magic;
+    uint16_t version;
+    uint16_t headerSize;  // 64
+    uint32_t count;       // records
+    uint32_t stride;      // elements per column
+    uint64_t bytes;       // whole block, header included
+    uint8_t  reserved[40];
+};
+
+static_assert( sizeof(RecordHeader) == 64, "RecordHeader must be 64 bytes" );
+
+
+class OptionColumns
+{
+public:
+
+    OptionColumns( void ): m_header(nullptr), m_base(nullptr) {}
+
+    // view an existing block; valid() is false if the header or size do not match
+    OptionColumns( const void* block, size_t size );
+
+    // write an empty block of count options into buf; the view is invalid if buf is too small
+    static OptionColumns
+    create( void* buf, size_t size, uint32_t count );
+
+    static size_t
+    bytes( uint32_t count ) { return sizeof(RecordHeader) + (size_t) stride( count ) * COLUMN_BYTES; }
+
+    static uint32_t
+    stride( uint32_t count ) { return (count + 7u) & ~7u; }
+
+    bool
+    valid( void ) const { return m_header != nullptr; }
+
+    uint32_t
+    count( void ) const { return (m_header) ? m_header->count : 0; }
+
+    size_t
+    size( void ) const { return (m_header) ? (size_t) m_header->bytes : 0; }
+
+    const void* // the block, header included
+    data( void ) const { return m_header; }
+
+    double* strike( void ) const      { return column<double>( 0 ); }
+    double* assetPrice( void ) const  { return column<double>( 1 ); }
+    double* vol( void ) const         { return column<double>( 2 ); }
+    double* rate( void ) const        { return column<double>( 3 ); }
+    double* yield( void ) const       { return column<double>( 4 ); }
+    double* T( void ) const           { return column<double>( 5 ); }
+    int32_t* timeSteps( void ) const  { return (int32_t*) (m_base + 6 * 8 * (size_t) m_header->stride); }
+    uint8_t* model( void ) const      { return bytesColumn( 0 ); }
+    uint8_t* call( void ) const       { return bytesColumn( 1 ); }
+    uint8_t* style( void ) const      { return bytesColumn( 2 ); }
+    uint8_t* greeks( void ) const     { return bytesColumn( 3 ); }
+
+    OptionSpec
+    option( uint32_t i ) const;
+
+    // style defaults to the model's own: American for BinomialTree, European otherwise
+    void
+    option( uint32_t i, const OptionSpec& o, uint8_t greeks = 0 ) const;
+
+    void
+    option( uint32_t i, const OptionSpec& o, OptionStyle style, uint8_t greeks ) const;
+
+private:
+
+    static const size_t COLUMN_BYTES = 6 * 8 + 4 + 4;
+
+    template <typename T>
+    T* column( int c ) const { return (T*) (m_base + c * sizeof(T) * (size_t) m_header->stride); }
+
+    uint8_t* bytesColumn( int c ) const { return (uint8_t*) (m_base + (6 * 8 + 4 + c) * (size_t) m_header->stride); }
+
+    RecordHeader* m_header;
+    char* m_base;
+};
+
+
+class ResultColumns
+{
+public:
+
+    ResultColumns( void ): m_header(nullptr), m_base(nullptr) {}
+
+    ResultColumns( const void* block, size_t size );
+
+    // write a block of count results, all values NaN and status Invalid
+    static ResultColumns
+    create( void* buf, size_t size, uint32_t count );
+
+    static size_t
+    bytes( uint32_t count ) { return sizeof(RecordHeader) + (size_t) OptionColumns::stride( count ) * COLUMN_BYTES; }
+
+    bool
+    valid( void ) const { return m_header != nullptr; }
+
+    uint32_t
+    count( void ) const { return (m_header) ? m_header->count : 0; }
+
+    size_t
+    size( void ) const { return (m_header) ? (size_t) m_header->bytes : 0; }
+
+    const void* // the block, header included
+    data( void ) const { return m_header; }
+
+    double* value( void ) const   { return column( 0 ); }
+    double* delta( void ) const   { return column( 1 ); }
+    double* gamma( void ) const   { return column( 2 ); }
+    double* vega( void ) const    { return column( 3 ); }
+    double* theta( void ) const   { return column( 4 ); }
+    double* rho( void ) const     { return column( 5 ); }
+    uint8_t* greeks( void ) const { return (uint8_t*) (m_base + 6 * 8 * (size_t) m_header->stride); }
+    uint8_t* status( void ) const { return greeks() + m_header->stride; }
+
+    // copy n results starting at from into this block starting at to
+    void
+    copy( const ResultColumns& src, uint32_t from, uint32_t to, uint32_t n ) const;
+
+private:
+
+    static const size_t COLUMN_BYTES = 6 * 8 + 2;
+
+    double* column( int c ) const { return (double*) (m_base + c * 8 * (size_t) m_header->stride); }
+
+    RecordHeader* m_header;
+    char* m_base;
+};
+
+
+#endif
+
+///
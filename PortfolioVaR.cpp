@@ -0,0 +1,306 @@
+/* Portfolio Revaluation VaR 18/10/2026
+
+ $$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$
+ $   PortfolioVaR.cpp - code   $
+ $$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$
+
+ by W.B. Yates
+ Copyright (c) W.B. Yates. All rights reserved.
+ History:
+
+ */
+
+#include <math.h>
+#include <algorithm>
+
+#ifndef __PORTFOLIOVAR_H__
+#include "PortfolioVaR.h"
+#endif
+
+#ifndef __BATCHKERNELS_H__
+#include "BatchKernels.h"
+#endif
+
+
+PortfolioVaR::PortfolioVaR( int threads ): m_pool(threads),
+                                           m_pricers(),
+                                           m_positions(),
+                                           m_base(),
+                                           m_scenarios(),
+                                           m_blockPnl(),
+                                           m_pnl(),
+                                           m_sorted(),
+                                           m_fullCount(),
+                                           m_floatWork(),
+                                           m_threshold(0.0),
+                                           m_tileScenarios(256),
+                                           m_tilePositions(16),
+                                           m_full(0),
+                                           m_screened(0),
+                                           m_single(false)
+{
+    m_pricers.resize( m_pool.threads() );
+    m_floatWork.resize( m_pool.threads() );
+}
+
+const std::vector<double>&
+PortfolioVaR::revalue( void )
+{
+    int nPos  = (int) m_positions.size();
+    int nScen = m_scenarios.rows();
+
+    m_pnl.assign( nScen, 0.0 );
+    m_sorted.clear();
+    m_full = 0;
+    m_screened = 0;
+    if (nPos == 0 || nScen == 0)
+        return m_pnl;
+
+    // base values and the sensitivities used by the screen
+    m_base.resize( nPos );
+    bool screen = m_threshold > 0.0;
+    m_pool.run( nPos, [&]( int i, int w )
+    {
+        OptionPricer& pricer = m_pricers[w];
+        const OptionSpec& o = m_positions[i].option;
+        Sensitivity& s = m_base[i];
+        s.value = pricer.value( o );
+        s.floatValue = s.value;
+        if (m_single)
+        {
+            FloatWork& fw = m_floatWork[w];
+            fw.clear();
+            push( fw, o, 0 );
+            floatValues( o, fw, w );
+            s.floatValue = fw.value[0];
+        }
+        s.delta = (screen) ? pricer.delta( o ) : 0.0;
+        s.gamma = (screen) ? pricer.gamma( o ) : 0.0;
+        s.vega  = (screen) ? pricer.vega( o ) : 0.0;
+    });
+
+    int ts = std::max( 1, m_tileScenarios );
+    int tp = std::max( 1, m_tilePositions );
+    int scenBlocks = (nScen + ts - 1) / ts;
+    int posBlocks  = (nPos + tp - 1) / tp;
+    int tiles = scenBlocks * posBlocks;
+
+    m_blockPnl.resize( posBlocks, nScen, 0.0 );
+    m_fullCount.assign( tiles, 0 );
+
+    m_pool.run( tiles, [this]( int tile, int worker ) { revalueTile( tile, worker ); } );
+
+    // reduce position blocks in a fixed order so the result is independent of scheduling
+    for (int b = 0; b < posBlocks; ++b)
+    {
+        for (int s = 0; s < nScen; ++s)
+        {
+            m_pnl[s] += m_blockPnl[b][s];
+        }
+    }
+
+    for (int t = 0; t < tiles; ++t)
+    {
+        m_full += m_fullCount[t];
+    }
+    m_screened = (long) nPos * nScen - m_full;
+
+    m_sorted = m_pnl;
+    std::sort( m_sorted.begin(), m_sorted.end() );
+    return m_pnl;
+}
+
+void
+PortfolioVaR::revalueTile( int tile, int worker )
+{
+    int nPos  = (int) m_positions.size();
+    int nScen = m_scenarios.rows();
+    int ts = std::max( 1, m_tileScenarios );
+    int tp = std::max( 1, m_tilePositions );
+    int scenBlocks = (nScen + ts - 1) / ts;
+
+    // consecutive tiles walk down the scenarios of one position block,
+    // so a worker's deque keeps reusing the same positions
+    int pb = tile / scenBlocks;
+    int sb = tile % scenBlocks;
+    int s0 = sb * ts, s1 = std::min( nScen, s0 + ts );
+    int p0 = pb * tp, p1 = std::min( nPos, p0 + tp );
+
+    OptionPricer& pricer = m_pricers[worker];
+    Matrix<double>::Row out = m_blockPnl[pb];
+    long full = 0;
+
+    for (int s = s0; s < s1; ++s)
+    {
+        out[s] = 0.0;
+    }
+
+    FloatWork& fw = m_floatWork[worker];
+
+    for (int p = p0; p < p1; ++p)
+    {
+        const Position& pos = m_positions[p];
+        const Sensitivity& base = m_base[p];
+        OptionSpec o = pos.option;
+        fw.clear();
+
+        for (int s = s0; s < s1; ++s)
+        {
+            double dS, dV, dR;
+            moves( pos, s, dS, dV, dR );
+
+            if (m_threshold > 0.0 && dR == 0.0)
+            {
+                double estimate = pos.quantity * ((base.delta * dS) + (0.5 * base.gamma * dS * dS) + (base.vega * dV));
+                if (fabs(estimate) < m_threshold)
+                {
+                    out[s] += estimate;
+                    continue;
+                }
+            }
+
+            o.assetPrice = pos.option.assetPrice + dS;
+            o.vol = pos.option.vol + dV;
+            o.rate = pos.option.rate + dR;
+            ++full;
+
+            if (m_single)
+                push( fw, o, s );
+            else out[s] += pos.quantity * (pricer.value( o ) - base.value);
+        }
+
+        if (!fw.cell.empty())
+        {
+            floatValues( pos.option, fw, worker );
+            for (size_t k = 0; k < fw.cell.size(); ++k)
+            {
+                out[fw.cell[k]] += pos.quantity * ((double) fw.value[k] - base.floatValue);
+            }
+        }
+    }
+
+    m_fullCount[tile] = full;
+}
+
+void
+PortfolioVaR::moves( const Position& pos, int scenario, double& dS, double& dV, double& dR ) const
+{
+    Matrix<double>::ConstRow x = m_scenarios[scenario];
+    dS = (pos.spotFactor >= 0) ? pos.option.assetPrice * x[pos.spotFactor] : 0.0;
+    dV = (pos.volFactor >= 0) ? x[pos.volFactor] : 0.0;
+    dR = (pos.rateFactor >= 0) ? x[pos.rateFactor] : 0.0;
+}
+
+void
+PortfolioVaR::push( FloatWork& w, const OptionSpec& o, int cell ) const
+{
+    w.cell.push_back( cell );
+    w.strike.push_back( (float) o.strike );
+    w.assetPrice.push_back( (float) o.assetPrice );
+    w.vol.push_back( (float) o.vol );
+    w.rate.push_back( (float) o.rate );
+    w.T.push_back( (float) o.T );
+    w.yield.push_back( (float) o.yield );
+    w.call.push_back( (o.call) ? 1 : 0 );
+}
+
+void
+PortfolioVaR::floatValues( const OptionSpec& o, FloatWork& w, int worker )
+{
+    int n = (int) w.cell.size();
+    w.value.resize( n );
+
+    if (o.model == OptionModel::BlackScholes)
+    {
+        BatchKernels::blackScholes( n, w.strike.data(), w.assetPrice.data(), w.vol.data(), w.rate.data(), w.T.data(), w.yield.data(), w.call.data(), w.value.data() );
+    }
+    else if (o.model == OptionModel::Black)
+    {
+        BatchKernels::black( n, w.strike.data(), w.assetPrice.data(), w.vol.data(), w.rate.data(), w.T.data(), w.call.data(), w.value.data() );
+    }
+    else
+    {
+        int steps = (o.timeSteps > 0) ? o.timeSteps : m_pricers[worker].binomialTree().timeSteps();
+        w.lattice.resize( 2 * (steps + 1) );
+        for (int i = 0; i < n; ++i)
+        {
+            w.value[i] = BatchKernels::binomialTree( w.strike[i], w.assetPrice[i], w.vol[i], w.rate[i], w.T[i], w.yield[i], w.call[i] != 0, steps, w.lattice.data() );
+        }
+    }
+}
+
+PrecisionReport
+PortfolioVaR::precisionCheck( int samples )
+{
+    PrecisionReport r;
+    long nPos  = (long) m_positions.size();
+    long nScen = m_scenarios.rows();
+    long cells = nPos * nScen;
+    if (cells == 0 || samples <= 0)
+        return r;
+
+    OptionPricer& pricer = m_pricers[0];
+    FloatWork& fw = m_floatWork[0];
+    long n = std::min( (long) samples, cells );
+
+    for (long k = 0; k < n; ++k)
+    {
+        long c = (n > 1) ? k * (cells - 1) / (n - 1) : 0;
+        const Position& pos = m_positions[c / nScen];
+
+        double dS, dV, dR;
+        moves( pos, (int) (c % nScen), dS, dV, dR );
+        OptionSpec o = pos.option;
+        o.assetPrice += dS;
+        o.vol += dV;
+        o.rate += dR;
+
+        // base and shocked values in each precision
+        fw.clear();
+        push( fw, pos.option, 0 );
+        push( fw, o, 1 );
+        floatValues( pos.option, fw, 0 );
+
+        double base = pricer.value( pos.option );
+        double value = pricer.value( o );
+        double error = pos.quantity * (((double) fw.value[1] - (double) fw.value[0]) - (value - base));
+
+        r.maxError = std::max( r.maxError, fabs( error ) );
+        r.maxRelError = std::max( r.maxRelError, fabs( (double) fw.value[1] - value ) / std::max( fabs( value ), 1E-6 * o.strike ) );
+        ++r.samples;
+    }
+    return r;
+}
+
+int
+PortfolioVaR::tailIndex( double confidence ) const
+{
+    int n = (int) m_sorted.size();
+    int k = (int) floor( (1.0 - confidence) * n );
+    return std::max( 0, std::min( n - 1, k ) );
+}
+
+double
+PortfolioVaR::VaR( double confidence ) const
+{
+    if (m_sorted.empty())
+        return 0.0;
+    return -m_sorted[tailIndex( confidence )];
+}
+
+double
+PortfolioVaR::expectedShortfall( double confidence ) const
+{
+    if (m_sorted.empty())
+        return 0.0;
+
+    int k = tailIndex( confidence );
+    double sum = 0.0;
+    for (int i = 0; i <= k; ++i)
+    {
+        sum += m_sorted[i];
+    }
+    return -sum / double(k + 1);
+}
+
+//
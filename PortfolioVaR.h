@@ -0,0 +1,217 @@
+/* Portfolio Revaluation VaR 18/10/2026
+
+ $$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$
+ $   PortfolioVaR.h - header   $
+ $$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$
+
+ Copyright (C) 2026  W.B. Yates
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see http://www.gnu.org/licenses/
+
+ History:
+
+ Full revaluation historical / Monte Carlo VaR and expected shortfall for a portfolio of options
+ priced with BlackScholes, Black or BinomialTree.
+
+ Scenarios are held in a matrix, one row per scenario and one column per risk factor.
+ Each position names the factor columns that move it:
+
+    spotFactor - relative move in the underlying, S' = S * (1 + x)
+    volFactor  - absolute move in volatility,     v' = v + x
+    rateFactor - absolute move in the rate,       r' = r + x
+
+ A factor index of -1 means the position does not depend on that factor.
+
+ The (scenario x position) grid is cut into tiles which are revalued on a work stealing TaskPool.
+ Each tile writes into its own slice of a per position block P&L buffer, and the blocks are summed
+ in a fixed order, so results do not depend on the number of threads.
+
+ Before revaluing a cell the delta-gamma-vega estimate of its P&L is computed; if its absolute value is
+ below screenThreshold() the estimate is used in place of a full revaluation. Cells with a rate move
+ are always fully revalued. A threshold of 0 (the default) disables the screen.
+
+ With singlePrecision(true) the full revaluations of a tile are gathered per position and priced in
+ float with BatchKernels (and its float lattice for trees), against a base value priced the same way;
+ each cell's P&L and all the aggregates are still accumulated in double. precisionCheck() reprices a
+ sample of cells both ways and reports the largest difference.
+
+ Examples
+
+    PortfolioVaR var;
+    var.positions( book );           // std::vector<Position>
+    var.scenarios( history );        // Matrix<double>, rows are scenarios
+    var.screenThreshold( 1.0 );      // skip cells whose estimated P&L is under 1.0
+    var.revalue();
+    std::cout << "99% VaR is " << var.VaR(0.99) << " ES is " << var.expectedShortfall(0.99) << std::endl;
+
+    var.singlePrecision( true );
+    PrecisionReport r = var.precisionCheck( 1000 );
+    std::cout << "largest float P&L error " << r.maxError << std::endl;
+ */
+
+
+#ifndef __PORTFOLIOVAR_H__
+#define __PORTFOLIOVAR_H__
+
+#include <vector>
+
+#ifndef __MATRIX_H__
+#include "AMatrix.h"
+#endif
+
+#ifndef __OPTIONPRICER_H__
+#include "OptionPricer.h"
+#endif
+
+#ifndef __TASKPOOL_H__
+#include "TaskPool.h"
+#endif
+
+
+struct Position
+{
+    OptionSpec option;
+    double quantity = 0.0;
+    int spotFactor = -1;  // scenario column holding the relative move in assetPrice
+    int volFactor = -1;   // scenario column holding the absolute move in vol
+    int rateFactor = -1;  // scenario column holding the absolute move in rate
+};
+
+struct PrecisionReport
+{
+    long   samples = 0;       // cells repriced in both precisions
+    double maxError = 0.0;    // largest absolute difference in a cell's P&L (quantity included)
+    double maxRelError = 0.0; // largest relative difference in an option value
+};
+
+
+class PortfolioVaR
+{
+public:
+
+    explicit PortfolioVaR( int threads = 0 ); // 0 uses std::thread::hardware_concurrency()
+    ~PortfolioVaR() {}
+
+    void
+    positions( const std::vector<Position>& p ) { m_positions = p; }
+
+    const std::vector<Position>&
+    positions( void ) const { return m_positions; }
+
+    void
+    scenarios( const Matrix<double>& s ) { m_scenarios = s; }
+
+    const Matrix<double>&
+    scenarios( void ) const { return m_scenarios; }
+
+    // cells whose delta-gamma-vega P&L estimate is below this (in absolute value) are not revalued
+    void
+    screenThreshold( double t ) { m_threshold = t; }
+
+    double
+    screenThreshold( void ) const { return m_threshold; }
+
+    // tile dimensions of the (scenario x position) grid
+    void
+    tileSize( int scenarios, int positions ) { m_tileScenarios = scenarios; m_tilePositions = positions; }
+
+    // revalue in float (cell P&L and aggregates stay double)
+    void
+    singlePrecision( bool on ) { m_single = on; }
+
+    bool
+    singlePrecision( void ) const { return m_single; }
+
+    // reprice up to samples cells, spread evenly over the grid, in float and double; call after positions() and scenarios()
+    PrecisionReport
+    precisionCheck( int samples = 1000 );
+
+    // full revaluation; returns the portfolio P&L for each scenario
+    const std::vector<double>&
+    revalue( void );
+
+    const std::vector<double>&
+    pnl( void ) const { return m_pnl; }
+
+    double // loss not exceeded with the given confidence (e.g. 0.99); reported as a positive number
+    VaR( double confidence ) const;
+
+    double // average loss in the tail beyond VaR(confidence); reported as a positive number
+    expectedShortfall( double confidence ) const;
+
+    long fullRevaluations( void ) const { return m_full; }
+    long screened( void ) const { return m_screened; }
+
+private:
+
+    struct Sensitivity
+    {
+        double value;
+        double floatValue;  // value priced in float, the base for single precision P&L
+        double delta;
+        double gamma;
+        double vega;
+    };
+
+    // per worker inputs for the float kernels
+    struct FloatWork
+    {
+        std::vector<float> strike, assetPrice, vol, rate, T, yield, value, lattice;
+        std::vector<unsigned char> call;
+        std::vector<int> cell;
+
+        void
+        clear( void )
+        {
+            strike.clear(); assetPrice.clear(); vol.clear(); rate.clear(); T.clear(); yield.clear(); call.clear(); cell.clear();
+        }
+    };
+
+    void
+    revalueTile( int tile, int worker );
+
+    void
+    moves( const Position& pos, int scenario, double& dS, double& dV, double& dR ) const;
+
+    void
+    push( FloatWork& w, const OptionSpec& o, int cell ) const;
+
+    void
+    floatValues( const OptionSpec& o, FloatWork& w, int worker );
+
+    int
+    tailIndex( double confidence ) const;
+
+    TaskPool m_pool;
+    std::vector<OptionPricer> m_pricers; // one per worker
+    std::vector<Position> m_positions;
+    std::vector<Sensitivity> m_base;
+    Matrix<double> m_scenarios;
+    Matrix<double> m_blockPnl;          // position block x scenario
+    std::vector<double> m_pnl;
+    std::vector<double> m_sorted;
+    std::vector<long> m_fullCount;       // per tile
+    std::vector<FloatWork> m_floatWork;  // one per worker
+    double m_threshold;
+    int m_tileScenarios;
+    int m_tilePositions;
+    long m_full;
+    long m_screened;
+    bool m_single;
+};
+
+
+#endif
+
+///
@@ -0,0 +1,285 @@
+/* Position Book 18/10/2026
+
+ $$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$
+ $   PositionBook.cpp - code   $
+ $$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$
+
+ by W.B. Yates
+ Copyright (c) W.B. Yates. All rights reserved.
+ History:
+
+ */
+
+#include <algorithm>
+#include <numeric>
+
+#ifndef __POSITIONBOOK_H__
+#include "PositionBook.h"
+#endif
+
+
+namespace {
+
+// four independent partial sums so the compiler can keep them in one SIMD register
+inline double
+dot( const double* a, const double* b, int n )
+{
+    double s0 = 0.0, s1 = 0.0, s2 = 0.0, s3 = 0.0;
+    int i = 0;
+    for (; i + 4 <= n; i += 4)
+    {
+        s0 += a[i] * b[i];
+        s1 += a[i + 1] * b[i + 1];
+        s2 += a[i + 2] * b[i + 2];
+        s3 += a[i + 3] * b[i + 3];
+    }
+    for (; i < n; ++i)
+    {
+        s0 += a[i] * b[i];
+    }
+    return (s0 + s1) + (s2 + s3);
+}
+
+template <class T>
+void
+permute( std::vector<T>& v, const std::vector<int>& order )
+{
+    std::vector<T> tmp(v.size());
+    for (std::size_t i = 0; i < order.size(); ++i)
+    {
+        tmp[i] = v[order[i]];
+    }
+    v.swap( tmp );
+}
+
+}
+
+
+PositionBook::PositionBook( void ): PositionBook( std::vector<double>{ 1.0 / 12.0, 0.25, 0.5, 1.0, 2.0, 5.0 } ) {}
+
+PositionBook::PositionBook( const std::vector<double>& expiryBuckets ): m_pricer(),
+                                                                        m_bounds(expiryBuckets),
+                                                                        m_spot(),
+                                                                        m_aggregates(),
+                                                                        m_rangeBegin(),
+                                                                        m_rangeEnd(),
+                                                                        m_options(),
+                                                                        m_key(),
+                                                                        m_handle(),
+                                                                        m_qty(),
+                                                                        m_value(),
+                                                                        m_delta(),
+                                                                        m_gamma(),
+                                                                        m_vega(),
+                                                                        m_theta(),
+                                                                        m_rho(),
+                                                                        m_slot(),
+                                                                        m_sorted(true) {}
+
+int
+PositionBook::bucket( double T ) const
+{
+    return (int) (std::lower_bound( m_bounds.begin(), m_bounds.end(), T ) - m_bounds.begin());
+}
+
+int
+PositionBook::addUnderlying( double price )
+{
+    m_spot.push_back( price );
+    m_aggregates.resize( m_spot.size() * buckets() );
+    m_rangeBegin.push_back( 0 );
+    m_rangeEnd.push_back( 0 );
+    m_sorted = false;
+    return (int) m_spot.size() - 1;
+}
+
+int
+PositionBook::addPosition( int underlying, const OptionSpec& option, double quantity )
+{
+    int slot = (int) m_qty.size();
+    int handle = (int) m_slot.size();
+
+    m_options.push_back( option );
+    m_options.back().assetPrice = m_spot[underlying];
+    m_key.push_back( underlying * buckets() + bucket( option.T ) );
+    m_handle.push_back( handle );
+    m_qty.push_back( quantity );
+    m_value.push_back( 0.0 );
+    m_delta.push_back( 0.0 );
+    m_gamma.push_back( 0.0 );
+    m_vega.push_back( 0.0 );
+    m_theta.push_back( 0.0 );
+    m_rho.push_back( 0.0 );
+    m_slot.push_back( slot );
+
+    price( slot );
+    add( m_key[slot], slot, quantity );
+    m_sorted = false;
+    return handle;
+}
+
+void
+PositionBook::quantity( int handle, double q )
+{
+    int slot = m_slot[handle];
+    add( m_key[slot], slot, q - m_qty[slot] );
+    m_qty[slot] = q;
+}
+
+void
+PositionBook::underlyingPrice( int underlying, double price )
+{
+    if (!m_sorted)
+        layout();
+
+    m_spot[underlying] = price;
+    for (int slot = m_rangeBegin[underlying]; slot < m_rangeEnd[underlying]; ++slot)
+    {
+        // remove the old contribution, reprice, add the new one
+        add( m_key[slot], slot, -m_qty[slot] );
+        m_options[slot].assetPrice = price;
+        this->price( slot );
+        add( m_key[slot], slot, m_qty[slot] );
+    }
+}
+
+void
+PositionBook::vol( int handle, double v )
+{
+    int slot = m_slot[handle];
+    add( m_key[slot], slot, -m_qty[slot] );
+    m_options[slot].vol = v;
+    price( slot );
+    add( m_key[slot], slot, m_qty[slot] );
+}
+
+void
+PositionBook::rebuild( void )
+{
+    layout();
+
+    int n = positions();
+    for (int slot = 0; slot < n; ++slot)
+    {
+        m_options[slot].assetPrice = m_spot[m_key[slot] / buckets()];
+        price( slot );
+    }
+
+    std::fill( m_aggregates.begin(), m_aggregates.end(), GreekTotals() );
+
+    // each (underlying, bucket) is a contiguous range of slots
+    const double* q = m_qty.data();
+    for (int first = 0; first < n;)
+    {
+        int key = m_key[first];
+        int last = first;
+        while (last < n && m_key[last] == key)
+        {
+            ++last;
+        }
+
+        int len = last - first;
+        GreekTotals& g = m_aggregates[key];
+        g.value = dot( q + first, m_value.data() + first, len );
+        g.delta = dot( q + first, m_delta.data() + first, len );
+        g.gamma = dot( q + first, m_gamma.data() + first, len );
+        g.vega  = dot( q + first, m_vega.data() + first, len );
+        g.theta = dot( q + first, m_theta.data() + first, len );
+        g.rho   = dot( q + first, m_rho.data() + first, len );
+
+        first = last;
+    }
+}
+
+GreekTotals
+PositionBook::total( int underlying ) const
+{
+    GreekTotals t;
+    for (int b = 0; b < buckets(); ++b)
+    {
+        const GreekTotals& g = aggregate( underlying, b );
+        t.value += g.value;
+        t.delta += g.delta;
+        t.gamma += g.gamma;
+        t.vega  += g.vega;
+        t.theta += g.theta;
+        t.rho   += g.rho;
+    }
+    return t;
+}
+
+GreekTotals
+PositionBook::greeks( int handle ) const
+{
+    int slot = m_slot[handle];
+    GreekTotals g;
+    g.value = m_value[slot];
+    g.delta = m_delta[slot];
+    g.gamma = m_gamma[slot];
+    g.vega  = m_vega[slot];
+    g.theta = m_theta[slot];
+    g.rho   = m_rho[slot];
+    return g;
+}
+
+void
+PositionBook::price( int slot )
+{
+    const OptionSpec& o = m_options[slot];
+    m_value[slot] = m_pricer.value( o );
+    m_delta[slot] = m_pricer.delta( o );
+    m_gamma[slot] = m_pricer.gamma( o );
+    m_vega[slot]  = m_pricer.vega( o );
+    m_theta[slot] = m_pricer.theta( o );
+    m_rho[slot]   = m_pricer.rho( o );
+}
+
+void
+PositionBook::add( int key, int slot, double q )
+{
+    GreekTotals& g = m_aggregates[key];
+    g.value += q * m_value[slot];
+    g.delta += q * m_delta[slot];
+    g.gamma += q * m_gamma[slot];
+    g.vega  += q * m_vega[slot];
+    g.theta += q * m_theta[slot];
+    g.rho   += q * m_rho[slot];
+}
+
+void
+PositionBook::layout( void )
+{
+    int n = positions();
+    std::vector<int> order(n);
+    std::iota( order.begin(), order.end(), 0 );
+    std::stable_sort( order.begin(), order.end(), [this]( int a, int b ) { return m_key[a] < m_key[b]; } );
+
+    permute( m_options, order );
+    permute( m_key, order );
+    permute( m_handle, order );
+    permute( m_qty, order );
+    permute( m_value, order );
+    permute( m_delta, order );
+    permute( m_gamma, order );
+    permute( m_vega, order );
+    permute( m_theta, order );
+    permute( m_rho, order );
+
+    for (int slot = 0; slot < n; ++slot)
+    {
+        m_slot[m_handle[slot]] = slot;
+    }
+
+    std::fill( m_rangeBegin.begin(), m_rangeBegin.end(), 0 );
+    std::fill( m_rangeEnd.begin(), m_rangeEnd.end(), 0 );
+    for (int slot = n - 1; slot >= 0; --slot)
+    {
+        int u = m_key[slot] / buckets();
+        if (m_rangeEnd[u] == 0)
+            m_rangeEnd[u] = slot + 1;
+        m_rangeBegin[u] = slot;
+    }
+    m_sorted = true;
+}
+
+//
@@ -0,0 +1,156 @@
+/* Position Book 18/10/2026
+
+ $$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$
+ $   PositionBook.h - header   $
+ $$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$
+
+ Copyright (C) 2026  W.B. Yates
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see http://www.gnu.org/licenses/
+
+ History:
+
+ A book of option positions with quantity weighted Greeks aggregated by underlying and expiry bucket.
+
+ Quantities and per option Greeks are held in structure-of-arrays form, sorted by (underlying, bucket),
+ so every aggregate is a contiguous dot product of quantities and Greeks and the positions of one
+ underlying form a single range. Positions are referred to by the handle returned from addPosition().
+
+ Changing a quantity or an underlying's price updates the aggregates by the difference only;
+ rebuild() re-sums everything (and should be called now and again to remove accumulated rounding).
+
+ Expiry buckets are given as increasing upper bounds in years; an option with T above the last bound
+ falls into an extra final bucket.
+
+ Examples
+
+    PositionBook book;
+    int ibm = book.addUnderlying( 150.0 );
+    int h = book.addPosition( ibm, option, 100 );   // option.assetPrice is taken from the underlying
+    book.underlyingPrice( ibm, 151.0 );               // reprices IBM positions, adjusts IBM aggregates
+    std::cout << "IBM delta " << book.total( ibm ).delta << std::endl;
+ */
+
+
+#ifndef __POSITIONBOOK_H__
+#define __POSITIONBOOK_H__
+
+#include <vector>
+
+#ifndef __OPTIONPRICER_H__
+#include "OptionPricer.h"
+#endif
+
+
+struct GreekTotals
+{
+    double value = 0.0;
+    double delta = 0.0;
+    double gamma = 0.0;
+    double vega = 0.0;
+    double theta = 0.0;
+    double rho = 0.0;
+};
+
+
+class PositionBook
+{
+public:
+
+    PositionBook( void );
+    explicit PositionBook( const std::vector<double>& expiryBuckets );
+    ~PositionBook() {}
+
+    int // returns the underlying's id
+    addUnderlying( double price );
+
+    int // returns a handle for the position; option.assetPrice is replaced by the underlying's price
+    addPosition( int underlying, const OptionSpec& option, double quantity );
+
+    void
+    quantity( int handle, double q );
+
+    double
+    quantity( int handle ) const { return m_qty[m_slot[handle]]; }
+
+    void // reprices all positions on the underlying and applies the change to its aggregates
+    underlyingPrice( int underlying, double price );
+
+    // reprices the position at a new vol (a freshly implied one, say) and applies the change to its aggregates
+    void
+    vol( int handle, double v );
+
+    double
+    vol( int handle ) const { return m_options[m_slot[handle]].vol; }
+
+    double
+    underlyingPrice( int underlying ) const { return m_spot[underlying]; }
+
+    void // reprice every position and re-sum all aggregates
+    rebuild( void );
+
+    const GreekTotals&
+    aggregate( int underlying, int bucket ) const { return m_aggregates[underlying * buckets() + bucket]; }
+
+    GreekTotals
+    total( int underlying ) const;
+
+    GreekTotals // the Greeks of one position (per unit quantity)
+    greeks( int handle ) const;
+
+    int buckets( void ) const { return (int) m_bounds.size() + 1; }
+    int underlyings( void ) const { return (int) m_spot.size(); }
+    int positions( void ) const { return (int) m_qty.size(); }
+
+    int
+    bucket( double T ) const;
+
+private:
+
+    void
+    price( int slot );
+
+    void
+    add( int key, int slot, double q );
+
+    void
+    layout( void );
+
+    OptionPricer m_pricer;
+    std::vector<double> m_bounds;
+    std::vector<double> m_spot;
+    std::vector<GreekTotals> m_aggregates;   // underlying x bucket
+    std::vector<int> m_rangeBegin;           // per underlying, valid when m_sorted
+    std::vector<int> m_rangeEnd;
+
+    // position data, one entry per slot
+    std::vector<OptionSpec> m_options;
+    std::vector<int> m_key;                  // underlying * buckets() + bucket
+    std::vector<int> m_handle;               // slot -> handle
+    std::vector<double> m_qty;
+    std::vector<double> m_value;
+    std::vector<double> m_delta;
+    std::vector<double> m_gamma;
+    std::vector<double> m_vega;
+    std::vector<double> m_theta;
+    std::vector<double> m_rho;
+
+    std::vector<int> m_slot;                 // handle -> slot
+    bool m_sorted;
+};
+
+
+#endif
+
+///
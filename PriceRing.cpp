@@ -0,0 +1,406 @@
+/* Shared Memory Price Ring 18/10/2026
+
+ $$$$$$$$$$$$$$$$$$$$$$$$$$$$
+ $   PriceRing.cpp - code   $
+ $$$$$$$$$$$$$$$$$$$$$$$$$$$$
+
+ by W.B. Yates
+ Copyright (c) W.B. Yates. All rights reserved.
+ History:
+
+ */
+
+#include <new>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#ifndef __PRICERING_H__
+#include "PriceRing.h"
+#endif
+
+
+struct PriceRing::Header
+{
+    char     magic[8];      // "OPRING"
+    uint32_t version;
+    uint32_t capacity;      // ring slots, a power of two
+    uint32_t options;       // latest table slots
+    uint32_t multiProducer;
+    uint64_t bytes;         // of the whole region
+    uint8_t  reserved[32];
+    alignas(64) std::atomic<uint64_t> head;   // sequence numbers claimed
+};
+
+struct alignas(64) PriceRing::Slot
+{
+    // in the ring: sequence + 1 once committed, BUSY while being written;
+    // in the latest table: 2 (sequence + 1), odd while being written
+    std::atomic<uint64_t> seq;
+    uint32_t option;
+    uint32_t flags;
+    double price, delta, gamma, vega, theta, rho;
+};
+
+static_assert( std::atomic<uint64_t>::is_always_lock_free, "price ring sequence numbers must be lock free to be shared" );
+
+namespace {
+
+const char MAGIC[8] = { 'O', 'P', 'R', 'I', 'N', 'G', 0, 0 };
+const uint32_t VERSION = 1;
+const uint64_t BUSY = ~uint64_t(0);
+
+inline void
+spin( void )
+{
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#endif
+}
+
+}
+
+
+bool
+PriceRing::create( const std::string& name, uint32_t capacity, uint32_t options, bool multiProducer )
+{
+    static_assert( sizeof(Slot) == 64, "price ring slots are one cache line" );
+    close();
+
+    uint32_t cap = 1;
+    while (cap < capacity && cap < (1u << 31))
+        cap <<= 1;
+    size_t bytes = sizeof(Header) + ((size_t) cap + options) * sizeof(Slot);
+
+    void* p = MAP_FAILED;
+    if (name.empty())
+        p = mmap( nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0 );
+    else
+    {
+        int fd = shm_open( name.c_str(), O_CREAT | O_TRUNC | O_RDWR, 0644 );
+        if (fd < 0)
+            return false;
+        if (ftruncate( fd, bytes ) == 0)
+            p = mmap( nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0 );
+        ::close( fd );
+    }
+    if (p == MAP_FAILED)
+        return false;
+
+    // the region is zero filled: no slot committed, no latest update
+    Header* h = new (p) Header();
+    h->version = VERSION;
+    h->capacity = cap;
+    h->options = options;
+    h->multiProducer = multiProducer;
+    h->bytes = bytes;
+    h->head.store( 0, std::memory_order_relaxed );
+    memcpy( h->magic, MAGIC, sizeof(MAGIC) );
+
+    m_map = p;
+    m_bytes = bytes;
+    m_header = h;
+    m_ring = (Slot*) ((char*) p + sizeof(Header));
+    m_latest = m_ring + cap;
+    m_name = name;
+    return true;
+}
+
+bool
+PriceRing::open( const std::string& name )
+{
+    close();
+
+    int fd = shm_open( name.c_str(), O_RDWR, 0 );
+    if (fd < 0)
+        return false;
+
+    struct stat st;
+    void* p = MAP_FAILED;
+    if (fstat( fd, &st ) == 0 && st.st_size >= (off_t) sizeof(Header))
+        p = mmap( nullptr, st.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0 );
+    ::close( fd );
+    if (p == MAP_FAILED)
+        return false;
+
+    Header* h = (Header*) p;
+    if (memcmp( h->magic, MAGIC, sizeof(MAGIC) ) != 0 || h->version != VERSION || h->bytes != (uint64_t) st.st_size
+        || h->bytes != sizeof(Header) + ((uint64_t) h->capacity + h->options) * sizeof(Slot))
+    {
+        munmap( p, st.st_size );
+        return false;
+    }
+
+    m_map = p;
+    m_bytes = st.st_size;
+    m_header = h;
+    m_ring = (Slot*) ((char*) p + sizeof(Header));
+    m_latest = m_ring + h->capacity;
+    m_name = name;
+    return true;
+}
+
+void
+PriceRing::close( void )
+{
+    if (m_map)
+        munmap( m_map, m_bytes );
+    m_map = nullptr;
+    m_bytes = 0;
+    m_header = nullptr;
+    m_ring = nullptr;
+    m_latest = nullptr;
+    m_name.clear();
+}
+
+bool
+PriceRing::remove( const std::string& name )
+{
+    return shm_unlink( name.c_str() ) == 0;
+}
+
+uint32_t
+PriceRing::capacity( void ) const
+{
+    return (m_header) ? m_header->capacity : 0;
+}
+
+uint32_t
+PriceRing::options( void ) const
+{
+    return (m_header) ? m_header->options : 0;
+}
+
+uint64_t
+PriceRing::head( void ) const
+{
+    return (m_header) ? m_header->head.load( std::memory_order_acquire ) : 0;
+}
+
+uint64_t
+PriceRing::publish( std::span<const PriceUpdate> updates )
+{
+    uint64_t n = updates.size();
+    if (!m_header || n == 0)
+        return 0;
+
+    Header& h = *m_header;
+    uint64_t cap = h.capacity, mask = cap - 1;
+    uint64_t first = 0;
+    if (h.multiProducer)
+        first = h.head.fetch_add( n, std::memory_order_acq_rel );
+    else
+    {
+        first = h.head.load( std::memory_order_relaxed );
+        h.head.store( first + n, std::memory_order_release );
+    }
+
+    for (uint64_t k = 0; k < n; ++k)
+    {
+        const PriceUpdate& u = updates[k];
+        uint64_t s = first + k;
+        Slot& x = m_ring[s & mask];
+
+        // with several producers the slot's previous occupant may still be being written
+        if (h.multiProducer)
+        {
+            uint64_t prior = (s < cap) ? 0 : s - cap + 1;
+            while (x.seq.load( std::memory_order_acquire ) != prior)
+                spin();
+        }
+
+        x.seq.store( BUSY, std::memory_order_relaxed );
+        std::atomic_thread_fence( std::memory_order_release );
+        x.option = u.option;
+        x.flags = u.flags;
+        x.price = u.price;
+        x.delta = u.delta;
+        x.gamma = u.gamma;
+        x.vega = u.vega;
+        x.theta = u.theta;
+        x.rho = u.rho;
+        x.seq.store( s + 1, std::memory_order_release );
+
+        if (u.option >= h.options)
+            continue;
+
+        // the option's latest slot, unless a later sequence number got there first
+        Slot& l = m_latest[u.option];
+        uint64_t want = 2 * (s + 1);
+        for (;;)
+        {
+            uint64_t v = l.seq.load( std::memory_order_acquire );
+            if (v >= want)
+                break;
+            if ((v & 1) || !l.seq.compare_exchange_weak( v, v | 1, std::memory_order_acquire ))
+            {
+                spin();
+                continue;
+            }
+            std::atomic_thread_fence( std::memory_order_release );
+            l.option = u.option;
+            l.flags = u.flags;
+            l.price = u.price;
+            l.delta = u.delta;
+            l.gamma = u.gamma;
+            l.vega = u.vega;
+            l.theta = u.theta;
+            l.rho = u.rho;
+            l.seq.store( want, std::memory_order_release );
+            break;
+        }
+    }
+    return first;
+}
+
+bool
+PriceRing::latest( uint32_t option, PriceUpdate& u ) const
+{
+    if (!m_header || option >= m_header->options)
+        return false;
+
+    const Slot& l = m_latest[option];
+    for (;;)
+    {
+        uint64_t v = l.seq.load( std::memory_order_acquire );
+        if (v == 0)
+            return false;
+        if (v & 1)
+        {
+            spin();
+            continue;
+        }
+        u.option = l.option;
+        u.flags = l.flags;
+        u.price = l.price;
+        u.delta = l.delta;
+        u.gamma = l.gamma;
+        u.vega = l.vega;
+        u.theta = l.theta;
+        u.rho = l.rho;
+        std::atomic_thread_fence( std::memory_order_acquire );
+        if (l.seq.load( std::memory_order_relaxed ) == v)
+        {
+            u.sequence = v / 2 - 1;
+            return true;
+        }
+    }
+}
+
+
+PriceReader::PriceReader( const PriceRing& ring, bool fromStart ): m_ring(ring),
+                                                                   m_cursor(0),
+                                                                   m_recoverTo(0),
+                                                                   m_recoverAt(0),
+                                                                   m_recovering(false),
+                                                                   m_lapped(0),
+                                                                   m_seen()
+{
+    uint64_t h = ring.head();
+    m_cursor = (!fromStart) ? h : (h > ring.capacity()) ? h - ring.capacity() : 0;
+    m_seen.assign( ring.options(), 0 );
+}
+
+int
+PriceReader::recover( std::span<PriceUpdate> out )
+{
+    // the latest update of each option published between the cursor and the head when the reader fell behind
+    size_t n = 0;
+    uint32_t options = m_ring.options();
+    PriceUpdate u;
+    while (n < out.size() && m_recoverAt < options)
+    {
+        if (m_ring.latest( m_recoverAt, u ) && u.sequence >= m_cursor && u.sequence < m_recoverTo)
+            out[n++] = u;
+        ++m_recoverAt;
+    }
+    if (m_recoverAt == options)
+    {
+        m_recovering = false;
+        m_cursor = m_recoverTo;
+    }
+    return (int) n;
+}
+
+int
+PriceReader::poll( std::span<PriceUpdate> out, bool conflate )
+{
+    if (!m_ring.valid())
+        return 0;
+
+    size_t n = (m_recovering) ? recover( out ) : 0;
+
+    uint64_t cap = m_ring.capacity(), mask = cap - 1;
+    uint64_t head = m_ring.head();
+    while (!m_recovering && n < out.size() && m_cursor < head)
+    {
+        const PriceRing::Slot& x = m_ring.m_ring[m_cursor & mask];
+        uint64_t s = x.seq.load( std::memory_order_acquire );
+        bool lapped = head - m_cursor > cap;
+        if (!lapped && s != m_cursor + 1)
+        {
+            // not committed yet, unless it is being overwritten by the next lap
+            head = m_ring.head();
+            if (head - m_cursor <= cap && (s == BUSY || s < m_cursor + 1))
+                break;
+            lapped = true;
+        }
+
+        if (!lapped)
+        {
+            PriceUpdate& u = out[n];
+            u.option = x.option;
+            u.flags = x.flags;
+            u.price = x.price;
+            u.delta = x.delta;
+            u.gamma = x.gamma;
+            u.vega = x.vega;
+            u.theta = x.theta;
+            u.rho = x.rho;
+            std::atomic_thread_fence( std::memory_order_acquire );
+            lapped = x.seq.load( std::memory_order_relaxed ) != s;
+            u.sequence = m_cursor;
+        }
+
+        if (lapped)
+        {
+            ++m_lapped;
+            m_recovering = true;
+            m_recoverTo = m_ring.head();
+            m_recoverAt = 0;
+            n += recover( out.subspan( n ) );
+            break;
+        }
+        ++m_cursor;
+        ++n;
+    }
+
+    if (!conflate)
+        return (int) n;
+
+    // keep the last update of each option, at the place of its first
+    size_t k = 0;
+    uint32_t options = (uint32_t) m_seen.size();
+    for (size_t i = 0; i < n; ++i)
+    {
+        uint32_t o = out[i].option;
+        if (o < options && m_seen[o])
+            out[m_seen[o] - 1] = out[i];
+        else
+        {
+            if (o < options)
+                m_seen[o] = (uint32_t) k + 1;
+            out[k++] = out[i];
+        }
+    }
+    for (size_t i = 0; i < k; ++i)
+    {
+        if (out[i].option < options)
+            m_seen[out[i].option] = 0;
+    }
+    return (int) k;
+}
+
+//
@@ -0,0 +1,178 @@
+/* Shared Memory Price Ring 18/10/2026
+
+ $$$$$$$$$$$$$$$$$$$$$$$$$$$$
+ $   PriceRing.h - header   $
+ $$$$$$$$$$$$$$$$$$$$$$$$$$$$
+
+ Copyright (C) 2026  W.B. Yates
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see http://www.gnu.org/licenses/
+
+ History:
+
+ Publishes pricing results (option id, price, Greeks, sequence number) from pricing threads to any number
+ of readers (quoting, risk, a UI), in this process or others, through a lock free ring in shared memory.
+
+ The region holds a header, a ring of capacity() 64 byte slots and a table of the latest update for each
+ of options() option ids, one 64 byte slot each, so no two slots share a cache line. Publishing claims
+ sequence numbers (a plain store with one producer, a fetch_add with several), writes each update into
+ its ring slot and marks it committed by storing its sequence number there last, then writes it into
+ the option's latest slot unless a newer update is already there. A batch claims all its sequence numbers
+ at once. Producers never wait for readers.
+
+ Each PriceReader keeps its own cursor and copies committed updates out in batches; with conflate set a
+ batch holds only the last update of each option in it. A reader that falls more than capacity() behind
+ finds its slots overwritten. It then recovers from the latest table instead: it returns, once, the
+ latest update of every option updated since its cursor, and carries on from the ring's head, so a slow
+ reader loses intermediate prices but never the current ones. lapped() counts the times it happened.
+
+ A ring named "/name" is a POSIX shared memory object which other processes open(); an empty name gives
+ an anonymous shared mapping, inherited by children created with fork().
+
+ Examples
+
+    PriceRing ring;
+    ring.create( "/prices", 1 << 16, 100000, true );   // 64k slots, option ids below 100000, several producers
+    PriceUpdate u;
+    u.option = 42; u.price = 10.45; u.delta = 0.63;
+    ring.publish( u );
+
+    // in the quoting process
+    PriceRing shared;
+    shared.open( "/prices" );
+    PriceReader reader( shared );
+    std::vector<PriceUpdate> batch( 256 );
+    int n = reader.poll( batch, true );                  // conflated: one update per option
+ */
+
+
+#ifndef __PRICERING_H__
+#define __PRICERING_H__
+
+#include <span>
+#include <string>
+#include <vector>
+#include <atomic>
+#include <cstdint>
+
+
+struct PriceUpdate
+{
+    uint64_t sequence = 0;   // set by publish()
+    uint32_t option = 0;
+    uint32_t flags = 0;      // free for the publisher's use
+    double price = 0.0;
+    double delta = 0.0;
+    double gamma = 0.0;
+    double vega = 0.0;
+    double theta = 0.0;
+    double rho = 0.0;
+};
+
+
+class PriceRing
+{
+public:
+
+    PriceRing( void ): m_map(nullptr), m_bytes(0), m_header(nullptr), m_ring(nullptr), m_latest(nullptr), m_name() {}
+    ~PriceRing() { close(); }
+
+    PriceRing( const PriceRing& ) = delete;
+    PriceRing& operator=( const PriceRing& ) = delete;
+
+    bool // capacity is rounded up to a power of two
+    create( const std::string& name, uint32_t capacity, uint32_t options, bool multiProducer = false );
+
+    bool // a ring another process created
+    open( const std::string& name );
+
+    void // unmaps; the shared memory object lasts until remove()
+    close( void );
+
+    static bool
+    remove( const std::string& name );
+
+    uint64_t // the update's sequence number
+    publish( const PriceUpdate& u ) { return publish( std::span<const PriceUpdate>( &u, 1 ) ); }
+
+    uint64_t // the first update's sequence number; the rest follow in order
+    publish( std::span<const PriceUpdate> updates );
+
+    bool
+    valid( void ) const { return m_header != nullptr; }
+
+    uint32_t
+    capacity( void ) const;
+
+    uint32_t
+    options( void ) const;
+
+    uint64_t // sequence numbers claimed so far
+    head( void ) const;
+
+    bool // the latest update of an option; false if it has none
+    latest( uint32_t option, PriceUpdate& u ) const;
+
+private:
+
+    friend class PriceReader;
+
+    struct Header;
+    struct Slot;
+
+    void* m_map;
+    size_t m_bytes;
+    Header* m_header;
+    Slot* m_ring;
+    Slot* m_latest;
+    std::string m_name;
+};
+
+
+class PriceReader
+{
+public:
+
+    // from the ring's current head, or from its oldest retained update
+    explicit PriceReader( const PriceRing& ring, bool fromStart = false );
+    ~PriceReader() {}
+
+    // copies out up to out.size() updates and returns how many; 0 when there is nothing new
+    int
+    poll( std::span<PriceUpdate> out, bool conflate = false );
+
+    uint64_t // the next sequence number to read
+    cursor( void ) const { return m_cursor; }
+
+    long // times the reader fell behind and recovered from the latest table
+    lapped( void ) const { return m_lapped; }
+
+private:
+
+    int
+    recover( std::span<PriceUpdate> out );
+
+    const PriceRing& m_ring;
+    uint64_t m_cursor;
+    uint64_t m_recoverTo;     // while recovering: updates from m_cursor up to this come from the latest table
+    uint32_t m_recoverAt;     // next option to look at
+    bool m_recovering;
+    long m_lapped;
+    std::vector<uint32_t> m_seen;   // conflation: per option, 1 + its index in the batch
+};
+
+
+#endif
+
+///
@@ -0,0 +1,181 @@
+/* Pricing Instrumentation 18/10/2026
+
+ $$$$$$$$$$$$$$$$$$$$$$$$$$$$$
+ $   PriceStats.cpp - code   $
+ $$$$$$$$$$$$$$$$$$$$$$$$$$$$$
+
+ by W.B. Yates
+ Copyright (c) W.B. Yates. All rights reserved.
+ History:
+
+ */
+
+#include <stdio.h>
+#include <mutex>
+#include <chrono>
+
+#ifndef __PRICESTATS_H__
+#include "PriceStats.h"
+#endif
+
+
+namespace {
+    std::mutex registryLock;
+    std::vector<PriceStats::Thread*> registry; // blocks outlive their threads so counts are never lost
+
+    [[maybe_unused]] double
+    calibrate( void )
+    {
+#if defined(OPTION_STATS) && defined(__x86_64__)
+        // time stamp counter against the steady clock over 10ms
+        auto c0 = std::chrono::steady_clock::now();
+        uint64_t t0 = PriceStats::ticks();
+        auto c1 = c0;
+        while (c1 - c0 < std::chrono::milliseconds(10))
+        {
+            c1 = std::chrono::steady_clock::now();
+        }
+        uint64_t t1 = PriceStats::ticks();
+        double ns = std::chrono::duration<double, std::nano>( c1 - c0 ).count();
+        return (t1 > t0) ? ns / double(t1 - t0) : 1.0;
+#else
+        return 1.0;
+#endif
+    }
+}
+
+
+PriceStats::Thread*
+PriceStats::enroll( void )
+{
+    Thread* t = new Thread();
+    std::lock_guard<std::mutex> guard(registryLock);
+    registry.push_back( t );
+    return t;
+}
+
+PriceStatsSnapshot
+PriceStats::snapshot( void )
+{
+    PriceStatsSnapshot s;
+#ifdef OPTION_STATS
+    static const double nsPerTick = calibrate();
+
+    s.enabled = true;
+    s.nsPerTick = nsPerTick;
+    for (int m = 0; m < STATS_MODELS; ++m)
+    {
+        s.models[m].histogram.assign( BUCKETS, 0 );
+    }
+
+    std::lock_guard<std::mutex> guard(registryLock);
+    s.threads = (int) registry.size();
+    for (const Thread* t : registry)
+    {
+        for (int m = 0; m < STATS_MODELS; ++m)
+        {
+            PriceStatsSnapshot::Model& out = s.models[m];
+            out.calls        += t->calls[m].load( std::memory_order_relaxed );
+            out.nonFinite    += t->nonFinite[m].load( std::memory_order_relaxed );
+            out.ivCalls      += t->ivCalls[m].load( std::memory_order_relaxed );
+            out.ivIterations += t->ivIterations[m].load( std::memory_order_relaxed );
+            out.ivFailures   += t->ivFailures[m].load( std::memory_order_relaxed );
+            for (int b = 0; b < BUCKETS; ++b)
+            {
+                out.histogram[b] += t->histogram[m][b].load( std::memory_order_relaxed );
+            }
+        }
+        s.treeBuilds  += t->treeBuilds.load( std::memory_order_relaxed );
+        s.treeSteps   += t->treeSteps.load( std::memory_order_relaxed );
+        s.treeResizes += t->treeResizes.load( std::memory_order_relaxed );
+    }
+#endif
+    return s;
+}
+
+void
+PriceStats::reset( void )
+{
+    std::lock_guard<std::mutex> guard(registryLock);
+    for (Thread* t : registry)
+    {
+        for (int m = 0; m < STATS_MODELS; ++m)
+        {
+            t->calls[m].store( 0, std::memory_order_relaxed );
+            t->nonFinite[m].store( 0, std::memory_order_relaxed );
+            t->ivCalls[m].store( 0, std::memory_order_relaxed );
+            t->ivIterations[m].store( 0, std::memory_order_relaxed );
+            t->ivFailures[m].store( 0, std::memory_order_relaxed );
+            for (int b = 0; b < BUCKETS; ++b)
+            {
+                t->histogram[m][b].store( 0, std::memory_order_relaxed );
+            }
+        }
+        t->treeBuilds.store( 0, std::memory_order_relaxed );
+        t->treeSteps.store( 0, std::memory_order_relaxed );
+        t->treeResizes.store( 0, std::memory_order_relaxed );
+    }
+}
+
+double
+PriceStatsSnapshot::Model::percentile( double p, double nsPerTick ) const
+{
+    uint64_t total = 0;
+    for (uint64_t c : histogram)
+    {
+        total += c;
+    }
+    if (total == 0)
+        return 0.0;
+
+    p = (p < 0.0) ? 0.0 : (p > 1.0) ? 1.0 : p;
+    uint64_t rank = (uint64_t) ceil( p * double(total) );
+    if (rank == 0)
+        rank = 1;
+
+    uint64_t seen = 0;
+    for (int b = 0; b < (int) histogram.size(); ++b)
+    {
+        seen += histogram[b];
+        if (seen >= rank)
+        {
+            // bucket midpoint
+            double lo = (double) PriceStats::bucketFloor( b );
+            double hi = (b + 1 < PriceStats::BUCKETS) ? (double) PriceStats::bucketFloor( b + 1 ) : lo;
+            return 0.5 * (lo + hi) * nsPerTick;
+        }
+    }
+    return 0.0;
+}
+
+std::string
+PriceStatsSnapshot::text( void ) const
+{
+    if (!enabled)
+        return "price stats disabled (build with -DOPTION_STATS)\n";
+
+    static const char* names[STATS_MODELS] = { "BlackScholes", "Black", "BinomialTree" };
+
+    std::string out;
+    char line[256];
+    snprintf( line, sizeof(line), "%-13s %12s %9s %9s %9s %10s %10s %10s %8s\n",
+              "model", "calls", "p50 ns", "p99 ns", "p99.9 ns", "nonfinite", "iv calls", "iv iter", "iv fail" );
+    out += line;
+    for (int m = 0; m < STATS_MODELS; ++m)
+    {
+        const Model& s = models[m];
+        snprintf( line, sizeof(line), "%-13s %12llu %9.1f %9.1f %9.1f %10llu %10llu %10llu %8llu\n",
+                  names[m], (unsigned long long) s.calls,
+                  s.percentile( 0.5, nsPerTick ), s.percentile( 0.99, nsPerTick ), s.percentile( 0.999, nsPerTick ),
+                  (unsigned long long) s.nonFinite, (unsigned long long) s.ivCalls,
+                  (unsigned long long) s.ivIterations, (unsigned long long) s.ivFailures );
+        out += line;
+    }
+    snprintf( line, sizeof(line), "tree builds %llu, mean steps %.1f, workspace resizes %llu, threads %d\n",
+              (unsigned long long) treeBuilds, (treeBuilds) ? double(treeSteps) / double(treeBuilds) : 0.0,
+              (unsigned long long) treeResizes, threads );
+    out += line;
+    return out;
+}
+
+//
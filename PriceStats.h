@@ -0,0 +1,252 @@
+/* Pricing Instrumentation 18/10/2026
+
+ $$$$$$$$$$$$$$$$$$$$$$$$$$$$$
+ $   PriceStats.h - header   $
+ $$$$$$$$$$$$$$$$$$$$$$$$$$$$$
+
+ Copyright (C) 2026  W.B. Yates
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see http://www.gnu.org/licenses/
+
+ History:
+
+ Optional counters and latency histograms for the pricing models. Build with -DOPTION_STATS to enable
+ them; otherwise the PRICE_STATS_ macros expand to nothing and snapshot() returns an empty, disabled
+ snapshot.
+
+ Recorded per model: value() calls and their latency, non finite (NaN or inf) values, and impliedVol
+ calls, Newton iterations and failures to converge. For BinomialTree, lattice builds, total time steps
+ and workspace resizes.
+
+ Each thread writes to its own cache aligned block of relaxed atomics (registered on first use), so the
+ hot path takes no lock and shares no cache line. Latencies are kept in ticks (rdtsc on x86-64,
+ nanoseconds elsewhere) in HDR style log-linear buckets with 8 sub-buckets per power of two, which is
+ about 12% resolution over the full 64 bit range. snapshot() sums all threads; reset() zeroes them,
+ and is only exact when no thread is pricing.
+
+ Reading the clock costs more than counting (rdtsc is 7-25ns depending on the host), so only one call
+ in OPTION_STATS_SAMPLE (a power of two, 16 by default) per thread is timed; every call is counted.
+ Build with -DOPTION_STATS_SAMPLE=1 to time them all.
+
+ Examples
+
+    // g++ -DOPTION_STATS ...
+    BlackScholes bs;
+    for (...) bs.value( ... );
+    PriceStatsSnapshot s = PriceStats::snapshot();
+    std::cout << s.text();
+    std::cout << "p99 " << s.percentile( StatsModel::BlackScholes, 0.99 ) << " ns" << std::endl;
+ */
+
+
+#ifndef __PRICESTATS_H__
+#define __PRICESTATS_H__
+
+#include <math.h>
+#include <atomic>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+#if defined(OPTION_STATS) && defined(__x86_64__)
+#include <x86intrin.h>
+#elif defined(OPTION_STATS)
+#include <chrono>
+#endif
+
+#ifndef OPTION_STATS_SAMPLE
+#define OPTION_STATS_SAMPLE 16
+#endif
+
+
+enum class StatsModel : int { BlackScholes = 0, Black = 1, BinomialTree = 2 };
+
+const int STATS_MODELS = 3;
+
+
+struct PriceStatsSnapshot
+{
+    struct Model
+    {
+        uint64_t calls = 0;
+        uint64_t nonFinite = 0;
+        uint64_t ivCalls = 0;
+        uint64_t ivIterations = 0;
+        uint64_t ivFailures = 0;
+        std::vector<uint64_t> histogram;  // value() latency, ticks, PriceStats::bucket() layout
+
+        double // latency in ns at quantile p in [0, 1]
+        percentile( double p, double nsPerTick ) const;
+    };
+
+    bool     enabled = false;
+    int      threads = 0;      // threads that have recorded anything
+    double   nsPerTick = 1.0;
+    Model    models[STATS_MODELS];
+    uint64_t treeBuilds = 0;
+    uint64_t treeSteps = 0;
+    uint64_t treeResizes = 0;
+
+    double
+    percentile( StatsModel m, double p ) const { return models[(int) m].percentile( p, nsPerTick ); }
+
+    std::string
+    text( void ) const;
+};
+
+
+class PriceStats
+{
+public:
+
+    static const int SUB_BITS = 3;
+    static const int BUCKETS = 64 << SUB_BITS;
+
+    struct alignas(64) Thread
+    {
+        std::atomic<uint64_t> calls[STATS_MODELS];
+        std::atomic<uint64_t> nonFinite[STATS_MODELS];
+        std::atomic<uint64_t> ivCalls[STATS_MODELS];
+        std::atomic<uint64_t> ivIterations[STATS_MODELS];
+        std::atomic<uint64_t> ivFailures[STATS_MODELS];
+        std::atomic<uint64_t> treeBuilds;
+        std::atomic<uint64_t> treeSteps;
+        std::atomic<uint64_t> treeResizes;
+        std::atomic<uint64_t> histogram[STATS_MODELS][BUCKETS];
+        uint64_t sequence;  // owner only; selects the sampled calls
+    };
+
+    static_assert( (OPTION_STATS_SAMPLE & (OPTION_STATS_SAMPLE - 1)) == 0, "OPTION_STATS_SAMPLE must be a power of two" );
+
+    // counts one value() call and times it if it is sampled
+    class Timer
+    {
+    public:
+        explicit Timer( StatsModel m ): m_stats(local()), m_model((int) m), m_start(0)
+        {
+            if ((m_stats.sequence++ & (OPTION_STATS_SAMPLE - 1)) == 0)
+                m_start = ticks();
+        }
+        ~Timer()
+        {
+            add( m_stats.calls[m_model] );
+            if (m_start)
+                add( m_stats.histogram[m_model][bucket( ticks() - m_start )] );
+        }
+    private:
+        Thread& m_stats;
+        int m_model;
+        uint64_t m_start;
+    };
+
+    static PriceStatsSnapshot
+    snapshot( void );
+
+    static void
+    reset( void );
+
+    static int
+    bucket( uint64_t ticks )
+    {
+        if (ticks < (1u << SUB_BITS))
+            return (int) ticks;
+        int e = 63 - __builtin_clzll( ticks );
+        return ((e - SUB_BITS + 1) << SUB_BITS) + (int) ((ticks >> (e - SUB_BITS)) & ((1u << SUB_BITS) - 1));
+    }
+
+    static uint64_t // smallest tick count in bucket b
+    bucketFloor( int b )
+    {
+        if (b < (1 << SUB_BITS))
+            return (uint64_t) b;
+        int e = (b >> SUB_BITS) + SUB_BITS - 1;
+        return (uint64_t) ((1 << SUB_BITS) + (b & ((1 << SUB_BITS) - 1))) << (e - SUB_BITS);
+    }
+
+    static uint64_t
+    ticks( void )
+    {
+#if defined(OPTION_STATS) && defined(__x86_64__)
+        return __rdtsc();
+#elif defined(OPTION_STATS)
+        return (uint64_t) std::chrono::duration_cast<std::chrono::nanoseconds>( std::chrono::steady_clock::now().time_since_epoch() ).count();
+#else
+        return 0;
+#endif
+    }
+
+    static void
+    value( StatsModel m, double v )
+    {
+        if (!isfinite( v ))
+            add( local().nonFinite[(int) m] );
+    }
+
+    static void
+    impliedVol( StatsModel m, int iterations, bool converged )
+    {
+        Thread& s = local();
+        add( s.ivCalls[(int) m] );
+        add( s.ivIterations[(int) m], (uint64_t) iterations );
+        if (!converged)
+            add( s.ivFailures[(int) m] );
+    }
+
+    static void
+    tree( int steps )
+    {
+        Thread& s = local();
+        add( s.treeBuilds );
+        add( s.treeSteps, (uint64_t) steps );
+    }
+
+    static void
+    resize( void ) { add( local().treeResizes ); }
+
+private:
+
+    // only the owning thread writes its block, so a relaxed load and store is enough
+    static void
+    add( std::atomic<uint64_t>& c, uint64_t n = 1 ) { c.store( c.load( std::memory_order_relaxed ) + n, std::memory_order_relaxed ); }
+
+    static Thread&
+    local( void )
+    {
+        thread_local Thread* t = enroll();
+        return *t;
+    }
+
+    static Thread*
+    enroll( void );
+};
+
+
+#ifdef OPTION_STATS
+#define PRICE_STATS_TIMER( m )                     PriceStats::Timer priceStatsTimer_( m )
+#define PRICE_STATS_VALUE( m, v )                  PriceStats::value( m, v )
+#define PRICE_STATS_IMPLIEDVOL( m, iter, conv )    PriceStats::impliedVol( m, iter, conv )
+#define PRICE_STATS_TREE( steps )                  PriceStats::tree( steps )
+#define PRICE_STATS_RESIZE()                       PriceStats::resize()
+#else
+#define PRICE_STATS_TIMER( m )                     ((void) 0)
+#define PRICE_STATS_VALUE( m, v )                  ((void) 0)
+#define PRICE_STATS_IMPLIEDVOL( m, iter, conv )    ((void) 0)
+#define PRICE_STATS_TREE( steps )                  ((void) 0)
+#define PRICE_STATS_RESIZE()                       ((void) 0)
+#endif
+
+
+#endif
+
+///
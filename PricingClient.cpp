@@ -0,0 +1,194 @@
+/* Pricing Service Client 18/10/2026
+
+ $$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$
+ $   PricingClient.cpp - code   $
+ $$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$
+
+ by W.B. Yates
+ Copyright (c) W.B. Yates. All rights reserved.
+ History:
+
+ */
+
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/un.h>
+#include <sys/uio.h>
+#include <sys/socket.h>
+#include <algorithm>
+
+#ifndef __PRICINGCLIENT_H__
+#include "PricingClient.h"
+#endif
+
+
+bool
+PricingClient::connect( const std::string& path )
+{
+    close();
+
+    sockaddr_un addr;
+    memset( &addr, 0, sizeof(addr) );
+    if (path.empty() || path.size() >= sizeof(addr.sun_path))
+        return false;
+    addr.sun_family = AF_UNIX;
+    memcpy( addr.sun_path, path.c_str(), path.size() );
+
+    m_fd = socket( AF_UNIX, SOCK_STREAM, 0 );
+    if (m_fd < 0)
+        return false;
+    if (::connect( m_fd, (const sockaddr*) &addr, sizeof(addr) ) != 0)
+    {
+        close();
+        return false;
+    }
+    return true;
+}
+
+void
+PricingClient::close( void )
+{
+    if (m_fd >= 0)
+        ::close( m_fd );
+    m_fd = -1;
+}
+
+uint64_t
+PricingClient::send( std::span<const OptionSpec> options, uint8_t greeks )
+{
+    if (options.size() > PRICING_MAX_OPTIONS)
+        return 0;
+
+    uint32_t n = (uint32_t) options.size();
+    m_request.resize( OptionColumns::bytes( n ) );
+    OptionColumns block = OptionColumns::create( m_request.data(), m_request.size(), n );
+    for (uint32_t i = 0; i < n; ++i)
+    {
+        block.option( i, options[i], greeks );
+    }
+    return send( block );
+}
+
+uint64_t
+PricingClient::send( const OptionColumns& block )
+{
+    if (m_fd < 0 || !block.valid() || block.count() > PRICING_MAX_OPTIONS)
+        return 0;
+
+    PricingRequest h;
+    memset( &h, 0, sizeof(h) );
+    h.magic = PRICING_REQUEST_MAGIC;
+    h.count = block.count();
+    h.id = m_next;
+
+    if (!writeAll( &h, block.data(), block.size() ))
+    {
+        close();
+        return 0;
+    }
+    return m_next++;
+}
+
+bool
+PricingClient::writeAll( const void* header, const void* block, size_t size )
+{
+    iovec io[2] = { { (void*) header, sizeof(PricingRequest) }, { (void*) block, size } };
+    int first = 0;
+    while (io[1].iov_len > 0)
+    {
+        msghdr msg;
+        memset( &msg, 0, sizeof(msg) );
+        msg.msg_iov = io + first;
+        msg.msg_iovlen = 2 - first;
+        ssize_t k = sendmsg( m_fd, &msg, MSG_NOSIGNAL );
+        if (k < 0 && errno == EINTR)
+            continue;
+        if (k <= 0)
+            return false;
+
+        while (k > 0)
+        {
+            size_t step = std::min( (size_t) k, io[first].iov_len );
+            io[first].iov_base = (char*) io[first].iov_base + step;
+            io[first].iov_len -= step;
+            k -= (ssize_t) step;
+            if (io[first].iov_len == 0 && first < 1)
+                ++first;
+        }
+    }
+    return true;
+}
+
+bool
+PricingClient::receive( uint64_t& id, ResultColumns& results )
+{
+    PricingResponse h;
+    if (!readAll( &h, sizeof(h) ) || h.magic != PRICING_RESPONSE_MAGIC || h.count > PRICING_MAX_OPTIONS)
+    {
+        close();
+        return false;
+    }
+
+    m_reply.resize( ResultColumns::bytes( h.count ) );
+    if (!readAll( m_reply.data(), m_reply.size() ))
+    {
+        close();
+        return false;
+    }
+
+    results = ResultColumns( m_reply.data(), m_reply.size() );
+    if (!results.valid() || results.count() != h.count)
+    {
+        close();
+        return false;
+    }
+    id = h.id;
+    return true;
+}
+
+bool
+PricingClient::receive( uint64_t& id, std::vector<double>& prices )
+{
+    ResultColumns results;
+    if (!receive( id, results ))
+        return false;
+    prices.assign( results.value(), results.value() + results.count() );
+    return true;
+}
+
+bool
+PricingClient::price( std::span<const OptionSpec> options, std::vector<double>& prices )
+{
+    uint64_t want = send( options );
+    if (want == 0)
+        return false;
+
+    // replies to earlier send() calls are discarded
+    uint64_t id = 0;
+    while (receive( id, prices ))
+    {
+        if (id == want)
+            return true;
+    }
+    return false;
+}
+
+bool
+PricingClient::readAll( void* buf, size_t n )
+{
+    char* p = (char*) buf;
+    while (n > 0)
+    {
+        ssize_t k = read( m_fd, p, n );
+        if (k < 0 && errno == EINTR)
+            continue;
+        if (k <= 0)
+            return false;
+        p += k;
+        n -= (size_t) k;
+    }
+    return true;
+}
+
+//
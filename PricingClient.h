@@ -0,0 +1,109 @@
+/* Pricing Service Client 18/10/2026
+
+ $$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$
+ $   PricingClient.h - header   $
+ $$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$
+
+ Copyright (C) 2026  W.B. Yates
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see http://www.gnu.org/licenses/
+
+ History:
+
+ A blocking client for PricingServer. price() sends one request and waits for its reply;
+ send() and receive() let a caller keep several requests in flight and match replies by id.
+ A caller that already holds an OptionColumns block (in shared memory for example) can send it as is.
+ The ResultColumns returned by receive() view the client's buffer and last until the next receive().
+ A PricingClient is one connection and must not be shared between threads.
+
+ Examples
+
+    PricingClient client;
+    std::vector<double> prices;
+    if (client.connect( "/tmp/pricing.sock" ) && client.price( options, prices ))
+        ...
+ */
+
+
+#ifndef __PRICINGCLIENT_H__
+#define __PRICINGCLIENT_H__
+
+#include <span>
+#include <string>
+#include <vector>
+
+#ifndef __PRICINGPROTOCOL_H__
+#include "PricingProtocol.h"
+#endif
+
+#ifndef __ALIGNEDALLOCATOR_H__
+#include "AlignedAllocator.h"
+#endif
+
+
+class PricingClient
+{
+public:
+
+    PricingClient( void ): m_fd(-1), m_next(1), m_request(), m_reply() {}
+    ~PricingClient() { close(); }
+
+    PricingClient( const PricingClient& ) = delete;
+    PricingClient& operator=( const PricingClient& ) = delete;
+
+    bool
+    connect( const std::string& path );
+
+    void
+    close( void );
+
+    bool
+    connected( void ) const { return m_fd >= 0; }
+
+    // send options and wait for their prices; false if the connection failed
+    bool
+    price( std::span<const OptionSpec> options, std::vector<double>& prices );
+
+    // send a request without waiting, with the same Greeks requested for every option; returns its id, 0 on failure
+    uint64_t
+    send( std::span<const OptionSpec> options, uint8_t greeks = 0 );
+
+    uint64_t
+    send( const OptionColumns& block );
+
+    // wait for the next reply
+    bool
+    receive( uint64_t& id, ResultColumns& results );
+
+    bool
+    receive( uint64_t& id, std::vector<double>& prices );
+
+private:
+
+    bool
+    readAll( void* buf, size_t n );
+
+    bool
+    writeAll( const void* header, const void* block, size_t size );
+
+    int m_fd;
+    uint64_t m_next;
+    std::vector<char, AlignedAllocator<char>> m_request;
+    std::vector<char, AlignedAllocator<char>> m_reply;
+};
+
+
+#endif
+
+///
@@ -0,0 +1,69 @@
+/* Pricing Daemon 18/10/2026
+
+ $$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$
+ $   PricingDaemon.cpp - code   $
+ $$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$
+
+ by W.B. Yates
+ Copyright (c) W.B. Yates. All rights reserved.
+ History:
+
+ Runs a PricingServer until SIGINT or SIGTERM. Built as its own program, e.g.
+
+    c++ -std=c++20 -O3 PricingDaemon.cpp PricingServer.cpp PricingScheduler.cpp OptionRecord.cpp OptionPricer.cpp TaskPool.cpp \
+        BlackScholes.cpp Black.cpp BinomialTree.cpp BaroneAdesiWhaley.cpp PriceStats.cpp -o pricingd -lpthread
+    ./pricingd /tmp/pricing.sock 4 200
+
+ usage: pricingd <socket> [treeThreads] [latencyTarget us]
+ */
+
+#include <iostream>
+#include <signal.h>
+#include <stdlib.h>
+
+#ifndef __PRICINGSERVER_H__
+#include "PricingServer.h"
+#endif
+
+static PricingServer* server = nullptr;
+
+static void
+onSignal( int )
+{
+    if (server)
+        server->stop();
+}
+
+int
+main( int argc, const char* argv[] )
+{
+    if (argc < 2)
+    {
+        std::cerr << "usage: " << argv[0] << " <socket> [treeThreads] [latencyTarget us]" << std::endl;
+        return 1;
+    }
+
+    PricingServer s( (argc > 2) ? atoi( argv[2] ) : 0 );
+    if (argc > 3)
+        s.latencyTarget( atof( argv[3] ) );
+
+    if (!s.listen( argv[1] ))
+    {
+        std::cerr << "cannot listen on " << argv[1] << std::endl;
+        return 1;
+    }
+
+    server = &s;
+    signal( SIGINT, onSignal );
+    signal( SIGTERM, onSignal );
+    signal( SIGPIPE, SIG_IGN );
+
+    std::cout << "pricing on " << argv[1] << ", latency target " << s.latencyTarget() << "us" << std::endl;
+    s.run();
+    server = nullptr;
+
+    std::cout << s.options() << " options in " << s.batches() << " batches" << std::endl;
+    return 0;
+}
+
+//
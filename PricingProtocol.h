@@ -0,0 +1,75 @@
+/* Pricing Service Protocol 18/10/2026
+
+ $$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$
+ $   PricingProtocol.h - header   $
+ $$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$
+
+ Copyright (C) 2026  W.B. Yates
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see http://www.gnu.org/licenses/
+
+ History:
+
+ The binary messages exchanged by PricingServer and PricingClient over a Unix domain socket.
+ All fields are little-endian and everything is sent as it is laid out in memory.
+
+ A request is a 64 byte PricingRequest header followed by an OptionColumns block of count options
+ (see OptionRecord.h); the reply is a PricingResponse header with the same id followed by a
+ ResultColumns block of count results in request order. Every request is a multiple of 64 bytes, so
+ a receiver reading into a 64 byte aligned buffer can view the columns in place.
+
+ An option that cannot be priced has status Invalid (an unknown model, a non positive strike, price,
+ vol or T, or more than PRICING_MAX_STEPS tree steps) or Unsupported (a style its model cannot price)
+ and a NaN value. A client may have several requests in flight; replies can arrive in any order.
+ */
+
+
+#ifndef __PRICINGPROTOCOL_H__
+#define __PRICINGPROTOCOL_H__
+
+#include <cstdint>
+
+#ifndef __OPTIONRECORD_H__
+#include "OptionRecord.h"
+#endif
+
+
+const uint32_t PRICING_REQUEST_MAGIC  = 0x5152504f; // "OPRQ"
+const uint32_t PRICING_RESPONSE_MAGIC = 0x5352504f; // "OPRS"
+const uint32_t PRICING_MAX_OPTIONS    = 1u << 20;   // per request
+const int32_t  PRICING_MAX_STEPS      = 10000;      // BinomialTree time steps
+
+
+struct PricingRequest
+{
+    uint32_t magic;
+    uint32_t count;   // options in the block that follows
+    uint64_t id;      // chosen by the client, echoed in the response
+    uint8_t  reserved[48];
+};
+
+struct PricingResponse
+{
+    uint32_t magic;
+    uint32_t count;   // results in the block that follows
+    uint64_t id;
+    uint8_t  reserved[48];
+};
+
+static_assert( sizeof(PricingRequest) == 64 && sizeof(PricingResponse) == 64, "pricing protocol headers must be 64 bytes" );
+
+
+#endif
+
+///
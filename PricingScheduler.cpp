@@ -0,0 +1,157 @@
+/* Pricing Scheduler 18/10/2026
+
+ $$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$
+ $   PricingScheduler.cpp - code   $
+ $$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$
+
+ by W.B. Yates
+ Copyright (c) W.B. Yates. All rights reserved.
+ History:
+
+ */
+
+#include <bit>
+
+#ifndef __PRICINGSCHEDULER_H__
+#include "PricingScheduler.h"
+#endif
+
+
+PricingScheduler::PricingScheduler( int threads, bool pin ): m_pool(threads, pin),
+                                                             m_pricers(),
+                                                             m_order(),
+                                                             m_first(1, 0),
+                                                             m_cost(),
+                                                             m_treeSteps(BinomialTree().timeSteps()),
+                                                             m_grain(64.0)
+{
+    m_pricers.resize( m_pool.threads() );
+}
+
+double
+PricingScheduler::cost( const OptionSpec& o, int treeSteps )
+{
+    if (o.model != OptionModel::BinomialTree)
+        return 1.0;
+
+    // about 0.04 of a closed form value per lattice node
+    double n = (o.timeSteps > 0) ? o.timeSteps : treeSteps;
+    return 1.0 + 0.04 * (n + 1.0) * (n + 2.0) * 0.5;
+}
+
+OptionSpec
+PricingScheduler::resolve( const OptionSpec& o ) const
+{
+    OptionSpec s = o;
+    if (s.model == OptionModel::BinomialTree && s.timeSteps <= 0)
+        s.timeSteps = m_treeSteps;
+    return s;
+}
+
+void
+PricingScheduler::plan( std::span<const OptionSpec> options, std::span<const uint8_t> greeks )
+{
+    int n = (int) options.size();
+
+    m_order.clear();
+    m_first.assign( 1, 0 );
+    m_cost.clear();
+
+    // expensive options become tasks of their own, cheap ones are chunked in input order
+    double chunk = 0.0;
+    std::vector<int> cheap;
+    for (int i = 0; i < n; ++i)
+    {
+        double c = cost( options[i], m_treeSteps );
+        if (i < (int) greeks.size())
+            c *= 1 + std::popcount( (unsigned) (greeks[i] & GREEK_ALL) );
+        if (c >= m_grain)
+        {
+            m_order.push_back( i );
+            m_first.push_back( (int) m_order.size() );
+            m_cost.push_back( c );
+            continue;
+        }
+
+        cheap.push_back( i );
+        chunk += c;
+        if (chunk >= m_grain)
+        {
+            m_order.insert( m_order.end(), cheap.begin(), cheap.end() );
+            m_first.push_back( (int) m_order.size() );
+            m_cost.push_back( chunk );
+            cheap.clear();
+            chunk = 0.0;
+        }
+    }
+
+    if (!cheap.empty())
+    {
+        m_order.insert( m_order.end(), cheap.begin(), cheap.end() );
+        m_first.push_back( (int) m_order.size() );
+        m_cost.push_back( chunk );
+    }
+}
+
+void
+PricingScheduler::priceAll( std::span<const OptionSpec> options, std::span<double> prices )
+{
+    if (options.empty() || prices.size() < options.size())
+        return;
+
+    plan( options, {} );
+
+    m_pool.run( tasks(), [&]( int t, int w )
+    {
+        OptionPricer& pricer = m_pricers[w];
+        for (int k = m_first[t]; k < m_first[t + 1]; ++k)
+        {
+            int i = m_order[k];
+            prices[i] = pricer.value( resolve( options[i] ) );
+        }
+    }, m_cost.data() );
+}
+
+void
+PricingScheduler::evaluate( std::span<const OptionSpec> options, std::span<const uint8_t> greeks, const ResultColumns& results )
+{
+    if (options.empty() || !results.valid() || results.count() < options.size())
+        return;
+
+    plan( options, greeks );
+
+    m_pool.run( tasks(), [&]( int t, int w )
+    {
+        OptionPricer& pricer = m_pricers[w];
+        for (int k = m_first[t]; k < m_first[t + 1]; ++k)
+        {
+            int i = m_order[k];
+            OptionSpec o = resolve( options[i] );
+            uint8_t g = (i < (int) greeks.size()) ? (uint8_t) (greeks[i] & GREEK_ALL) : 0;
+
+            results.value()[i] = pricer.value( o );
+            if (g & GREEK_DELTA)
+                results.delta()[i] = pricer.delta( o );
+            if (g & GREEK_GAMMA)
+                results.gamma()[i] = pricer.gamma( o );
+            if (g & GREEK_VEGA)
+                results.vega()[i] = pricer.vega( o );
+            if (g & GREEK_THETA)
+                results.theta()[i] = pricer.theta( o );
+            if (g & GREEK_RHO)
+                results.rho()[i] = pricer.rho( o );
+            results.greeks()[i] = g;
+            results.status()[i] = (uint8_t) RecordStatus::Ok;
+        }
+    }, m_cost.data() );
+}
+
+std::vector<double>
+PricingScheduler::priceAll( std::span<const OptionSpec> options )
+{
+    std::vector<double> prices(options.size(), 0.0);
+    priceAll( options, prices );
+    return prices;
+}
+
+//
@@ -0,0 +1,123 @@
+/* Pricing Scheduler 18/10/2026
+
+ $$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$
+ $   PricingScheduler.h - header   $
+ $$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$
+
+ Copyright (C) 2026  W.B. Yates
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see http://www.gnu.org/licenses/
+
+ History:
+
+ Prices a mixed batch of OptionSpecs on a work stealing TaskPool.
+
+ A closed form value costs about as much as one N(x), a BinomialTree value grows with the number of
+ lattice nodes, (N+1)(N+2)/2 for N time steps, so a batch mixing the two cannot be split statically.
+ Each option is given an estimated cost (in units of one BlackScholes value); cheap options are grouped,
+ in input order, into tasks of at least grain() units and every other option is a task of its own.
+ The tasks are then dealt longest first to the pool (see TaskPool) and idle workers steal the rest.
+
+ An OptionSpec with timeSteps = 0 is priced with treeSteps() steps, whichever worker prices it.
+
+ evaluate() also computes the Greeks requested for each option (GREEK_ bits, see OptionRecord.h) and
+ writes everything to a ResultColumns block; each Greek adds the option's cost again to its estimate.
+
+ Examples
+
+    PricingScheduler scheduler;                  // one worker per core, not pinned
+    std::vector<OptionSpec> batch = ...;
+    std::vector<double> prices = scheduler.priceAll( batch );
+ */
+
+
+#ifndef __PRICINGSCHEDULER_H__
+#define __PRICINGSCHEDULER_H__
+
+#include <span>
+#include <vector>
+
+#ifndef __OPTIONPRICER_H__
+#include "OptionPricer.h"
+#endif
+
+#ifndef __TASKPOOL_H__
+#include "TaskPool.h"
+#endif
+
+#ifndef __OPTIONRECORD_H__
+#include "OptionRecord.h"
+#endif
+
+
+class PricingScheduler
+{
+public:
+
+    explicit PricingScheduler( int threads = 0, bool pin = false ); // 0 uses one thread per core
+
+    std::vector<double>
+    priceAll( std::span<const OptionSpec> options );
+
+    // prices.size() must be at least options.size()
+    void
+    priceAll( std::span<const OptionSpec> options, std::span<double> prices );
+
+    // value options[i] and the Greeks in greeks[i] (empty for none) into results[i]; results.count() must be at least options.size()
+    void
+    evaluate( std::span<const OptionSpec> options, std::span<const uint8_t> greeks, const ResultColumns& results );
+
+    // estimated cost of valuing o, in units of one BlackScholes value
+    static double
+    cost( const OptionSpec& o, int treeSteps );
+
+    int
+    threads( void ) const { return m_pool.threads(); }
+
+    int
+    treeSteps( void ) const { return m_treeSteps; }
+
+    void
+    treeSteps( int n ) { m_treeSteps = (n > 0) ? n : 1; }
+
+    double
+    grain( void ) const { return m_grain; }
+
+    void
+    grain( double g ) { m_grain = (g > 1.0) ? g : 1.0; }
+
+    int // number of tasks in the last batch
+    tasks( void ) const { return (int) m_first.size() - 1; }
+
+private:
+
+    void
+    plan( std::span<const OptionSpec> options, std::span<const uint8_t> greeks );
+
+    OptionSpec
+    resolve( const OptionSpec& o ) const;
+
+    TaskPool m_pool;
+    std::vector<OptionPricer> m_pricers; // one per worker
+    std::vector<int>    m_order;         // option indices grouped by task
+    std::vector<int>    m_first;         // task t prices m_order[m_first[t]] .. m_order[m_first[t+1]-1]
+    std::vector<double> m_cost;          // per task
+    int    m_treeSteps;
+    double m_grain;
+};
+
+
+#endif
+
+///
@@ -0,0 +1,542 @@
+/* Micro Batching Pricing Server 18/10/2026
+
+ $$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$
+ $   PricingServer.cpp - code   $
+ $$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$
+
+ by W.B. Yates
+ Copyright (c) W.B. Yates. All rights reserved.
+ History:
+
+ */
+
+#include <math.h>
+#include <poll.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/un.h>
+#include <sys/socket.h>
+#include <algorithm>
+
+#ifndef __PRICINGSERVER_H__
+#include "PricingServer.h"
+#endif
+
+#ifndef __BATCHKERNELS_H__
+#include "BatchKernels.h"
+#endif
+
+
+namespace {
+
+bool
+nonBlocking( int fd )
+{
+    int flags = fcntl( fd, F_GETFL, 0 );
+    return flags >= 0 && fcntl( fd, F_SETFL, flags | O_NONBLOCK ) == 0;
+}
+
+RecordStatus
+check( const OptionSpec& o, uint8_t style )
+{
+    if ((int) o.model < 0 || (int) o.model > (int) OptionModel::BinomialTree)
+        return RecordStatus::Invalid;
+    if (!(o.strike > 0.0 && o.assetPrice > 0.0 && o.vol > 0.0 && o.T > 0.0))
+        return RecordStatus::Invalid;
+    if (o.model == OptionModel::BinomialTree && (o.timeSteps < 0 || o.timeSteps > PRICING_MAX_STEPS))
+        return RecordStatus::Invalid;
+
+    // the closed forms are European, the tree American
+    OptionStyle s = (o.model == OptionModel::BinomialTree) ? OptionStyle::American : OptionStyle::European;
+    return (style == (uint8_t) s) ? RecordStatus::Ok : RecordStatus::Unsupported;
+}
+
+// replies a client may leave unread before it is disconnected
+const size_t PRICING_MAX_BACKLOG = 64u << 20;
+
+}
+
+
+PricingServer::Connection::~Connection()
+{
+    if (fd >= 0)
+        close( fd );
+}
+
+PricingServer::PricingServer( int treeThreads ): m_listen(-1),
+                                                 m_wake{ -1, -1 },
+                                                 m_path(),
+                                                 m_connections(),
+                                                 m_pending(),
+                                                 m_lock(),
+                                                 m_ready(),
+                                                 m_queue(),
+                                                 m_busy(false),
+                                                 m_trees(treeThreads),
+                                                 m_work(),
+                                                 m_nsPerOption(100.0),
+                                                 m_stop(false),
+                                                 m_batches(0),
+                                                 m_options(0),
+                                                 m_target(200.0),
+                                                 m_maxBatch(65536)
+{
+    if (pipe( m_wake ) == 0)
+    {
+        nonBlocking( m_wake[0] );
+        nonBlocking( m_wake[1] );
+    }
+}
+
+PricingServer::~PricingServer()
+{
+    m_connections.clear();
+    if (m_listen >= 0)
+    {
+        close( m_listen );
+        unlink( m_path.c_str() );
+    }
+    if (m_wake[0] >= 0)
+        close( m_wake[0] );
+    if (m_wake[1] >= 0)
+        close( m_wake[1] );
+}
+
+bool
+PricingServer::listen( const std::string& path )
+{
+    sockaddr_un addr;
+    memset( &addr, 0, sizeof(addr) );
+    if (path.empty() || path.size() >= sizeof(addr.sun_path) || m_wake[0] < 0)
+        return false;
+
+    addr.sun_family = AF_UNIX;
+    memcpy( addr.sun_path, path.c_str(), path.size() );
+
+    int fd = socket( AF_UNIX, SOCK_STREAM, 0 );
+    if (fd < 0)
+        return false;
+
+    unlink( path.c_str() );
+    if (bind( fd, (const sockaddr*) &addr, sizeof(addr) ) != 0 || ::listen( fd, 128 ) != 0 || !nonBlocking( fd ))
+    {
+        close( fd );
+        return false;
+    }
+
+    if (m_listen >= 0)
+    {
+        close( m_listen );
+        unlink( m_path.c_str() );
+    }
+    m_listen = fd;
+    m_path = path;
+    return true;
+}
+
+void
+PricingServer::stop( void )
+{
+    m_stop = true;
+    wake();
+}
+
+void
+PricingServer::wake( void )
+{
+    char c = 0;
+    ssize_t k = write( m_wake[1], &c, 1 ); // a full pipe already means a pending wake up
+    (void) k;
+}
+
+int
+PricingServer::batchLimit( void ) const
+{
+    // as many options as can be priced in half the latency target
+    double n = 0.5 * m_target * 1000.0 / std::max( 1.0, m_nsPerOption.load() );
+    return (int) std::max( 1.0, std::min( (double) m_maxBatch, n ) );
+}
+
+void
+PricingServer::run( void )
+{
+    if (m_listen < 0)
+        return;
+
+    std::thread worker( &PricingServer::pricer, this );
+    std::vector<pollfd> fds;
+    std::vector<std::shared_ptr<Connection>> polled;
+
+    while (!m_stop)
+    {
+        fds.clear();
+        polled.clear();
+        fds.push_back( { m_wake[0], POLLIN, 0 } );
+        fds.push_back( { m_listen, POLLIN, 0 } );
+        for (auto& c : m_connections)
+        {
+            short events = 0;
+            {
+                std::lock_guard<std::mutex> guard(c.second->lock);
+                if (!c.second->eof)
+                    events |= POLLIN;
+                if (c.second->sent < c.second->out.size())
+                    events |= POLLOUT;
+            }
+            fds.push_back( { c.first, events, 0 } );
+            polled.push_back( c.second );
+        }
+
+        int timeout = -1;
+        if (!m_pending.options.empty())
+        {
+            auto due = m_pending.oldest + std::chrono::microseconds( (long) (0.5 * m_target) );
+            auto wait = std::chrono::duration_cast<std::chrono::microseconds>( due - std::chrono::steady_clock::now() ).count();
+            timeout = (wait > 0) ? (int) ((wait + 999) / 1000) : 0;
+        }
+
+        if (poll( fds.data(), fds.size(), timeout ) < 0 && errno != EINTR)
+            break;
+
+        if (fds[0].revents & POLLIN)
+        {
+            char buf[64];
+            while (read( m_wake[0], buf, sizeof(buf) ) > 0) {}
+        }
+
+        if (fds[1].revents & POLLIN)
+            accept();
+
+        for (size_t i = 2; i < fds.size(); ++i)
+        {
+            Connection& c = *polled[i - 2];
+            bool ok = true;
+            if (fds[i].revents & POLLOUT)
+                ok = drain( c );
+            if (ok && (fds[i].revents & POLLIN))
+                ok = receive( polled[i - 2] );
+            if (fds[i].revents & (POLLHUP | POLLERR | POLLNVAL))
+                ok = false;
+            if (ok)
+            {
+                // half closed, and every request it sent answered and sent
+                std::lock_guard<std::mutex> guard(c.lock);
+                ok = !(c.eof && c.waiting == 0 && c.sent == c.out.size());
+            }
+            if (!ok)
+                m_connections.erase( fds[i].fd );
+        }
+
+        if (m_pending.options.empty())
+            continue;
+
+        bool idle;
+        {
+            std::lock_guard<std::mutex> guard(m_lock);
+            idle = !m_busy && m_queue.empty();
+        }
+        bool full = (int) m_pending.options.size() >= batchLimit();
+        bool late = std::chrono::steady_clock::now() - m_pending.oldest >= std::chrono::microseconds( (long) (0.5 * m_target) );
+        if (idle || full || late)
+            flush();
+    }
+
+    if (!m_pending.options.empty())
+        flush();
+
+    {
+        std::lock_guard<std::mutex> guard(m_lock);
+        m_queue.push_back( Batch() ); // an empty batch stops the pricing thread
+    }
+    m_ready.notify_one();
+    worker.join();
+    m_connections.clear();
+}
+
+void
+PricingServer::accept( void )
+{
+    for (;;)
+    {
+        int fd = ::accept( m_listen, nullptr, nullptr );
+        if (fd < 0)
+            return;
+        if (!nonBlocking( fd ))
+        {
+            close( fd );
+            continue;
+        }
+        m_connections[fd] = std::make_shared<Connection>( fd );
+    }
+}
+
+bool
+PricingServer::receive( const std::shared_ptr<Connection>& c )
+{
+    for (;;)
+    {
+        if (c->in.size() - c->used < 65536)
+            c->in.resize( c->used + 65536 );
+
+        ssize_t k = read( c->fd, c->in.data() + c->used, c->in.size() - c->used );
+        if (k == 0)
+        {
+            // the client has finished sending; answer what it sent before closing
+            std::lock_guard<std::mutex> guard(c->lock);
+            c->eof = true;
+            break;
+        }
+        if (k < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            if (errno == EAGAIN || errno == EWOULDBLOCK)
+                break;
+            return false;
+        }
+        c->used += (size_t) k;
+    }
+
+    // parse every complete request
+    size_t at = 0;
+    while (c->used - at >= sizeof(PricingRequest))
+    {
+        PricingRequest h;
+        memcpy( &h, c->in.data() + at, sizeof(h) );
+        if (h.magic != PRICING_REQUEST_MAGIC || h.count > PRICING_MAX_OPTIONS)
+            return false;
+
+        size_t size = sizeof(h) + OptionColumns::bytes( h.count );
+        if (c->used - at < size)
+            break;
+
+        OptionColumns block( c->in.data() + at + sizeof(h), size - sizeof(h) );
+        if (!block.valid() || block.count() != h.count)
+            return false;
+
+        // requests are never split, so close the batch first if this one would overflow it
+        if (!m_pending.options.empty() && (int) (m_pending.options.size() + h.count) > batchLimit())
+            flush();
+        if (m_pending.options.empty())
+            m_pending.oldest = std::chrono::steady_clock::now();
+
+        Segment s = { c, h.id, (int) m_pending.options.size(), (int) h.count };
+        for (uint32_t i = 0; i < h.count; ++i)
+        {
+            m_pending.options.push_back( block.option( i ) );
+        }
+        m_pending.style.insert( m_pending.style.end(), block.style(), block.style() + h.count );
+        m_pending.greeks.insert( m_pending.greeks.end(), block.greeks(), block.greeks() + h.count );
+        m_pending.segments.push_back( std::move( s ) );
+        {
+            std::lock_guard<std::mutex> guard(c->lock);
+            ++c->waiting;
+        }
+        at += size;
+    }
+
+    if (at > 0)
+    {
+        memmove( c->in.data(), c->in.data() + at, c->used - at );
+        c->used -= at;
+    }
+    return true;
+}
+
+bool
+PricingServer::drain( Connection& c )
+{
+    std::lock_guard<std::mutex> guard(c.lock);
+    while (c.sent < c.out.size())
+    {
+        ssize_t k = send( c.fd, c.out.data() + c.sent, c.out.size() - c.sent, MSG_NOSIGNAL );
+        if (k > 0)
+        {
+            c.sent += (size_t) k;
+            continue;
+        }
+        if (k < 0 && errno == EINTR)
+            continue;
+        if (k < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+        {
+            // keep the queue from growing behind a client that reads, but slowly
+            if (c.sent > c.out.size() / 2)
+            {
+                c.out.erase( c.out.begin(), c.out.begin() + (long) c.sent );
+                c.sent = 0;
+            }
+            return true;
+        }
+        return false;
+    }
+    c.out.clear();
+    c.sent = 0;
+    return true;
+}
+
+void
+PricingServer::flush( void )
+{
+    {
+        std::lock_guard<std::mutex> guard(m_lock);
+        m_queue.push_back( std::move( m_pending ) );
+    }
+    m_ready.notify_one();
+    m_pending = Batch();
+}
+
+void
+PricingServer::pricer( void )
+{
+    for (;;)
+    {
+        Batch b;
+        {
+            std::unique_lock<std::mutex> guard(m_lock);
+            m_ready.wait( guard, [this] { return !m_queue.empty(); } );
+            b = std::move( m_queue.front() );
+            m_queue.pop_front();
+            if (b.options.empty())
+                return;
+            m_busy = true;
+        }
+
+        auto t0 = std::chrono::steady_clock::now();
+        price( b );
+        reply( b );
+        double ns = std::chrono::duration<double, std::nano>( std::chrono::steady_clock::now() - t0 ).count();
+
+        // moving average of the cost of one option, used to size later batches
+        double per = ns / double(b.options.size());
+        m_nsPerOption = 0.8 * m_nsPerOption.load() + 0.2 * per;
+        ++m_batches;
+        m_options += (long) b.options.size();
+
+        {
+            std::lock_guard<std::mutex> guard(m_lock);
+            m_busy = false;
+        }
+        b = Batch(); // drop the connections before waking the loop
+        wake();
+    }
+}
+
+void
+PricingServer::price( const Batch& b )
+{
+    Workspace& w = m_work;
+    uint32_t n = (uint32_t) b.options.size();
+    w.results.resize( ResultColumns::bytes( n ) );
+    w.batch = ResultColumns::create( w.results.data(), w.results.size(), n );
+
+    kernel( b, OptionModel::BlackScholes );
+    kernel( b, OptionModel::Black );
+
+    // trees, and anything with Greeks, on the scheduler's pool
+    w.index.clear();
+    w.scheduled.clear();
+    w.greeks.clear();
+    for (uint32_t i = 0; i < n; ++i)
+    {
+        const OptionSpec& o = b.options[i];
+        RecordStatus status = check( o, b.style[i] );
+        if (status != RecordStatus::Ok)
+        {
+            w.batch.status()[i] = (uint8_t) status;
+            continue;
+        }
+        if (o.model == OptionModel::BinomialTree || b.greeks[i] != 0)
+        {
+            w.index.push_back( (int) i );
+            w.scheduled.push_back( o );
+            w.greeks.push_back( b.greeks[i] );
+        }
+    }
+    if (w.scheduled.empty())
+        return;
+
+    uint32_t m = (uint32_t) w.scheduled.size();
+    w.partial.resize( ResultColumns::bytes( m ) );
+    ResultColumns partial = ResultColumns::create( w.partial.data(), w.partial.size(), m );
+    m_trees.evaluate( w.scheduled, w.greeks, partial );
+    for (uint32_t k = 0; k < m; ++k)
+    {
+        w.batch.copy( partial, k, (uint32_t) w.index[k], 1 );
+    }
+}
+
+void
+PricingServer::kernel( const Batch& b, OptionModel model )
+{
+    Workspace& w = m_work;
+    w.index.clear();
+    w.strike.clear(); w.assetPrice.clear(); w.vol.clear(); w.rate.clear(); w.T.clear(); w.yield.clear(); w.call.clear();
+
+    // gather into structure of arrays
+    for (int i = 0; i < (int) b.options.size(); ++i)
+    {
+        const OptionSpec& o = b.options[i];
+        if (o.model != model || b.greeks[i] != 0 || check( o, b.style[i] ) != RecordStatus::Ok)
+            continue;
+        w.index.push_back( i );
+        w.strike.push_back( o.strike );
+        w.assetPrice.push_back( o.assetPrice );
+        w.vol.push_back( o.vol );
+        w.rate.push_back( o.rate );
+        w.T.push_back( o.T );
+        w.yield.push_back( o.yield );
+        w.call.push_back( (o.call) ? 1 : 0 );
+    }
+
+    int n = (int) w.index.size();
+    if (n == 0)
+        return;
+
+    w.value.resize( n );
+    if (model == OptionModel::BlackScholes)
+        BatchKernels::blackScholes( n, w.strike.data(), w.assetPrice.data(), w.vol.data(), w.rate.data(), w.T.data(), w.yield.data(), w.call.data(), w.value.data() );
+    else BatchKernels::black( n, w.strike.data(), w.assetPrice.data(), w.vol.data(), w.rate.data(), w.T.data(), w.call.data(), w.value.data() );
+
+    for (int k = 0; k < n; ++k)
+    {
+        w.batch.value()[w.index[k]] = w.value[k];
+        w.batch.greeks()[w.index[k]] = 0;
+        w.batch.status()[w.index[k]] = (uint8_t) RecordStatus::Ok;
+    }
+}
+
+void
+PricingServer::reply( const Batch& b )
+{
+    for (const Segment& s : b.segments)
+    {
+        PricingResponse h;
+        memset( &h, 0, sizeof(h) );
+        h.magic = PRICING_RESPONSE_MAGIC;
+        h.count = (uint32_t) s.count;
+        h.id = s.id;
+
+        size_t size = sizeof(h) + ResultColumns::bytes( h.count );
+        m_work.out.resize( size );
+        memcpy( m_work.out.data(), &h, sizeof(h) );
+        ResultColumns out = ResultColumns::create( m_work.out.data() + sizeof(h), size - sizeof(h), h.count );
+        out.copy( m_work.batch, (uint32_t) s.first, 0, h.count );
+
+        // queued, never waited for: a client that stops reading loses its connection rather than stalling the server
+        bool ok;
+        {
+            Connection& c = *s.conn;
+            std::lock_guard<std::mutex> guard(c.lock);
+            ok = c.out.size() - c.sent + size <= PRICING_MAX_BACKLOG;
+            if (ok)
+                c.out.insert( c.out.end(), m_work.out.data(), m_work.out.data() + size );
+            --c.waiting;
+        }
+        if (!ok || !drain( *s.conn ))
+            shutdown( s.conn->fd, SHUT_RDWR );
+    }
+}
+
+//
@@ -0,0 +1,221 @@
+/* Micro Batching Pricing Server 18/10/2026
+
+ $$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$
+ $   PricingServer.h - header   $
+ $$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$
+
+ Copyright (C) 2026  W.B. Yates
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see http://www.gnu.org/licenses/
+
+ History:
+
+ Serves option prices over a Unix domain socket (see PricingProtocol.h).
+
+ run() is a poll() loop that reads requests from every connection and appends their options to one
+ pending batch. The batch is handed to a pricing thread as soon as that thread is idle, so batches grow
+ only while the server is busy, or when the batch reaches batchLimit(). Requests are read into 64 byte
+ aligned buffers and their OptionColumns are gathered straight from there. BlackScholes and Black
+ options without Greeks go through BatchKernels; tree options and any option with Greeks requested
+ go to a PricingScheduler (a work stealing pool).
+ The pricing thread queues each reply on its connection as soon as its batch completes and sends what
+ the socket takes at once, never waiting; the loop sends the rest as the client reads it (POLLOUT). So a
+ client that reads slowly holds up only its own replies, and one leaving more than 64MB of them unread
+ is disconnected. A client may half close its connection (shutdown( fd, SHUT_WR )) after its last
+ request: every complete request read is still answered, and the connection closed once its replies
+ are sent.
+
+ batchLimit() adapts to the latency target: the pricing thread keeps a moving average of the cost of one
+ option, and a batch is capped at the number of options that can be priced in half the target. A batch
+ that has waited longer than half the target is queued even if the pricing thread is still busy.
+
+ Examples
+
+    PricingServer server( 4 );               // 4 tree threads
+    server.latencyTarget( 200.0 );            // microseconds
+    if (server.listen( "/tmp/pricing.sock" ))
+        server.run();                         // until server.stop()
+ */
+
+
+#ifndef __PRICINGSERVER_H__
+#define __PRICINGSERVER_H__
+
+#include <map>
+#include <deque>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include <condition_variable>
+
+#ifndef __PRICINGPROTOCOL_H__
+#include "PricingProtocol.h"
+#endif
+
+#ifndef __PRICINGSCHEDULER_H__
+#include "PricingScheduler.h"
+#endif
+
+#ifndef __ALIGNEDALLOCATOR_H__
+#include "AlignedAllocator.h"
+#endif
+
+
+class PricingServer
+{
+public:
+
+    explicit PricingServer( int treeThreads = 0 ); // 0 uses one tree thread per core
+    ~PricingServer();
+
+    PricingServer( const PricingServer& ) = delete;
+    PricingServer& operator=( const PricingServer& ) = delete;
+
+    // bind and listen on a Unix socket path (an existing socket file is replaced); false on failure
+    bool
+    listen( const std::string& path );
+
+    // serve until stop() is called
+    void
+    run( void );
+
+    // safe from any thread and from a signal handler
+    void
+    stop( void );
+
+    double // microseconds
+    latencyTarget( void ) const { return m_target; }
+
+    void
+    latencyTarget( double microseconds ) { m_target = (microseconds > 1.0) ? microseconds : 1.0; }
+
+    int
+    maxBatch( void ) const { return m_maxBatch; }
+
+    void
+    maxBatch( int n ) { m_maxBatch = (n > 0) ? n : 1; }
+
+    int
+    batchLimit( void ) const;
+
+    long
+    batches( void ) const { return m_batches.load(); }
+
+    long
+    options( void ) const { return m_options.load(); }
+
+private:
+
+    struct Connection
+    {
+        explicit Connection( int f ): fd(f), in(), used(0), lock(), out(), sent(0), waiting(0), eof(false) {}
+        ~Connection();
+
+        int fd;
+        std::vector<char, AlignedAllocator<char>> in;  // bytes read but not yet parsed
+        size_t used;
+
+        std::mutex lock;                                // guards out and sent: the pricing thread and the loop both send
+        std::vector<char> out;                          // replies queued
+        size_t sent;                                    // bytes of out already sent
+        int waiting;                                    // requests read but not yet replied to
+        bool eof;                                       // the client has sent all it will
+    };
+
+    struct Segment
+    {
+        std::shared_ptr<Connection> conn;
+        uint64_t id;
+        int first;
+        int count;
+    };
+
+    struct Batch
+    {
+        std::vector<OptionSpec> options;
+        std::vector<uint8_t> style;
+        std::vector<uint8_t> greeks;
+        std::vector<Segment> segments;
+        std::chrono::steady_clock::time_point oldest;
+    };
+
+    // pricing thread only
+    struct Workspace
+    {
+        std::vector<double> strike, assetPrice, vol, rate, T, yield, value;
+        std::vector<unsigned char> call;
+        std::vector<int> index;
+        std::vector<OptionSpec> scheduled;
+        std::vector<uint8_t> greeks;
+        std::vector<char, AlignedAllocator<char>> results, partial, out;
+        ResultColumns batch;
+    };
+
+    void
+    accept( void );
+
+    bool // false when the connection should be closed
+    receive( const std::shared_ptr<Connection>& c );
+
+    bool // send what a connection has queued, without waiting; false when the connection has failed
+    drain( Connection& c );
+
+    void
+    flush( void );
+
+    void
+    wake( void );
+
+    void
+    pricer( void );
+
+    void
+    price( const Batch& b );
+
+    void
+    kernel( const Batch& b, OptionModel model );
+
+    void
+    reply( const Batch& b );
+
+    int m_listen;
+    int m_wake[2];                 // self pipe: stop() and the pricing thread wake the poll loop
+    std::string m_path;
+    std::map<int, std::shared_ptr<Connection>> m_connections;
+
+    Batch m_pending;
+
+    std::mutex m_lock;             // guards m_queue and m_busy
+    std::condition_variable m_ready;
+    std::deque<Batch> m_queue;
+    bool m_busy;
+
+    PricingScheduler m_trees;
+    Workspace m_work;
+    std::atomic<double> m_nsPerOption;
+    std::atomic<bool> m_stop;
+    std::atomic<long> m_batches;
+    std::atomic<long> m_options;
+    double m_target;
+    int m_maxBatch;
+};
+
+
+#endif
+
+///
@@ -0,0 +1,415 @@
+/* Pricing State Snapshot 18/10/2026
+
+ $$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$
+ $   PricingSnapshot.cpp - code   $
+ $$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$
+
+ by W.B. Yates
+ Copyright (c) W.B. Yates. All rights reserved.
+ History:
+
+ */
+
+#include <string.h>
+#include <stdio.h>
+#include <bit>
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#ifndef __PRICINGSNAPSHOT_H__
+#include "PricingSnapshot.h"
+#endif
+
+
+static_assert( sizeof(SnapshotHeader) == 128, "SnapshotHeader must be 128 bytes" );
+static_assert( sizeof(SnapshotSection) == 64, "SnapshotSection must be 64 bytes" );
+static_assert( std::endian::native == std::endian::little, "snapshots are little-endian and used in place" );
+
+namespace {
+
+const char MAGIC[8] = { 'O', 'P', 'D', 'S', 'N', 'A', 'P', 0 };
+const uint32_t VERSION = 1;
+const uint64_t ALIGN = 64;
+
+uint64_t
+fnv1a( const unsigned char* p, uint64_t n )
+{
+    uint64_t h = 14695981039346656037ULL;
+    for (uint64_t i = 0; i < n; ++i)
+    {
+        h ^= p[i];
+        h *= 1099511628211ULL;
+    }
+    return h;
+}
+
+uint64_t
+aligned( uint64_t x )
+{
+    return (x + ALIGN - 1) & ~(ALIGN - 1);
+}
+
+bool
+sameName( const char* a, const char* b )
+{
+    return strncmp( a, b, sizeof(SnapshotSection::name) - 1 ) == 0;
+}
+
+bool
+writeAt( int fd, const void* data, uint64_t bytes, uint64_t offset )
+{
+    const char* p = (const char*) data;
+    while (bytes > 0)
+    {
+        ssize_t n = pwrite( fd, p, bytes, offset );
+        if (n <= 0)
+            return false;
+        p += n;
+        bytes -= n;
+        offset += n;
+    }
+    return true;
+}
+
+}
+
+
+PricingSnapshot::PricingSnapshot( void ): m_header(), m_table(), m_checked(), m_staged(), m_path(),
+                                          m_map(nullptr), m_mapSize(0), m_written(0)
+{
+    memset( &m_header, 0, sizeof(m_header) );
+}
+
+PricingSnapshot::~PricingSnapshot()
+{
+    clear();
+}
+
+void
+PricingSnapshot::clear( void )
+{
+    if (m_map)
+        munmap( m_map, m_mapSize );
+    m_map = nullptr;
+    m_mapSize = 0;
+    m_table.clear();
+    m_checked.clear();
+    m_staged.clear();
+    m_path.clear();
+    memset( &m_header, 0, sizeof(m_header) );
+}
+
+bool
+PricingSnapshot::load( const char* path, bool verifyAll )
+{
+    clear();
+
+    int fd = open( path, O_RDONLY );
+    if (fd < 0)
+        return false;
+
+    struct stat st;
+    if (fstat( fd, &st ) != 0 || st.st_size < (off_t) sizeof(SnapshotHeader))
+    {
+        close( fd );
+        return false;
+    }
+
+    void* p = mmap( nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0 );
+    close( fd );
+    if (p == MAP_FAILED)
+        return false;
+    m_map = p;
+    m_mapSize = st.st_size;
+
+    const unsigned char* base = (const unsigned char*) p;
+    SnapshotHeader h;
+    memcpy( &h, base, sizeof(h) );
+    uint64_t tableBytes = (uint64_t) h.sections * sizeof(SnapshotSection);
+    if (memcmp( h.magic, MAGIC, sizeof(MAGIC) ) != 0 || h.version != VERSION || h.headerSize != sizeof(SnapshotHeader)
+        || h.fileSize > m_mapSize || h.tableOffset % ALIGN != 0 || h.tableOffset + tableBytes != h.fileSize
+        || fnv1a( base + h.tableOffset, tableBytes ) != h.tableChecksum)
+    {
+        clear();
+        return false;
+    }
+
+    m_table.resize( h.sections );
+    memcpy( m_table.data(), base + h.tableOffset, tableBytes );
+    for (const SnapshotSection& s : m_table)
+    {
+        if (s.offset % ALIGN != 0 || s.offset < sizeof(SnapshotHeader) || s.offset + s.bytes > h.tableOffset
+            || s.recordSize == 0 || s.bytes % s.recordSize != 0 || s.name[sizeof(s.name) - 1] != 0)
+        {
+            clear();
+            return false;
+        }
+    }
+
+    m_header = h;
+    m_path = path;
+    m_checked.assign( m_table.size(), 0 );
+    if (verifyAll)
+    {
+        for (int i = 0; i < sections(); ++i)
+        {
+            if (!verify( i ))
+            {
+                clear();
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+bool
+PricingSnapshot::verify( int i ) const
+{
+    if (m_checked[i] == 0)
+    {
+        const SnapshotSection& s = m_table[i];
+        m_checked[i] = (fnv1a( (const unsigned char*) m_map + s.offset, s.bytes ) == s.checksum) ? 1 : -1;
+    }
+    return m_checked[i] > 0;
+}
+
+const void*
+PricingSnapshot::find( const char* name, uint32_t recordSize, uint64_t& bytes ) const
+{
+    // staged sections shadow the mapped ones until they are saved
+    for (const Staged& s : m_staged)
+    {
+        if (sameName( s.name.c_str(), name ))
+        {
+            bytes = s.data.size();
+            return (s.recordSize == recordSize) ? s.data.data() : nullptr;
+        }
+    }
+    for (int i = 0; i < sections(); ++i)
+    {
+        const SnapshotSection& s = m_table[i];
+        if (sameName( s.name, name ))
+        {
+            bytes = s.bytes;
+            return (s.recordSize == recordSize && verify( i )) ? (const unsigned char*) m_map + s.offset : nullptr;
+        }
+    }
+    return nullptr;
+}
+
+bool
+PricingSnapshot::has( const char* name ) const
+{
+    for (const Staged& s : m_staged)
+    {
+        if (sameName( s.name.c_str(), name ))
+            return true;
+    }
+    for (const SnapshotSection& s : m_table)
+    {
+        if (sameName( s.name, name ))
+            return true;
+    }
+    return false;
+}
+
+void
+PricingSnapshot::stage( const char* name, const void* data, uint64_t bytes, uint32_t recordSize )
+{
+    std::string key( name, strnlen( name, sizeof(SnapshotSection::name) - 1 ) );
+    Staged* s = nullptr;
+    for (Staged& t : m_staged)
+    {
+        if (t.name == key)
+            s = &t;
+    }
+    if (!s)
+    {
+        m_staged.emplace_back();
+        s = &m_staged.back();
+        s->name = key;
+    }
+    s->data.assign( (const unsigned char*) data, (const unsigned char*) data + bytes );
+    s->recordSize = recordSize;
+}
+
+bool
+PricingSnapshot::putFile( const char* name, const char* path )
+{
+    FILE* fp = fopen( path, "rb" );
+    if (!fp)
+        return false;
+
+    std::vector<unsigned char> data;
+    unsigned char buffer[1 << 16];
+    size_t n = 0;
+    while ((n = fread( buffer, 1, sizeof(buffer), fp )) > 0)
+    {
+        data.insert( data.end(), buffer, buffer + n );
+    }
+    bool ok = ferror( fp ) == 0;
+    fclose( fp );
+    if (ok)
+        stage( name, data.data(), data.size(), 1 );
+    return ok;
+}
+
+bool
+PricingSnapshot::save( const char* path )
+{
+    bool ok = (m_map && m_path == path) ? append( path ) : writeAll( path );
+    if (ok)
+        ok = load( path );
+    return ok;
+}
+
+bool
+PricingSnapshot::compact( const char* path )
+{
+    return writeAll( path ) && load( path );
+}
+
+bool
+PricingSnapshot::append( const char* path )
+{
+    // only staged sections that differ from what is mapped
+    std::vector<SnapshotSection> table = m_table;
+    std::vector<const Staged*> changed;
+    std::vector<int> slot;
+    for (const Staged& s : m_staged)
+    {
+        uint64_t sum = fnv1a( s.data.data(), s.data.size() );
+        int found = -1;
+        for (int i = 0; i < (int) table.size(); ++i)
+        {
+            if (sameName( table[i].name, s.name.c_str() ))
+                found = i;
+        }
+        if (found >= 0 && table[found].bytes == s.data.size() && table[found].recordSize == s.recordSize
+            && table[found].checksum == sum)
+            continue;
+
+        if (found < 0)
+        {
+            table.emplace_back();
+            memset( &table.back(), 0, sizeof(SnapshotSection) );
+            memcpy( table.back().name, s.name.data(), s.name.size() );
+            found = (int) table.size() - 1;
+        }
+        table[found].bytes = s.data.size();
+        table[found].recordSize = s.recordSize;
+        table[found].checksum = sum;
+        table[found].generation = (uint32_t) (m_header.generation + 1);
+        changed.push_back( &s );
+        slot.push_back( found );
+    }
+
+    m_written = 0;
+    if (changed.empty())
+        return true;
+
+    int fd = open( path, O_WRONLY );
+    if (fd < 0)
+        return false;
+
+    // new data, then the new table, after everything the current header covers
+    uint64_t offset = aligned( m_header.fileSize );
+    bool ok = true;
+    for (size_t k = 0; k < changed.size() && ok; ++k)
+    {
+        table[slot[k]].offset = offset;
+        ok = writeAt( fd, changed[k]->data.data(), changed[k]->data.size(), offset );
+        m_written += changed[k]->data.size();
+        offset = aligned( offset + changed[k]->data.size() );
+    }
+
+    SnapshotHeader h = m_header;
+    h.generation += 1;
+    h.tableOffset = offset;
+    h.sections = (uint32_t) table.size();
+    h.tableChecksum = fnv1a( (const unsigned char*) table.data(), table.size() * sizeof(SnapshotSection) );
+    h.fileSize = offset + table.size() * sizeof(SnapshotSection);
+
+    // the header is written last, so until then the file still describes the previous snapshot
+    ok = ok && writeAt( fd, table.data(), table.size() * sizeof(SnapshotSection), offset )
+            && fdatasync( fd ) == 0
+            && writeAt( fd, &h, sizeof(h), 0 )
+            && fdatasync( fd ) == 0;
+    return (close( fd ) == 0) && ok;
+}
+
+bool
+PricingSnapshot::writeAll( const char* path )
+{
+    // the live sections: mapped ones not restaged, then the staged ones; a mapped section failing its
+    // checksum is dropped, as get() already treats it as absent, rather than written out as good
+    struct Live { const char* name; const unsigned char* data; uint64_t bytes; uint32_t recordSize; uint32_t generation; };
+    std::vector<Live> live;
+    for (int i = 0; i < sections(); ++i)
+    {
+        const SnapshotSection& s = m_table[i];
+        bool restaged = false;
+        for (const Staged& t : m_staged)
+        {
+            restaged = restaged || sameName( t.name.c_str(), s.name );
+        }
+        if (!restaged && verify( i ))
+            live.push_back( Live{ s.name, (const unsigned char*) m_map + s.offset, s.bytes, s.recordSize, s.generation } );
+    }
+    for (const Staged& t : m_staged)
+    {
+        live.push_back( Live{ t.name.c_str(), t.data.data(), t.data.size(), t.recordSize, (uint32_t) (m_header.generation + 1) } );
+    }
+
+    std::string tmp = std::string( path ) + ".tmp";
+    int fd = open( tmp.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644 );
+    if (fd < 0)
+        return false;
+
+    std::vector<SnapshotSection> table(live.size());
+    uint64_t offset = aligned( sizeof(SnapshotHeader) );
+    bool ok = true;
+    m_written = 0;
+    for (size_t k = 0; k < live.size() && ok; ++k)
+    {
+        SnapshotSection& s = table[k];
+        memset( &s, 0, sizeof(s) );
+        strncpy( s.name, live[k].name, sizeof(s.name) - 1 );
+        s.offset = offset;
+        s.bytes = live[k].bytes;
+        s.recordSize = live[k].recordSize;
+        s.generation = live[k].generation;
+        s.checksum = fnv1a( live[k].data, live[k].bytes );
+        ok = writeAt( fd, live[k].data, live[k].bytes, offset );
+        m_written += live[k].bytes;
+        offset = aligned( offset + live[k].bytes );
+    }
+
+    SnapshotHeader h;
+    memset( &h, 0, sizeof(h) );
+    memcpy( h.magic, MAGIC, sizeof(MAGIC) );
+    h.version = VERSION;
+    h.headerSize = sizeof(SnapshotHeader);
+    h.generation = m_header.generation + 1;
+    h.tableOffset = offset;
+    h.sections = (uint32_t) table.size();
+    h.tableChecksum = fnv1a( (const unsigned char*) table.data(), table.size() * sizeof(SnapshotSection) );
+    h.fileSize = offset + table.size() * sizeof(SnapshotSection);
+
+    ok = ok && writeAt( fd, table.data(), table.size() * sizeof(SnapshotSection), offset )
+            && writeAt( fd, &h, sizeof(h), 0 )
+            && fdatasync( fd ) == 0;
+    ok = (close( fd ) == 0) && ok;
+
+    // the old file, if any, is replaced in one step
+    ok = ok && rename( tmp.c_str(), path ) == 0;
+    if (!ok)
+        unlink( tmp.c_str() );
+    return ok;
+}
+
+//
@@ -0,0 +1,198 @@
+/* Pricing State Snapshot 18/10/2026
+
+ $$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$
+ $   PricingSnapshot.h - header   $
+ $$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$
+
+ Copyright (C) 2026  W.B. Yates
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see http://www.gnu.org/licenses/
+
+ History:
+
+ A file of named sections holding the derived pricing state a process would otherwise rebuild at start
+ up: chain implied vols (ChainQuote and vol arrays), calibrated HestonParams, OptionRecord result blocks,
+ ValuationCache entries, ChebyshevTable files, tree step settings. Each section is an array of fixed size
+ records of a trivially copyable type (or raw bytes); load() maps the file read-only and get() returns
+ the records in place as a span, so restoring costs a page fault per page touched, not a rebuild.
+
+ The file is versioned, little-endian and 64 byte aligned:
+
+    offset 0    SnapshotHeader (128 bytes): magic, version, generation, section table offset and checksum
+    ...         section data, each section starting on a 64 byte boundary
+    table       SnapshotSection[sections] (64 bytes each): name, offset, bytes, record size, checksum
+
+ Every section carries an FNV-1a checksum. load() checks the header and the table; a section's own
+ checksum is checked the first time it is read (or at load() with verify set), so a large snapshot is
+ usable as soon as it is mapped.
+
+ put() stages a section to be written. save() to the file that is loaded is incremental: staged sections
+ whose contents differ from the mapped ones are appended, then a new table, and finally the header is
+ rewritten to point at it, so an interrupted save leaves the previous snapshot intact. Sections not
+ staged stay where they are. Superseded data is left in the file until compact(). Saving to any other
+ path writes a complete new file, without any section that fails its checksum.
+
+ Examples
+
+    PricingSnapshot snap;
+    snap.load( "pricing.snap" );                                 // false the first time
+    std::span<const double> vols = snap.get<double>( "spx/vols" );
+    if (vols.empty())
+        ...                                                      // rebuild, then
+    snap.put<double>( "spx/vols", vols );
+    snap.save( "pricing.snap" );                                 // appends only what changed
+ */
+
+
+#ifndef __PRICINGSNAPSHOT_H__
+#define __PRICINGSNAPSHOT_H__
+
+#include <span>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <type_traits>
+
+
+struct SnapshotHeader
+{
+    char     magic[8];        // "OPDSNAP"
+    uint32_t version;
+    uint32_t headerSize;
+    uint64_t generation;      // incremented by every save
+    uint64_t tableOffset;     // bytes from start of file
+    uint32_t sections;
+    uint32_t reserved0;
+    uint64_t tableChecksum;   // FNV-1a of the section table
+    uint64_t fileSize;        // bytes in use, ending with the table
+    char     reserved[128 - 56];
+};
+
+struct SnapshotSection
+{
+    char     name[32];        // nul terminated
+    uint64_t offset;          // bytes from start of file, a multiple of 64
+    uint64_t bytes;
+    uint64_t checksum;        // FNV-1a of the section's bytes
+    uint32_t recordSize;      // 1 for raw bytes
+    uint32_t generation;      // save that wrote it
+};
+
+
+class PricingSnapshot
+{
+public:
+
+    PricingSnapshot( void );
+    ~PricingSnapshot();
+
+    PricingSnapshot( const PricingSnapshot& ) = delete;
+    PricingSnapshot& operator=( const PricingSnapshot& ) = delete;
+
+    bool // map a file written by save(); with verify every section checksum is checked now
+    load( const char* path, bool verify = false );
+
+    void // unmap and drop anything staged
+    clear( void );
+
+    // the records of a section, in place; empty if absent, of another record size, or corrupt
+    template <typename T>
+    std::span<const T>
+    get( const char* name ) const
+    {
+        static_assert( std::is_trivially_copyable<T>::value, "snapshot records must be trivially copyable" );
+        uint64_t bytes = 0;
+        const void* p = find( name, sizeof(T), bytes );
+        return (p) ? std::span<const T>( (const T*) p, bytes / sizeof(T) ) : std::span<const T>();
+    }
+
+    // raw bytes of a section (a ChebyshevTable file for ChebyshevTable::attach, say)
+    std::span<const unsigned char>
+    bytes( const char* name ) const { return get<unsigned char>( name ); }
+
+    template <typename T>
+    void
+    put( const char* name, std::span<const T> records )
+    {
+        static_assert( std::is_trivially_copyable<T>::value, "snapshot records must be trivially copyable" );
+        stage( name, records.data(), records.size() * sizeof(T), sizeof(T) );
+    }
+
+    template <typename T>
+    void
+    put( const char* name, const std::vector<T>& records ) { put( name, std::span<const T>( records ) ); }
+
+    // stage a file's contents as raw bytes
+    bool
+    putFile( const char* name, const char* path );
+
+    bool // write the mapped and staged sections; incremental when path is the loaded file
+    save( const char* path );
+
+    bool // rewrite path with only the live sections; corrupt ones are dropped
+    compact( const char* path );
+
+    bool
+    has( const char* name ) const;
+
+    int
+    sections( void ) const { return (int) m_table.size(); }
+
+    const SnapshotSection&
+    section( int i ) const { return m_table[i]; }
+
+    uint64_t
+    generation( void ) const { return m_header.generation; }
+
+    uint64_t // section bytes appended by the last save()
+    written( void ) const { return m_written; }
+
+private:
+
+    struct Staged
+    {
+        std::string name;
+        std::vector<unsigned char> data;
+        uint32_t recordSize;
+    };
+
+    const void*
+    find( const char* name, uint32_t recordSize, uint64_t& bytes ) const;
+
+    void
+    stage( const char* name, const void* data, uint64_t bytes, uint32_t recordSize );
+
+    bool
+    verify( int i ) const;
+
+    bool
+    writeAll( const char* path );
+
+    bool
+    append( const char* path );
+
+    SnapshotHeader m_header;
+    std::vector<SnapshotSection> m_table;
+    mutable std::vector<char> m_checked;   // per section: 0 unchecked, 1 good, -1 bad
+    std::vector<Staged> m_staged;
+    std::string m_path;
+    void* m_map;
+    uint64_t m_mapSize;
+    uint64_t m_written;
+};
+
+
+#endif
+
+///
@@ -0,0 +1,655 @@
+/* Multi-process Scenario Revaluation 18/10/2026
+
+ $$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$
+ $   ScenarioCluster.cpp - code   $
+ $$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$
+
+ by W.B. Yates
+ Copyright (c) W.B. Yates. All rights reserved.
+ History:
+
+ */
+
+#include <errno.h>
+#include <poll.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <signal.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <math.h>
+#include <chrono>
+#include <algorithm>
+
+#ifndef __SCENARIOCLUSTER_H__
+#include "ScenarioCluster.h"
+#endif
+
+
+namespace {
+
+double
+seconds( void )
+{
+    return std::chrono::duration<double>( std::chrono::steady_clock::now().time_since_epoch() ).count();
+}
+
+// a Unix socket path, or host:port for TCP; listening sockets are non blocking
+int
+openSocket( const std::string& address, bool server )
+{
+    size_t colon = address.rfind( ':' );
+    if (address.find( '/' ) != std::string::npos || colon == std::string::npos)
+    {
+        sockaddr_un addr;
+        memset( &addr, 0, sizeof(addr) );
+        if (address.empty() || address.size() >= sizeof(addr.sun_path))
+            return -1;
+        addr.sun_family = AF_UNIX;
+        memcpy( addr.sun_path, address.c_str(), address.size() );
+
+        int fd = socket( AF_UNIX, SOCK_STREAM, 0 );
+        if (fd < 0)
+            return -1;
+        if (server)
+            unlink( address.c_str() );
+        bool ok = (server) ? bind( fd, (const sockaddr*) &addr, sizeof(addr) ) == 0 && ::listen( fd, 128 ) == 0
+                           : ::connect( fd, (const sockaddr*) &addr, sizeof(addr) ) == 0;
+        if (!ok)
+        {
+            close( fd );
+            return -1;
+        }
+        return fd;
+    }
+
+    std::string host = address.substr( 0, colon ), port = address.substr( colon + 1 );
+    addrinfo hints, *list = nullptr;
+    memset( &hints, 0, sizeof(hints) );
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    hints.ai_flags = (server) ? AI_PASSIVE : 0;
+    if (getaddrinfo( (host.empty()) ? nullptr : host.c_str(), port.c_str(), &hints, &list ) != 0)
+        return -1;
+
+    int fd = -1;
+    for (addrinfo* a = list; a && fd < 0; a = a->ai_next)
+    {
+        fd = socket( a->ai_family, a->ai_socktype, a->ai_protocol );
+        if (fd < 0)
+            continue;
+        int one = 1;
+        setsockopt( fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one) );
+        setsockopt( fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one) );
+        bool ok = (server) ? bind( fd, a->ai_addr, a->ai_addrlen ) == 0 && ::listen( fd, 128 ) == 0
+                           : ::connect( fd, a->ai_addr, a->ai_addrlen ) == 0;
+        if (!ok)
+        {
+            close( fd );
+            fd = -1;
+        }
+    }
+    freeaddrinfo( list );
+    return fd;
+}
+
+bool
+readAll( int fd, void* buf, size_t n )
+{
+    char* p = (char*) buf;
+    while (n > 0)
+    {
+        ssize_t k = read( fd, p, n );
+        if (k < 0 && errno == EINTR)
+            continue;
+        if (k <= 0)
+            return false;
+        p += k;
+        n -= (size_t) k;
+    }
+    return true;
+}
+
+bool
+writeAll( int fd, const void* buf, size_t n )
+{
+    const char* p = (const char*) buf;
+    while (n > 0)
+    {
+        ssize_t k = send( fd, p, n, MSG_NOSIGNAL );
+        if (k < 0 && errno == EINTR)
+            continue;
+        if (k <= 0)
+            return false;
+        p += k;
+        n -= (size_t) k;
+    }
+    return true;
+}
+
+// reads and writes on a worker's socket give up after seconds
+void
+timeouts( int fd, double seconds )
+{
+    timeval tv;
+    tv.tv_sec = (time_t) seconds;
+    tv.tv_usec = (suseconds_t) ((seconds - floor( seconds )) * 1E6);
+    setsockopt( fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv) );
+    setsockopt( fd, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv) );
+}
+
+// revalues the unit in a work message; the one place either side does it
+void
+revalueUnit( PortfolioVaR& var, const std::vector<char>& message, std::vector<Position>& positions,
+             Matrix<double>& scenarios, ScenarioResult& result, std::vector<double>& pnl )
+{
+    ScenarioWork h;
+    memcpy( &h, message.data(), sizeof(h) );
+
+    const char* p = message.data() + sizeof(h);
+    positions.resize( h.positions );
+    memcpy( (void*) positions.data(), p, h.positions * sizeof(Position) );
+    p += h.positions * sizeof(Position);
+
+    scenarios.resize( h.scenarios, h.factors, 0.0 );
+    for (uint32_t s = 0; s < h.scenarios; ++s)
+    {
+        memcpy( &scenarios[s][0], p, h.factors * sizeof(double) );
+        p += h.factors * sizeof(double);
+    }
+
+    var.positions( positions );
+    var.scenarios( scenarios );
+    var.screenThreshold( h.threshold );
+    var.singlePrecision( h.single != 0 );
+    pnl = var.revalue();
+
+    memset( &result, 0, sizeof(result) );
+    result.magic = SCENARIO_RESULT_MAGIC;
+    result.scenarios = h.scenarios;
+    result.unit = h.unit;
+    result.full = var.fullRevaluations();
+    result.screened = var.screened();
+}
+
+}
+
+
+ScenarioCoordinator::ScenarioCoordinator( void ): m_positions(),
+                                                  m_scenarios(),
+                                                  m_blockPnl(),
+                                                  m_pnl(),
+                                                  m_sorted(),
+                                                  m_workers(),
+                                                  m_queue(),
+                                                  m_message(),
+                                                  m_reply(),
+                                                  m_local(1),
+                                                  m_listen(-1),
+                                                  m_path(),
+                                                  m_threshold(0.0),
+                                                  m_timeout(600.0),
+                                                  m_unitScenarios(1024),
+                                                  m_unitPositions(256),
+                                                  m_single(false),
+                                                  m_full(0),
+                                                  m_screened(0),
+                                                  m_units(0),
+                                                  m_localUnits(0),
+                                                  m_reassigned(0)
+{
+}
+
+ScenarioCoordinator::~ScenarioCoordinator()
+{
+    // a closed connection is a worker's signal to exit
+    for (Worker& w : m_workers)
+    {
+        close( w.fd );
+    }
+    for (Worker& w : m_workers)
+    {
+        if (w.pid > 0)
+            waitpid( w.pid, nullptr, 0 );
+    }
+    if (m_listen >= 0)
+        close( m_listen );
+    if (!m_path.empty())
+        unlink( m_path.c_str() );
+}
+
+bool
+ScenarioCoordinator::listen( const std::string& address )
+{
+    int fd = openSocket( address, true );
+    int flags = (fd >= 0) ? fcntl( fd, F_GETFL, 0 ) : -1;
+    if (flags < 0 || fcntl( fd, F_SETFL, flags | O_NONBLOCK ) != 0)
+    {
+        if (fd >= 0)
+            close( fd );
+        return false;
+    }
+
+    if (m_listen >= 0)
+        close( m_listen );
+    if (!m_path.empty())
+        unlink( m_path.c_str() );
+    m_listen = fd;
+    m_path = (address.find( '/' ) != std::string::npos || address.find( ':' ) == std::string::npos) ? address : std::string();
+    return true;
+}
+
+int
+ScenarioCoordinator::spawn( int workers, int threads )
+{
+    int started = 0;
+    for (int i = 0; i < workers; ++i)
+    {
+        int sv[2];
+        if (socketpair( AF_UNIX, SOCK_STREAM, 0, sv ) != 0)
+            break;
+
+        pid_t pid = fork();
+        if (pid < 0)
+        {
+            close( sv[0] );
+            close( sv[1] );
+            break;
+        }
+        if (pid == 0)
+        {
+            // the child keeps only its own end
+            close( sv[0] );
+            for (Worker& w : m_workers)
+            {
+                close( w.fd );
+            }
+            if (m_listen >= 0)
+                close( m_listen );
+            ScenarioWorker worker( threads );
+            bool ok = worker.serve( sv[1] );
+            _exit( (ok) ? 0 : 1 );
+        }
+
+        close( sv[1] );
+        timeouts( sv[0], m_timeout );
+        m_workers.push_back( Worker{ sv[0], pid, -1, 0.0 } );
+        ++started;
+    }
+    return started;
+}
+
+void
+ScenarioCoordinator::accept( void )
+{
+    if (m_listen < 0)
+        return;
+
+    int fd = -1;
+    while ((fd = ::accept( m_listen, nullptr, nullptr )) >= 0)
+    {
+        // accepted sockets are blocking, with timeouts
+        int flags = fcntl( fd, F_GETFL, 0 );
+        fcntl( fd, F_SETFL, flags & ~O_NONBLOCK );
+        int one = 1;
+        setsockopt( fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one) );
+        timeouts( fd, m_timeout );
+        m_workers.push_back( Worker{ fd, 0, -1, 0.0 } );
+    }
+}
+
+void
+ScenarioCoordinator::drop( size_t i )
+{
+    Worker& w = m_workers[i];
+    if (w.unit >= 0)
+    {
+        m_queue.push_front( w.unit );
+        ++m_reassigned;
+    }
+    close( w.fd );
+    if (w.pid > 0)
+    {
+        kill( w.pid, SIGKILL );
+        waitpid( w.pid, nullptr, 0 );
+    }
+    m_workers.erase( m_workers.begin() + i );
+}
+
+void
+ScenarioCoordinator::build( long unit )
+{
+    int nPos  = (int) m_positions.size();
+    int nScen = m_scenarios.rows();
+    int us = std::max( 1, m_unitScenarios );
+    int up = std::max( 1, m_unitPositions );
+    int scenBlocks = (nScen + us - 1) / us;
+
+    int pb = (int) (unit / scenBlocks), sb = (int) (unit % scenBlocks);
+    int s0 = sb * us, s1 = std::min( nScen, s0 + us );
+    int p0 = pb * up, p1 = std::min( nPos, p0 + up );
+
+    // only the scenario columns these positions use, renumbered in order of first use
+    std::vector<int> column( m_scenarios.cols(), -1 );
+    std::vector<int> used;
+    std::vector<Position> positions( m_positions.begin() + p0, m_positions.begin() + p1 );
+    for (Position& p : positions)
+    {
+        for (int* f : { &p.spotFactor, &p.volFactor, &p.rateFactor })
+        {
+            if (*f < 0 || *f >= m_scenarios.cols())
+            {
+                *f = -1;
+                continue;
+            }
+            if (column[*f] < 0)
+            {
+                column[*f] = (int) used.size();
+                used.push_back( *f );
+            }
+            *f = column[*f];
+        }
+    }
+    uint32_t factors = std::max( (uint32_t) used.size(), 1u );
+
+    ScenarioWork h;
+    memset( &h, 0, sizeof(h) );
+    h.magic = SCENARIO_WORK_MAGIC;
+    h.positions = (uint32_t) positions.size();
+    h.scenarios = (uint32_t) (s1 - s0);
+    h.factors = factors;
+    h.unit = (uint64_t) unit;
+    h.threshold = m_threshold;
+    h.single = m_single;
+
+    m_message.resize( sizeof(h) + positions.size() * sizeof(Position) + (size_t) h.scenarios * factors * sizeof(double) );
+    char* p = m_message.data();
+    memcpy( p, &h, sizeof(h) );
+    p += sizeof(h);
+    memcpy( p, (const void*) positions.data(), positions.size() * sizeof(Position) );
+    p += positions.size() * sizeof(Position);
+    for (int s = s0; s < s1; ++s)
+    {
+        for (uint32_t k = 0; k < factors; ++k)
+        {
+            double x = (k < used.size()) ? m_scenarios[s][used[k]] : 0.0;
+            memcpy( p, &x, sizeof(x) );
+            p += sizeof(x);
+        }
+    }
+}
+
+bool
+ScenarioCoordinator::send( Worker& w, long unit )
+{
+    build( unit );
+    if (!writeAll( w.fd, m_message.data(), m_message.size() ))
+        return false;
+    w.unit = unit;
+    w.since = seconds();
+    return true;
+}
+
+bool
+ScenarioCoordinator::receive( Worker& w )
+{
+    ScenarioResult h;
+    if (w.unit < 0 || !readAll( w.fd, &h, sizeof(h) ) || h.magic != SCENARIO_RESULT_MAGIC || h.unit != (uint64_t) w.unit)
+        return false;
+
+    int nScen = m_scenarios.rows();
+    int us = std::max( 1, m_unitScenarios );
+    int sb = (int) (w.unit % ((nScen + us - 1) / us));
+    if ((int) h.scenarios != std::min( nScen, (sb + 1) * us ) - sb * us)
+        return false;
+
+    m_reply.resize( h.scenarios );
+    if (!readAll( w.fd, m_reply.data(), h.scenarios * sizeof(double) ))
+        return false;
+
+    store( w.unit, m_reply.data(), h.full, h.screened );
+    w.unit = -1;
+    return true;
+}
+
+void
+ScenarioCoordinator::store( long unit, const double* pnl, int64_t full, int64_t screened )
+{
+    int nScen = m_scenarios.rows();
+    int us = std::max( 1, m_unitScenarios );
+    int scenBlocks = (nScen + us - 1) / us;
+    int pb = (int) (unit / scenBlocks), s0 = (int) (unit % scenBlocks) * us;
+    int s1 = std::min( nScen, s0 + us );
+
+    Matrix<double>::Row out = m_blockPnl[pb];
+    for (int s = s0; s < s1; ++s)
+    {
+        out[s] = pnl[s - s0];
+    }
+    m_full += full;
+    m_screened += screened;
+}
+
+const std::vector<double>&
+ScenarioCoordinator::revalue( void )
+{
+    int nPos  = (int) m_positions.size();
+    int nScen = m_scenarios.rows();
+
+    m_pnl.assign( nScen, 0.0 );
+    m_sorted.clear();
+    m_full = 0;
+    m_screened = 0;
+    m_units = 0;
+    m_localUnits = 0;
+    m_reassigned = 0;
+    if (nPos == 0 || nScen == 0)
+        return m_pnl;
+
+    int us = std::max( 1, m_unitScenarios );
+    int up = std::max( 1, m_unitPositions );
+    int scenBlocks = (nScen + us - 1) / us;
+    int posBlocks  = (nPos + up - 1) / up;
+    m_units = (long) scenBlocks * posBlocks;
+
+    m_blockPnl.resize( posBlocks, nScen, 0.0 );
+    m_queue.clear();
+    for (long u = 0; u < m_units; ++u)
+    {
+        m_queue.push_back( u );
+    }
+
+    std::vector<pollfd> fds;
+    ScenarioResult result;
+    std::vector<Position> positions;
+    Matrix<double> scenarios;
+    long remaining = m_units;
+    while (remaining > 0)
+    {
+        accept();
+
+        // a unit for each idle worker
+        for (size_t i = 0; i < m_workers.size() && !m_queue.empty(); )
+        {
+            if (m_workers[i].unit >= 0)
+            {
+                ++i;
+                continue;
+            }
+            long u = m_queue.front();
+            m_queue.pop_front();
+            if (send( m_workers[i], u ))
+            {
+                ++i;
+                continue;
+            }
+            m_queue.push_front( u );
+            drop( i );
+        }
+
+        // nobody to give work to: take the next unit here, then look again for workers
+        if (m_workers.empty())
+        {
+            long u = m_queue.front();
+            m_queue.pop_front();
+            build( u );
+            revalueUnit( m_local, m_message, positions, scenarios, result, m_reply );
+            store( u, m_reply.data(), result.full, result.screened );
+            ++m_localUnits;
+            --remaining;
+            continue;
+        }
+
+        // every worker is watched: a busy one for its result, an idle one only for hanging up
+        fds.clear();
+        for (Worker& w : m_workers)
+        {
+            fds.push_back( pollfd{ w.fd, POLLIN, 0 } );
+        }
+        if (m_listen >= 0)
+            fds.push_back( pollfd{ m_listen, POLLIN, 0 } );
+
+        int ready = poll( fds.data(), fds.size(), 100 );
+        if (ready < 0 && errno != EINTR)
+            break;
+
+        double now = seconds();
+        for (size_t i = m_workers.size(); i-- > 0; )
+        {
+            Worker& w = m_workers[i];
+            if (fds[i].revents & (POLLIN | POLLHUP | POLLERR))
+            {
+                if (receive( w ))
+                    --remaining;
+                else
+                    drop( i );
+            }
+            else if (w.unit >= 0 && now - w.since > m_timeout)
+                drop( i );
+        }
+    }
+
+    // position blocks summed in a fixed order, whoever revalued them
+    for (int b = 0; b < posBlocks; ++b)
+    {
+        for (int s = 0; s < nScen; ++s)
+        {
+            m_pnl[s] += m_blockPnl[b][s];
+        }
+    }
+
+    m_sorted = m_pnl;
+    std::sort( m_sorted.begin(), m_sorted.end() );
+    return m_pnl;
+}
+
+int
+ScenarioCoordinator::tailIndex( double confidence ) const
+{
+    int n = (int) m_sorted.size();
+    int k = (int) floor( (1.0 - confidence) * n );
+    return std::max( 0, std::min( n - 1, k ) );
+}
+
+double
+ScenarioCoordinator::VaR( double confidence ) const
+{
+    if (m_sorted.empty())
+        return 0.0;
+    return -m_sorted[tailIndex( confidence )];
+}
+
+double
+ScenarioCoordinator::expectedShortfall( double confidence ) const
+{
+    if (m_sorted.empty())
+        return 0.0;
+
+    int k = tailIndex( confidence );
+    double sum = 0.0;
+    for (int i = 0; i <= k; ++i)
+    {
+        sum += m_sorted[i];
+    }
+    return -sum / double(k + 1);
+}
+
+
+ScenarioWorker::ScenarioWorker( int threads ): m_var(threads),
+                                               m_positions(),
+                                               m_scenarios(),
+                                               m_message(),
+                                               m_fd(-1),
+                                               m_units(0)
+{
+}
+
+ScenarioWorker::~ScenarioWorker()
+{
+    if (m_fd >= 0)
+        close( m_fd );
+}
+
+bool
+ScenarioWorker::connect( const std::string& address )
+{
+    if (m_fd >= 0)
+        close( m_fd );
+    m_fd = openSocket( address, false );
+    return m_fd >= 0;
+}
+
+bool
+ScenarioWorker::serve( int fd )
+{
+    if (m_fd >= 0 && m_fd != fd)
+        close( m_fd );
+    m_fd = fd;
+    return serve();
+}
+
+bool
+ScenarioWorker::serve( void )
+{
+    if (m_fd < 0)
+        return false;
+
+    ScenarioResult result;
+    std::vector<double> pnl;
+    for (;;)
+    {
+        ScenarioWork h;
+        ssize_t k = 0;
+        while ((k = read( m_fd, &h, 1 )) < 0 && errno == EINTR)
+            ;
+        // the coordinator closing between units is the normal end
+        if (k == 0)
+            break;
+        if (k < 0 || !readAll( m_fd, (char*) &h + 1, sizeof(h) - 1 ))
+            return false;
+
+        uint64_t cells = (uint64_t) h.scenarios * h.factors;
+        if (h.magic != SCENARIO_WORK_MAGIC || h.factors == 0 || cells > SCENARIO_MAX_CELLS || h.positions > SCENARIO_MAX_CELLS)
+            return false;
+
+        m_message.resize( sizeof(h) + h.positions * sizeof(Position) + cells * sizeof(double) );
+        memcpy( m_message.data(), &h, sizeof(h) );
+        if (!readAll( m_fd, m_message.data() + sizeof(h), m_message.size() - sizeof(h) ))
+            return false;
+
+        revalueUnit( m_var, m_message, m_positions, m_scenarios, result, pnl );
+        if (!writeAll( m_fd, &result, sizeof(result) ) || !writeAll( m_fd, pnl.data(), pnl.size() * sizeof(double) ))
+            return false;
+        ++m_units;
+    }
+    close( m_fd );
+    m_fd = -1;
+    return true;
+}
+
+//
@@ -0,0 +1,265 @@
+/* Multi-process Scenario Revaluation 18/10/2026
+
+ $$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$
+ $   ScenarioCluster.h - header   $
+ $$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$
+
+ Copyright (C) 2026  W.B. Yates
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see http://www.gnu.org/licenses/
+
+ History:
+
+ PortfolioVaR's full revaluation spread over worker processes, on one machine or several.
+
+ A ScenarioCoordinator holds the positions and scenarios and cuts the (scenario x position) grid into
+ units, as PortfolioVaR cuts it into tiles but larger. Each unit is sent to a ScenarioWorker as a
+ self contained job: its positions, with their factor indices renumbered, and only the scenario columns
+ they use over its scenario rows, so no worker holds the whole book or the whole scenario matrix. The
+ worker revalues it with a PortfolioVaR of its own (on its own threads) and streams the unit's P&L vector
+ back. Unit P&L is kept per position block and summed in a fixed order, so the result is the same
+ whichever workers computed which units, and however many there were.
+
+ Workers are local processes started by spawn(), each on one end of a socketpair, or ScenarioWorker
+ processes elsewhere (see ScenarioDaemon.cpp) which connect() to the address the coordinator listen()s
+ on: a Unix socket path, or host:port for TCP. Workers may join while a revaluation is running. Each
+ worker has one unit at a time. A worker which closes its connection, sends a malformed reply or takes
+ longer than workerTimeout() over a unit is dropped (a spawned one is killed) and its unit goes back to
+ the front of the queue. With no workers left the coordinator revalues the remaining units itself.
+
+ Messages are a 64 byte header followed by the data, little-endian and sent as laid out in memory, so
+ coordinator and workers must be built from the same sources:
+
+    coordinator -> worker   ScenarioWork, Position[positions], double[scenarios * factors] (row major)
+    worker -> coordinator   ScenarioResult, double[scenarios]
+
+ Examples
+
+    ScenarioCoordinator c;
+    c.positions( book );              // std::vector<Position>
+    c.scenarios( history );           // Matrix<double>, rows are scenarios
+    c.spawn( 4, 2 );                  // four local worker processes of two threads each
+    c.listen( "0.0.0.0:7070" );       // and any that connect from other machines
+    c.revalue();
+    std::cout << "99% VaR is " << c.VaR(0.99) << std::endl;
+
+    // on another machine
+    ScenarioWorker w( 8 );
+    if (w.connect( "risk01:7070" ))
+        w.serve();
+ */
+
+
+#ifndef __SCENARIOCLUSTER_H__
+#define __SCENARIOCLUSTER_H__
+
+#include <deque>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <sys/types.h>
+
+#ifndef __PORTFOLIOVAR_H__
+#include "PortfolioVaR.h"
+#endif
+
+
+const uint32_t SCENARIO_WORK_MAGIC   = 0x4b52574f; // "OWRK"
+const uint32_t SCENARIO_RESULT_MAGIC = 0x5345524f; // "ORES"
+const uint32_t SCENARIO_MAX_CELLS    = 1u << 26;   // scenario values per unit
+
+
+struct ScenarioWork
+{
+    uint32_t magic;
+    uint32_t positions;   // Position records that follow
+    uint32_t scenarios;   // rows of the scenario block that follows
+    uint32_t factors;     // its columns
+    uint64_t unit;        // echoed in the result
+    double   threshold;   // PortfolioVaR::screenThreshold
+    uint8_t  single;      // PortfolioVaR::singlePrecision
+    uint8_t  reserved[31];
+};
+
+struct ScenarioResult
+{
+    uint32_t magic;
+    uint32_t scenarios;   // P&L values that follow
+    uint64_t unit;
+    int64_t  full;        // cells fully revalued
+    int64_t  screened;    // cells taken from the delta-gamma-vega estimate
+    uint8_t  reserved[32];
+};
+
+static_assert( sizeof(ScenarioWork) == 64 && sizeof(ScenarioResult) == 64, "scenario protocol headers must be 64 bytes" );
+
+
+class ScenarioCoordinator
+{
+public:
+
+    ScenarioCoordinator( void );
+    ~ScenarioCoordinator();  // disconnects the workers, which exit
+
+    ScenarioCoordinator( const ScenarioCoordinator& ) = delete;
+    ScenarioCoordinator& operator=( const ScenarioCoordinator& ) = delete;
+
+    bool // accept workers on a Unix socket path, or host:port for TCP
+    listen( const std::string& address );
+
+    int // start local worker processes of threads threads each; returns how many started
+    spawn( int workers, int threads = 1 );
+
+    int
+    workers( void ) const { return (int) m_workers.size(); }
+
+    void
+    positions( const std::vector<Position>& p ) { m_positions = p; }
+
+    const std::vector<Position>&
+    positions( void ) const { return m_positions; }
+
+    void
+    scenarios( const Matrix<double>& s ) { m_scenarios = s; }
+
+    const Matrix<double>&
+    scenarios( void ) const { return m_scenarios; }
+
+    void
+    screenThreshold( double t ) { m_threshold = t; }
+
+    void
+    singlePrecision( bool on ) { m_single = on; }
+
+    // unit dimensions of the (scenario x position) grid
+    void
+    unitSize( int scenarios, int positions ) { m_unitScenarios = scenarios; m_unitPositions = positions; }
+
+    // seconds a worker may take over one unit
+    void
+    workerTimeout( double seconds ) { m_timeout = seconds; }
+
+    // full revaluation over the workers; returns the portfolio P&L for each scenario
+    const std::vector<double>&
+    revalue( void );
+
+    const std::vector<double>&
+    pnl( void ) const { return m_pnl; }
+
+    double // as PortfolioVaR::VaR
+    VaR( double confidence ) const;
+
+    double // as PortfolioVaR::expectedShortfall
+    expectedShortfall( double confidence ) const;
+
+    long fullRevaluations( void ) const { return m_full; }
+    long screened( void ) const { return m_screened; }
+    long units( void ) const { return m_units; }            // of the last revalue()
+    long localUnits( void ) const { return m_localUnits; }  // revalued by the coordinator itself
+    long reassigned( void ) const { return m_reassigned; }  // units taken back from a dropped worker
+
+private:
+
+    struct Worker
+    {
+        int fd;
+        pid_t pid;      // spawned process, 0 for a connected one
+        long unit;      // in progress, -1 for none
+        double since;   // when it was sent
+    };
+
+    void
+    accept( void );
+
+    void
+    drop( size_t w );
+
+    bool
+    send( Worker& w, long unit );
+
+    bool
+    receive( Worker& w );
+
+    void
+    build( long unit );
+
+    void
+    store( long unit, const double* pnl, int64_t full, int64_t screened );
+
+    int
+    tailIndex( double confidence ) const;
+
+    std::vector<Position> m_positions;
+    Matrix<double> m_scenarios;
+    Matrix<double> m_blockPnl;         // position block x scenario
+    std::vector<double> m_pnl;
+    std::vector<double> m_sorted;
+
+    std::vector<Worker> m_workers;
+    std::deque<long> m_queue;
+    std::vector<char> m_message;       // a unit's work message
+    std::vector<double> m_reply;
+    PortfolioVaR m_local;              // for units nobody else can take
+    int m_listen;
+    std::string m_path;                // of a Unix listening socket
+
+    double m_threshold;
+    double m_timeout;
+    int m_unitScenarios;
+    int m_unitPositions;
+    bool m_single;
+    long m_full;
+    long m_screened;
+    long m_units;
+    long m_localUnits;
+    long m_reassigned;
+};
+
+
+class ScenarioWorker
+{
+public:
+
+    explicit ScenarioWorker( int threads = 0 ); // 0 uses one thread per core
+    ~ScenarioWorker();
+
+    ScenarioWorker( const ScenarioWorker& ) = delete;
+    ScenarioWorker& operator=( const ScenarioWorker& ) = delete;
+
+    bool // to a coordinator's listen() address
+    connect( const std::string& address );
+
+    bool // revalue units until the coordinator disconnects; false on an error
+    serve( void );
+
+    bool // the same on a connected socket, which is then owned by the worker
+    serve( int fd );
+
+    long
+    units( void ) const { return m_units; }
+
+private:
+
+    PortfolioVaR m_var;
+    std::vector<Position> m_positions;
+    Matrix<double> m_scenarios;
+    std::vector<char> m_message;
+    int m_fd;
+    long m_units;
+};
+
+
+#endif
+
+///
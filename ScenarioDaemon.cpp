@@ -0,0 +1,51 @@
+/* Scenario Worker Daemon 18/10/2026
+
+ $$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$
+ $   ScenarioDaemon.cpp - code   $
+ $$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$
+
+ by W.B. Yates
+ Copyright (c) W.B. Yates. All rights reserved.
+ History:
+
+ Runs a ScenarioWorker for a ScenarioCoordinator on another machine, until the coordinator disconnects.
+ Built as its own program, e.g.
+
+    c++ -std=c++20 -O3 ScenarioDaemon.cpp ScenarioCluster.cpp PortfolioVaR.cpp OptionPricer.cpp TaskPool.cpp \
+        BlackScholes.cpp Black.cpp BinomialTree.cpp BaroneAdesiWhaley.cpp PriceStats.cpp -o scenariod -lpthread
+    ./scenariod risk01:7070 8
+
+ usage: scenariod <address> [threads]
+ */
+
+#include <iostream>
+#include <signal.h>
+#include <stdlib.h>
+
+#ifndef __SCENARIOCLUSTER_H__
+#include "ScenarioCluster.h"
+#endif
+
+int
+main( int argc, const char* argv[] )
+{
+    if (argc < 2)
+    {
+        std::cerr << "usage: " << argv[0] << " <address> [threads]" << std::endl;
+        return 1;
+    }
+
+    signal( SIGPIPE, SIG_IGN );
+    ScenarioWorker w( (argc > 2) ? atoi( argv[2] ) : 0 );
+    if (!w.connect( argv[1] ))
+    {
+        std::cerr << "cannot connect to " << argv[1] << std::endl;
+        return 1;
+    }
+
+    bool ok = w.serve();
+    std::cout << w.units() << " units revalued" << std::endl;
+    return (ok) ? 0 : 1;
+}
+
+//
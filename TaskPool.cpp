@@ -0,0 +1,196 @@
+/* Work Stealing Task Pool 18/10/2026
+
+ $$$$$$$$$$$$$$$$$$$$$$$$$$$
+ $   TaskPool.cpp - code   $
+ $$$$$$$$$$$$$$$$$$$$$$$$$$$
+
+ by W.B. Yates
+ Copyright (c) W.B. Yates. All rights reserved.
+ History:
+
+ */
+
+#include <algorithm>
+#include <numeric>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#ifndef __TASKPOOL_H__
+#include "TaskPool.h"
+#endif
+
+
+TaskPool::TaskPool( int threads, bool pin ): m_queues(), m_threads(), m_lock(), m_start(), m_done(),
+                                   m_fn(nullptr), m_pending(0), m_generation(0), m_stop(false)
+{
+    if (threads <= 0)
+        threads = (int) std::thread::hardware_concurrency();
+    if (threads <= 0)
+        threads = 1;
+
+    m_queues = std::vector<Queue>(threads);
+
+    // worker 0 is the thread calling run()
+    for (int i = 1; i < threads; ++i)
+    {
+        m_threads.emplace_back( &TaskPool::worker, this, i, pin );
+    }
+}
+
+TaskPool::~TaskPool()
+{
+    {
+        std::lock_guard<std::mutex> guard(m_lock);
+        m_stop = true;
+    }
+    m_start.notify_all();
+    for (std::thread& t : m_threads)
+    {
+        t.join();
+    }
+}
+
+void
+TaskPool::run( int nTasks, const std::function<void(int, int)>& fn, const double* cost )
+{
+    if (nTasks <= 0)
+        return;
+
+    {
+        std::lock_guard<std::mutex> guard(m_lock);
+        m_fn = &fn;
+        m_pending = nTasks;
+        deal( nTasks, cost );
+        ++m_generation;
+    }
+    m_start.notify_all();
+
+    work( 0 );
+
+    std::unique_lock<std::mutex> guard(m_lock);
+    m_done.wait( guard, [this] { return m_pending.load() == 0; } );
+    m_fn = nullptr;
+}
+
+void
+TaskPool::deal( int nTasks, const double* cost )
+{
+    int n = threads();
+    if (!cost)
+    {
+        // contiguous blocks so that neighbouring tasks share a worker
+        for (int q = 0; q < n; ++q)
+        {
+            std::lock_guard<std::mutex> qguard(m_queues[q].lock);
+            int first = (int) ((long) nTasks * q / n);
+            int last  = (int) ((long) nTasks * (q + 1) / n);
+            for (int i = first; i < last; ++i)
+            {
+                m_queues[q].tasks.push_back( i );
+            }
+        }
+        return;
+    }
+
+    // longest processing time first onto the least loaded queue
+    std::vector<int> order(nTasks);
+    std::iota( order.begin(), order.end(), 0 );
+    std::stable_sort( order.begin(), order.end(), [cost]( int a, int b ) { return cost[a] > cost[b]; } );
+
+    std::vector<double> load(n, 0.0);
+    std::vector<std::vector<int>> dealt(n);
+    for (int i : order)
+    {
+        int q = (int) (std::min_element( load.begin(), load.end() ) - load.begin());
+        load[q] += cost[i];
+        dealt[q].push_back( i );
+    }
+
+    // the owner pops from the back, so put each queue's most expensive task there
+    for (int q = 0; q < n; ++q)
+    {
+        std::lock_guard<std::mutex> qguard(m_queues[q].lock);
+        m_queues[q].tasks.insert( m_queues[q].tasks.end(), dealt[q].rbegin(), dealt[q].rend() );
+    }
+}
+
+void
+TaskPool::worker( int id, bool pin )
+{
+#ifdef __linux__
+    if (pin)
+    {
+        unsigned int cores = std::thread::hardware_concurrency();
+        cpu_set_t set;
+        CPU_ZERO( &set );
+        CPU_SET( (cores) ? id % cores : 0, &set );
+        pthread_setaffinity_np( pthread_self(), sizeof(set), &set );
+    }
+#else
+    (void) pin;
+#endif
+
+    unsigned long seen = 0;
+    for (;;)
+    {
+        {
+            std::unique_lock<std::mutex> guard(m_lock);
+            m_start.wait( guard, [&] { return m_stop || m_generation != seen; } );
+            if (m_stop)
+                return;
+            seen = m_generation;
+        }
+        work( id );
+    }
+}
+
+void
+TaskPool::work( int id )
+{
+    int task = 0;
+    while (next( id, task ))
+    {
+        (*m_fn)( task, id );
+        if (m_pending.fetch_sub( 1 ) == 1)
+        {
+            std::lock_guard<std::mutex> guard(m_lock);
+            m_done.notify_all();
+        }
+    }
+}
+
+bool
+TaskPool::next( int id, int& task )
+{
+    {
+        // own work, most recently dealt first
+        Queue& q = m_queues[id];
+        std::lock_guard<std::mutex> guard(q.lock);
+        if (!q.tasks.empty())
+        {
+            task = q.tasks.back();
+            q.tasks.pop_back();
+            return true;
+        }
+    }
+
+    // steal the oldest task from a neighbour
+    int n = threads();
+    for (int i = 1; i < n; ++i)
+    {
+        Queue& q = m_queues[(id + i) % n];
+        std::lock_guard<std::mutex> guard(q.lock);
+        if (!q.tasks.empty())
+        {
+            task = q.tasks.front();
+            q.tasks.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
+
+//
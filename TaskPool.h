@@ -0,0 +1,111 @@
+/* Work Stealing Task Pool 18/10/2026
+
+ $$$$$$$$$$$$$$$$$$$$$$$$$$$
+ $   TaskPool.h - header   $
+ $$$$$$$$$$$$$$$$$$$$$$$$$$$
+
+ Copyright (C) 2026  W.B. Yates
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see http://www.gnu.org/licenses/
+
+ History:
+
+ A fixed pool of worker threads, each with its own task deque.
+ run(n, fn) deals task indices 0..n-1 out to the deques in contiguous blocks (so neighbouring tasks
+ stay on one worker), then each worker pops from the back of its own deque and, when that is empty,
+ steals from the front of another worker's deque. The calling thread works as worker 0.
+
+ fn(task, worker) is called exactly once per task; worker is in [0, threads()) and can be used to
+ index per-thread state (a BinomialTree workspace for example).
+
+ If task costs are given they are dealt longest first to the least loaded deque instead, and each deque
+ is ordered so its owner starts with the most expensive task while thieves take the cheapest.
+
+ With pin set, pool thread i is bound to core i (Linux only; elsewhere pinning is ignored).
+ The calling thread is never pinned.
+
+ Examples
+
+    TaskPool pool;
+    std::vector<BinomialTree> trees(pool.threads());
+    std::vector<double> prices(options.size());
+    pool.run( options.size(), [&]( int i, int w ) { prices[i] = trees[w].value( ... ); } );
+ */
+
+
+#ifndef __TASKPOOL_H__
+#define __TASKPOOL_H__
+
+#include <vector>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <atomic>
+#include <functional>
+#include <condition_variable>
+
+
+class TaskPool
+{
+public:
+
+    explicit TaskPool( int threads = 0, bool pin = false ); // 0 uses std::thread::hardware_concurrency()
+    ~TaskPool();
+
+    TaskPool( const TaskPool& ) = delete;
+    TaskPool& operator=( const TaskPool& ) = delete;
+
+    // call fn(task, worker) for every task in [0, nTasks); returns when all tasks have completed
+    void
+    run( int nTasks, const std::function<void(int, int)>& fn, const double* cost = nullptr );
+
+    int
+    threads( void ) const { return (int) m_queues.size(); }
+
+private:
+
+    struct alignas(64) Queue
+    {
+        std::mutex lock;
+        std::deque<int> tasks;
+    };
+
+    void
+    worker( int id, bool pin );
+
+    void
+    deal( int nTasks, const double* cost );
+
+    void
+    work( int id );
+
+    bool
+    next( int id, int& task );
+
+    std::vector<Queue> m_queues;
+    std::vector<std::thread> m_threads;
+
+    std::mutex m_lock;
+    std::condition_variable m_start;
+    std::condition_variable m_done;
+    const std::function<void(int, int)>* m_fn;
+    std::atomic<int> m_pending;
+    unsigned long m_generation;
+    bool m_stop;
+};
+
+
+#endif
+
+///
@@ -0,0 +1,180 @@
+/* Taylor Repricer 18/10/2026
+
+ $$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$
+ $   TaylorRepricer.cpp - code   $
+ $$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$
+
+ by W.B. Yates
+ Copyright (c) W.B. Yates. All rights reserved.
+ History:
+
+ */
+
+#include <math.h>
+
+#ifndef __TAYLORREPRICER_H__
+#include "TaylorRepricer.h"
+#endif
+
+
+namespace {
+
+    // vol bump for the tree's vega, vanna and volga; large enough to step over the tree's sawtooth in vol
+    const double VOL_BUMP = 0.005;
+
+    double
+    density( double x )
+    {
+        return exp( -0.5 * x * x ) * 0.39894228040143267794;
+    }
+}
+
+
+TaylorRepricer::TaylorRepricer( double tolerance, double maxAge ): m_pricer(),
+                                                                    m_entries(),
+                                                                    m_spot(1, 0.0),
+                                                                    m_ladder(),
+                                                                    m_tolerance(tolerance),
+                                                                    m_maxAge(maxAge),
+                                                                    m_maxEstimates(1000),
+                                                                    m_hits(0),
+                                                                    m_misses(0)
+{
+}
+
+int
+TaylorRepricer::add( const OptionSpec& option )
+{
+    m_entries.emplace_back();
+    m_entries.back().option = option;
+    anchor( m_entries.back() );
+    return (int) m_entries.size() - 1;
+}
+
+void
+TaylorRepricer::reset( int handle, const OptionSpec& option )
+{
+    Entry& e = m_entries[handle];
+    e.option = option;
+    anchor( e );
+}
+
+double
+TaylorRepricer::value( int handle, double assetPrice, double vol, double T )
+{
+    Entry& e = m_entries[handle];
+    double v = 0.0, error = 0.0;
+    if (estimate( e, assetPrice, vol, T, v, error ) && error <= m_tolerance)
+    {
+        ++e.estimates;
+        ++m_hits;
+        return v;
+    }
+    ++m_misses;
+    return reprice( handle, assetPrice, vol, T );
+}
+
+double
+TaylorRepricer::errorEstimate( int handle, double assetPrice, double vol, double T ) const
+{
+    double v = 0.0, error = 0.0;
+    return (estimate( m_entries[handle], assetPrice, vol, T, v, error )) ? error : NAN;
+}
+
+double
+TaylorRepricer::reprice( int handle, double assetPrice, double vol, double T )
+{
+    Entry& e = m_entries[handle];
+    e.option.assetPrice = assetPrice;
+    e.option.vol = vol;
+    e.option.T = T;
+    anchor( e );
+    return e.value;
+}
+
+bool
+TaylorRepricer::estimate( const Entry& e, double assetPrice, double vol, double T, double& v, double& error ) const
+{
+    double dt = e.option.T - T;  // time passed since the anchor
+    if (!(assetPrice > 0.0 && vol > 0.0 && T > 0.0) || fabs( dt ) > m_maxAge)
+        return false;
+    if (m_maxEstimates > 0 && e.estimates >= m_maxEstimates)
+        return false;
+
+    double dS = assetPrice - e.option.assetPrice;
+    double dV = vol - e.option.vol;
+
+    v = e.value + (e.delta * dS) + (e.vega * dV) + (e.theta * dt)
+        + (0.5 * e.gamma * dS * dS) + (e.vanna * dS * dV) + (0.5 * e.volga * dV * dV);
+
+    // the third order terms, each taken at its worst sign
+    error = (fabs( e.speed * dS * dS * dS ) + 3.0 * fabs( e.zomma * dS * dS * dV )
+             + 3.0 * fabs( e.volgaS * dS * dV * dV ) + fabs( e.ultima * dV * dV * dV )) / 6.0;
+    return isfinite( v ) && isfinite( error );
+}
+
+void
+TaylorRepricer::anchor( Entry& e )
+{
+    const OptionSpec& o = e.option;
+    e.estimates = 0;
+
+    if (o.model == OptionModel::BinomialTree)
+    {
+        BinomialTree& bt = m_pricer.binomialTree();
+        if (o.timeSteps > 0 && o.timeSteps != bt.timeSteps())
+            bt.timeSteps( o.timeSteps );
+
+        double h = fmin( VOL_BUMP, 0.5 * o.vol );
+        m_spot[0] = o.assetPrice;
+        bool ok = bt.spotLadder( o.strike, o.assetPrice, o.vol - h, o.rate, o.T, o.yield, o.call, m_spot, m_ladder );
+        double vDown = m_ladder[0].value, dDown = m_ladder[0].delta;
+        ok = ok && bt.spotLadder( o.strike, o.assetPrice, o.vol + h, o.rate, o.T, o.yield, o.call, m_spot, m_ladder );
+        double vUp = m_ladder[0].value, dUp = m_ladder[0].delta;
+        ok = ok && bt.spotLadder( o.strike, o.assetPrice, o.vol, o.rate, o.T, o.yield, o.call, m_spot, m_ladder );
+        if (!ok)
+        {
+            e.value = NAN;
+            return;
+        }
+
+        e.value = m_ladder[0].value;
+        e.delta = m_ladder[0].delta;
+        e.gamma = m_ladder[0].gamma;
+        e.vega  = (vUp - vDown) / (2.0 * h);
+        e.volga = (vUp - 2.0 * e.value + vDown) / (h * h);
+        e.vanna = (dUp - dDown) / (2.0 * h);
+        e.theta = bt.theta( o.strike, o.assetPrice, o.vol, o.rate, o.T, o.yield, o.call );
+    }
+    else
+    {
+        e.value = m_pricer.value( o );
+        e.delta = m_pricer.delta( o );
+        e.gamma = m_pricer.gamma( o );
+        e.vega  = m_pricer.vega( o );
+        e.theta = m_pricer.theta( o );
+    }
+
+    // BlackScholes cross and third order terms; Black is BlackScholes on the forward with yield = rate
+    double q = (o.model == OptionModel::Black) ? o.rate : o.yield;
+    double sqrtT = sqrt( o.T );
+    double s = o.vol * sqrtT;
+    double d1 = (log( o.assetPrice / o.strike ) + (o.rate - q + 0.5 * o.vol * o.vol) * o.T) / s;
+    double d2 = d1 - s;
+    double phi = exp( -q * o.T ) * density( d1 );
+    double gamma = phi / (o.assetPrice * s);
+    double vega = o.assetPrice * phi * sqrtT;
+    double vanna = -phi * d2 / o.vol;
+
+    if (o.model != OptionModel::BinomialTree)
+    {
+        e.vanna = vanna;
+        e.volga = vega * d1 * d2 / o.vol;
+    }
+    e.speed  = -(gamma / o.assetPrice) * (1.0 + d1 / s);
+    e.zomma  = gamma * (d1 * d2 - 1.0) / o.vol;
+    e.volgaS = (vanna * d1 * d2 / o.vol) + (vega * (d1 + d2) / (o.vol * o.assetPrice * s));
+    e.ultima = -(vega / (o.vol * o.vol)) * ((d1 * d2 * (1.0 - d1 * d2)) + (d1 * d1) + (d2 * d2));
+}
+
+//
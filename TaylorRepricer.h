@@ -0,0 +1,173 @@
+/* Taylor Repricer 18/10/2026
+
+ $$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$
+ $   TaylorRepricer.h - header   $
+ $$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$
+
+ Copyright (C) 2026  W.B. Yates
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see http://www.gnu.org/licenses/
+
+ History:
+
+ Cheap repricing of options for small moves in spot, vol and time.
+
+ Each option keeps the value and Greeks of its last full valuation (its anchor). value() returns the
+ second order Taylor estimate about the anchor,
+
+    V + delta dS + vega dV + theta dt + gamma dS^2 / 2 + vanna dS dV + volga dV^2 / 2
+
+ unless the size of the third order terms (speed, zomma, d volga / dS and ultima, which are taken from
+ BlackScholes at the anchor) exceeds tolerance(), the anchor is older than maxAge() years, or
+ maxEstimates() estimates have been made since it was set; then the option is fully repriced and
+ re-anchored. Closed form options take their Greeks analytically. BinomialTree options take theirs from
+ the tree: value, delta and gamma from one spotLadder() build at the anchor vol and one at each of
+ vol -/+ 0.005 (giving vega, vanna and volga), and theta from one more build.
+
+ The estimate is smooth in spot, so it does not follow the tree's own discretisation error, which jumps
+ about as the strike moves between nodes; at 200 steps that is of the order of a cent either way.
+
+ Repricing the anchor costs around five tree builds, so for trees this pays off once most ticks are
+ estimated; hitRate() reports the fraction that were. Rates, strikes and yields are fixed between
+ anchors; use reset() when they change. A TaylorRepricer holds an OptionPricer, so use one per thread.
+
+ Examples
+
+    TaylorRepricer fast( 0.005 );                  // half a cent
+    int h = fast.add( option );                    // full valuation
+    ...
+    double v = fast.value( h, spot, vol, T );      // estimate, or full reprice when out of tolerance
+    std::cout << "hit rate " << fast.hitRate() << std::endl;
+ */
+
+
+#ifndef __TAYLORREPRICER_H__
+#define __TAYLORREPRICER_H__
+
+#include <vector>
+
+#ifndef __OPTIONPRICER_H__
+#include "OptionPricer.h"
+#endif
+
+
+class TaylorRepricer
+{
+public:
+
+    explicit TaylorRepricer( double tolerance = 0.01,       // largest estimated error accepted (price units)
+                             double maxAge = 1.0 / 365.0 ); // largest time move (years) from the anchor
+
+    ~TaylorRepricer() {}
+
+    int // returns a handle for the option; fully values it
+    add( const OptionSpec& option );
+
+    // replace an option (new strike, rate, yield ...) and fully value it
+    void
+    reset( int handle, const OptionSpec& option );
+
+    // value at a new spot, vol and time to maturity
+    double
+    value( int handle,
+           double assetPrice,  // underlying asset's current value (forward value for Black)
+           double vol,         // volatility
+           double T );         // time to maturity (year fraction)
+
+    // the error estimate value() would test for these moves
+    double
+    errorEstimate( int handle, double assetPrice, double vol, double T ) const;
+
+    // fully value and re-anchor at a new spot, vol and time to maturity
+    double
+    reprice( int handle, double assetPrice, double vol, double T );
+
+    const OptionSpec&
+    option( int handle ) const { return m_entries[handle].option; }
+
+    int
+    size( void ) const { return (int) m_entries.size(); }
+
+    double
+    tolerance( void ) const { return m_tolerance; }
+
+    void
+    tolerance( double t ) { m_tolerance = t; }
+
+    double
+    maxAge( void ) const { return m_maxAge; }
+
+    void
+    maxAge( double years ) { m_maxAge = years; }
+
+    int
+    maxEstimates( void ) const { return m_maxEstimates; }
+
+    void
+    maxEstimates( int n ) { m_maxEstimates = n; } // 0 for no limit
+
+    long
+    hits( void ) const { return m_hits; }
+
+    long
+    misses( void ) const { return m_misses; }
+
+    double // fraction of value() calls answered by an estimate
+    hitRate( void ) const { return (m_hits + m_misses > 0) ? double(m_hits) / double(m_hits + m_misses) : 0.0; }
+
+    void
+    clearCounts( void ) { m_hits = 0; m_misses = 0; }
+
+    OptionPricer& pricer( void ) { return m_pricer; }
+
+private:
+
+    struct Entry
+    {
+        OptionSpec option;  // the anchor
+        double value = 0.0;
+        double delta = 0.0;
+        double gamma = 0.0;
+        double vega = 0.0;
+        double theta = 0.0;
+        double vanna = 0.0;
+        double volga = 0.0;
+        double speed = 0.0;   // third order terms, for the error estimate
+        double zomma = 0.0;
+        double volgaS = 0.0;
+        double ultima = 0.0;
+        int estimates = 0;
+    };
+
+    void
+    anchor( Entry& e );
+
+    bool
+    estimate( const Entry& e, double assetPrice, double vol, double T, double& v, double& error ) const;
+
+    OptionPricer m_pricer;
+    std::vector<Entry> m_entries;
+    std::vector<double> m_spot;
+    std::vector<SpotPoint> m_ladder;
+    double m_tolerance;
+    double m_maxAge;
+    int m_maxEstimates;
+    long m_hits;
+    long m_misses;
+};
+
+
+#endif
+
+///
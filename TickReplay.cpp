@@ -0,0 +1,459 @@
+/* Tick Replay Benchmark 18/10/2026
+
+ $$$$$$$$$$$$$$$$$$$$$$$$$$$$$
+ $   TickReplay.cpp - code   $
+ $$$$$$$$$$$$$$$$$$$$$$$$$$$$$
+
+ by W.B. Yates
+ Copyright (c) W.B. Yates. All rights reserved.
+ History:
+
+ Replays a binary tick file through the whole tick path and reports what a tick costs: latency
+ percentiles, throughput and heap allocations. Built as its own program, e.g.
+
+    c++ -std=c++20 -O3 TickReplay.cpp ImpliedVolStream.cpp PositionBook.cpp OptionPricer.cpp \
+        BlackScholes.cpp Black.cpp BinomialTree.cpp BaroneAdesiWhaley.cpp PriceStats.cpp -o tickreplay
+    ./tickreplay generate ticks.bin 1000000 10 100 100000
+    ./tickreplay replay ticks.bin          // as fast as possible
+    ./tickreplay replay ticks.bin 1        // at the recorded pace (2 is twice as fast)
+
+ usage: tickreplay generate <file> [ticks] [underlyings] [contracts per underlying] [ticks per second] [seed]
+        tickreplay replay <file> [speed]
+
+ A tick is an underlying price or an option quote. An underlying tick reprices every position on that
+ underlying in a PositionBook and updates its aggregates. A quote tick updates the chain (the contract's
+ last quote), solves its implied vol with an ImpliedVolStream and, when the vol is solved, reprices the
+ contract's position (value and Greeks) at the new vol and applies the change to the aggregates.
+
+ The file is little-endian and written as laid out in memory:
+
+    TickFileHeader (64 bytes)
+    double[underlyings]            starting prices
+    TickContract[contracts]        the chain, and the position held in each contract
+    TickRecord[ticks]              in time order
+
+ generate writes a synthetic file: underlyings following random walks, contracts spread over strikes
+ and four expiries, quotes from BlackScholes on a smile with some noise, Poisson arrivals.
+
+ At speed 0 a tick's latency is the time spent on it. Otherwise each tick is due at its recorded time
+ (divided by speed) after the start, and its latency runs from when it was due, so time spent queued
+ behind a slow tick is counted. Every operator new during the replay is counted.
+ */
+
+#include <new>
+#include <atomic>
+#include <chrono>
+#include <random>
+#include <thread>
+#include <vector>
+#include <iostream>
+#include <algorithm>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#ifndef __IMPLIEDVOLSTREAM_H__
+#include "ImpliedVolStream.h"
+#endif
+
+#ifndef __POSITIONBOOK_H__
+#include "PositionBook.h"
+#endif
+
+
+struct TickFileHeader
+{
+    char     magic[8];        // "OPTICKS"
+    uint32_t version;
+    uint32_t underlyings;
+    uint32_t contracts;
+    uint32_t reserved0;
+    uint64_t ticks;
+    uint8_t  reserved[32];
+};
+
+struct TickContract
+{
+    uint32_t underlying;
+    uint8_t  call;
+    uint8_t  reserved[3];
+    double   strike;
+    double   T;               // time to maturity (year fraction)
+    double   rate;
+    double   yield;
+    double   vol;             // starting vol of the position
+    double   quantity;        // of the position held
+};
+
+struct TickRecord
+{
+    uint64_t time;            // nanoseconds from the start of the file
+    uint32_t kind;            // TICK_UNDERLYING or TICK_QUOTE
+    uint32_t id;              // underlying or contract
+    double   price;           // the underlying's price
+    double   bid;             // quotes only
+    double   ask;
+};
+
+static_assert( sizeof(TickFileHeader) == 64 && sizeof(TickContract) == 56 && sizeof(TickRecord) == 40, "tick file layout" );
+
+const char     TICK_MAGIC[8]   = "OPTICKS";
+const uint32_t TICK_VERSION    = 1;
+const uint32_t TICK_UNDERLYING = 0;
+const uint32_t TICK_QUOTE      = 1;
+
+
+// every allocation in the process is counted
+
+static std::atomic<long> allocations(0);
+static std::atomic<long> allocated(0);
+
+static void*
+allocate( std::size_t n, std::size_t align )
+{
+    allocations.fetch_add( 1, std::memory_order_relaxed );
+    allocated.fetch_add( (long) n, std::memory_order_relaxed );
+    void* p = (align > alignof(std::max_align_t)) ? aligned_alloc( align, (n + align - 1) / align * align ) : malloc( n ? n : 1 );
+    if (!p)
+        throw std::bad_alloc();
+    return p;
+}
+
+void* operator new( std::size_t n ) { return allocate( n, 0 ); }
+void* operator new[]( std::size_t n ) { return allocate( n, 0 ); }
+void* operator new( std::size_t n, std::align_val_t a ) { return allocate( n, (std::size_t) a ); }
+void* operator new[]( std::size_t n, std::align_val_t a ) { return allocate( n, (std::size_t) a ); }
+void operator delete( void* p ) noexcept { free( p ); }
+void operator delete[]( void* p ) noexcept { free( p ); }
+void operator delete( void* p, std::size_t ) noexcept { free( p ); }
+void operator delete[]( void* p, std::size_t ) noexcept { free( p ); }
+void operator delete( void* p, std::align_val_t ) noexcept { free( p ); }
+void operator delete[]( void* p, std::align_val_t ) noexcept { free( p ); }
+void operator delete( void* p, std::size_t, std::align_val_t ) noexcept { free( p ); }
+void operator delete[]( void* p, std::size_t, std::align_val_t ) noexcept { free( p ); }
+
+
+static int
+usage( const char* name )
+{
+    std::cerr << "usage: " << name << " generate <file> [ticks] [underlyings] [contracts per underlying] [ticks per second] [seed]" << std::endl;
+    std::cerr << "       " << name << " replay <file> [speed]" << std::endl;
+    return 1;
+}
+
+static double
+smile( double strike, double spot, double T )
+{
+    double m = log( strike / spot ) / sqrt( T );
+    return 0.2 + 0.15 * m * m - 0.05 * m;
+}
+
+static int
+generate( const char* path, long ticks, int underlyings, int perUnderlying, double rate, unsigned seed )
+{
+    std::mt19937_64 rng( seed );
+    std::uniform_real_distribution<double> uniform( 0.0, 1.0 );
+    std::normal_distribution<double> normal( 0.0, 1.0 );
+    std::exponential_distribution<double> arrival( rate );
+
+    const double expiries[4] = { 0.1, 0.25, 0.5, 1.0 };
+    const double R = 0.04;
+    const double Q = 0.01;
+
+    TickFileHeader h;
+    memset( &h, 0, sizeof(h) );
+    memcpy( h.magic, TICK_MAGIC, sizeof(h.magic) );
+    h.version = TICK_VERSION;
+    h.underlyings = underlyings;
+    h.contracts = underlyings * perUnderlying;
+    h.ticks = ticks;
+
+    std::vector<double> spot( underlyings );
+    for (int u = 0; u < underlyings; ++u)
+        spot[u] = 50.0 + 150.0 * uniform( rng );
+
+    // strikes from 70% to 130% of spot on each expiry, calls and puts alternating along both
+    std::vector<TickContract> contracts( h.contracts );
+    for (int u = 0; u < underlyings; ++u)
+    {
+        int strikes = (perUnderlying + 3) / 4;
+        for (int j = 0; j < perUnderlying; ++j)
+        {
+            TickContract& c = contracts[u * perUnderlying + j];
+            memset( &c, 0, sizeof(c) );
+            c.underlying = u;
+            c.call = ((j / 4 + j % 4) & 1) == 0;
+            c.T = expiries[j % 4];
+            c.strike = round( spot[u] * (0.7 + 0.6 * (j / 4) / std::max( 1, strikes - 1 )) );
+            c.rate = R;
+            c.yield = Q;
+            c.vol = smile( c.strike, spot[u], c.T );
+            c.quantity = round( 100.0 * uniform( rng ) ) - 50.0;
+        }
+    }
+
+    FILE* f = fopen( path, "wb" );
+    if (!f)
+    {
+        std::cerr << "cannot write " << path << std::endl;
+        return 1;
+    }
+
+    bool ok = fwrite( &h, sizeof(h), 1, f ) == 1;
+    ok = ok && fwrite( spot.data(), sizeof(double), spot.size(), f ) == spot.size();
+    ok = ok && fwrite( contracts.data(), sizeof(TickContract), contracts.size(), f ) == contracts.size();
+
+    // a fifth of the ticks move an underlying, the rest quote a contract
+    BlackScholes bs;
+    double time = 0.0;
+    std::vector<TickRecord> block;
+    block.reserve( 4096 );
+    for (long i = 0; ok && i < ticks; ++i)
+    {
+        time += arrival( rng );
+
+        TickRecord t;
+        memset( &t, 0, sizeof(t) );
+        t.time = (uint64_t) (time * 1E9);
+        if (uniform( rng ) < 0.2)
+        {
+            int u = (int) (uniform( rng ) * underlyings);
+            spot[u] *= exp( 0.0005 * normal( rng ) );
+            t.kind = TICK_UNDERLYING;
+            t.id = u;
+            t.price = spot[u];
+        }
+        else
+        {
+            int k = (int) (uniform( rng ) * h.contracts);
+            const TickContract& c = contracts[k];
+            double S = spot[c.underlying];
+            double v = smile( c.strike, S, c.T ) * (1.0 + 0.002 * normal( rng ));
+            double value = bs.value( c.strike, S, v, c.rate, c.T, c.yield, c.call );
+            double half = std::max( 0.005, 0.005 * value );
+            t.kind = TICK_QUOTE;
+            t.id = k;
+            t.price = S;
+            t.bid = std::max( 0.0, value - half );
+            t.ask = value + half;
+        }
+
+        block.push_back( t );
+        if (block.size() == block.capacity() || i + 1 == ticks)
+        {
+            ok = fwrite( block.data(), sizeof(TickRecord), block.size(), f ) == block.size();
+            block.clear();
+        }
+    }
+
+    ok = (fclose( f ) == 0) && ok;
+    if (!ok)
+    {
+        std::cerr << "failed to write " << path << std::endl;
+        return 1;
+    }
+
+    std::cout << "wrote " << path << ": " << ticks << " ticks over " << time << "s, " << underlyings
+              << " underlyings, " << h.contracts << " contracts" << std::endl;
+    return 0;
+}
+
+static double
+percentile( const std::vector<uint32_t>& sorted, double p )
+{
+    if (sorted.empty())
+        return 0.0;
+    size_t i = std::min( sorted.size() - 1, (size_t) (p * (double) sorted.size()) );
+    return sorted[i] * 1E-3;
+}
+
+static int
+replay( const char* path, double speed )
+{
+    int fd = open( path, O_RDONLY );
+    struct stat st;
+    if (fd < 0 || fstat( fd, &st ) != 0 || (size_t) st.st_size < sizeof(TickFileHeader))
+    {
+        std::cerr << "cannot read " << path << std::endl;
+        if (fd >= 0)
+            close( fd );
+        return 1;
+    }
+
+    // mapped and populated up front, so the replay takes no page faults on the file
+    size_t bytes = (size_t) st.st_size;
+    void* map = mmap( nullptr, bytes, PROT_READ, MAP_PRIVATE | MAP_POPULATE, fd, 0 );
+    close( fd );
+    if (map == MAP_FAILED)
+    {
+        std::cerr << "cannot map " << path << std::endl;
+        return 1;
+    }
+
+    const TickFileHeader* h = (const TickFileHeader*) map;
+    const double* spot = (const double*) (h + 1);
+    const TickContract* contracts = (const TickContract*) (spot + h->underlyings);
+    const TickRecord* ticks = (const TickRecord*) (contracts + h->contracts);
+    size_t expected = sizeof(TickFileHeader) + h->underlyings * sizeof(double) + h->contracts * sizeof(TickContract) + h->ticks * sizeof(TickRecord);
+    if (memcmp( h->magic, TICK_MAGIC, sizeof(h->magic) ) != 0 || h->version != TICK_VERSION || bytes < expected)
+    {
+        std::cerr << path << " is not a tick file" << std::endl;
+        munmap( map, bytes );
+        return 1;
+    }
+
+    // the chain, its implied vols and the positions
+    PositionBook book;
+    ImpliedVolStream stream( 1E9 );
+    std::vector<int> position( h->contracts );
+    for (uint32_t u = 0; u < h->underlyings; ++u)
+        book.addUnderlying( spot[u] );
+
+    for (uint32_t k = 0; k < h->contracts; ++k)
+    {
+        const TickContract& c = contracts[k];
+        if (c.underlying >= h->underlyings)
+        {
+            std::cerr << path << ": contract " << k << " has no underlying" << std::endl;
+            munmap( map, bytes );
+            return 1;
+        }
+
+        VolContract vc;
+        vc.strike = c.strike;
+        vc.T = c.T;
+        vc.rate = c.rate;
+        vc.yield = c.yield;
+        vc.call = c.call != 0;
+        stream.addContract( vc );
+
+        OptionSpec o;
+        o.call = vc.call;
+        o.strike = c.strike;
+        o.vol = (c.vol > 0.0) ? c.vol : 0.2;
+        o.rate = c.rate;
+        o.T = c.T;
+        o.yield = c.yield;
+        position[k] = book.addPosition( c.underlying, o, c.quantity );
+    }
+    book.rebuild();
+
+    std::vector<VolUpdate> chain( h->contracts );   // each contract's last quote
+    std::vector<uint32_t> latency( h->ticks );      // nanoseconds
+    long status[6] = { 0, 0, 0, 0, 0, 0 };
+    long invalid = 0;
+    long behind = 0;
+
+    long allocationsBefore = allocations.load();
+    long allocatedBefore = allocated.load();
+    auto start = std::chrono::steady_clock::now();
+
+    for (uint64_t i = 0; i < h->ticks; ++i)
+    {
+        const TickRecord& t = ticks[i];
+
+        auto begin = std::chrono::steady_clock::now();
+        if (speed > 0.0)
+        {
+            // due at its recorded time; sleep only through long gaps, as a sleep can overrun by a millisecond
+            auto due = start + std::chrono::nanoseconds( (long long) ((double) t.time / speed) );
+            if (begin > due)
+                ++behind;
+            while (begin < due)
+            {
+                if (due - begin > std::chrono::milliseconds( 5 ))
+                    std::this_thread::sleep_for( due - begin - std::chrono::milliseconds( 2 ) );
+                begin = std::chrono::steady_clock::now();
+            }
+            begin = due;
+        }
+
+        if (t.kind == TICK_UNDERLYING && t.id < h->underlyings)
+            book.underlyingPrice( t.id, t.price );
+        else if (t.kind == TICK_QUOTE && t.id < h->contracts)
+        {
+            VolUpdate& q = chain[t.id];
+            q.contract = (int) t.id;
+            q.bid = t.bid;
+            q.ask = t.ask;
+            q.underlying = t.price;
+            q.time = t.time * 1E-9;
+
+            VolResult r;
+            stream.process( std::span<const VolUpdate>( &q, 1 ), q.time, std::span<VolResult>( &r, 1 ) );
+            ++status[(int) r.status];
+            if (r.status == VolStatus::Solved)
+                book.vol( position[t.id], r.vol );
+        }
+        else ++invalid;
+
+        auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>( std::chrono::steady_clock::now() - begin ).count();
+        latency[i] = (uint32_t) std::min<long long>( ns, UINT32_MAX );
+    }
+
+    double seconds = std::chrono::duration<double>( std::chrono::steady_clock::now() - start ).count();
+    long newCalls = allocations.load() - allocationsBefore;
+    long newBytes = allocated.load() - allocatedBefore;
+
+    GreekTotals total;
+    for (int u = 0; u < book.underlyings(); ++u)
+    {
+        GreekTotals g = book.total( u );
+        total.value += g.value;
+        total.delta += g.delta;
+        total.vega += g.vega;
+    }
+
+    std::sort( latency.begin(), latency.end() );
+    double n = (double) h->ticks;
+    std::cout << path << ": " << h->ticks << " ticks, " << h->underlyings << " underlyings, " << h->contracts << " contracts, ";
+    if (speed > 0.0)
+        std::cout << "recorded pace x" << speed << std::endl;
+    else std::cout << "full speed" << std::endl;
+    std::cout << "throughput  " << n / seconds << " ticks/s (" << seconds << "s)" << std::endl;
+    std::cout << "latency us  p50 " << percentile( latency, 0.5 ) << "  p99 " << percentile( latency, 0.99 )
+              << "  p99.9 " << percentile( latency, 0.999 ) << "  max " << percentile( latency, 1.0 ) << std::endl;
+    std::cout << "allocations " << newCalls << " (" << newBytes << " bytes, " << newCalls / std::max( 1.0, n ) << " per tick)" << std::endl;
+    std::cout << "quotes      solved " << status[(int) VolStatus::Solved] << ", unchanged " << status[(int) VolStatus::Unchanged]
+              << ", stale " << status[(int) VolStatus::Stale] << ", crossed " << status[(int) VolStatus::Crossed]
+              << ", arbitrage " << status[(int) VolStatus::Arbitrage] << ", failed " << status[(int) VolStatus::Failed] << std::endl;
+    if (speed > 0.0)
+        std::cout << "behind      " << behind << " ticks started after they were due" << std::endl;
+    if (invalid)
+        std::cout << "invalid     " << invalid << " ticks" << std::endl;
+    std::cout << "book        value " << total.value << ", delta " << total.delta << ", vega " << total.vega << std::endl;
+
+    munmap( map, bytes );
+    return 0;
+}
+
+int
+main( int argc, const char* argv[] )
+{
+    if (argc < 3)
+        return usage( argv[0] );
+
+    if (strcmp( argv[1], "generate" ) == 0)
+    {
+        long ticks = (argc > 3) ? atol( argv[3] ) : 1000000;
+        int underlyings = (argc > 4) ? atoi( argv[4] ) : 10;
+        int perUnderlying = (argc > 5) ? atoi( argv[5] ) : 100;
+        double rate = (argc > 6) ? atof( argv[6] ) : 100000.0;
+        unsigned seed = (argc > 7) ? (unsigned) atol( argv[7] ) : 1;
+        if (ticks < 1 || underlyings < 1 || perUnderlying < 1 || rate <= 0.0)
+            return usage( argv[0] );
+        return generate( argv[2], ticks, underlyings, perUnderlying, rate, seed );
+    }
+
+    if (strcmp( argv[1], "replay" ) == 0)
+        return replay( argv[2], (argc > 3) ? atof( argv[3] ) : 0.0 );
+
+    return usage( argv[0] );
+}
+
+//
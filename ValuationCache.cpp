@@ -0,0 +1,278 @@
+/* Valuation Cache 18/10/2026
+
+ $$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$
+ $   ValuationCache.cpp - code   $
+ $$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$
+
+ by W.B. Yates
+ Copyright (c) W.B. Yates. All rights reserved.
+ History:
+
+ */
+
+#include <math.h>
+#include <bit>
+
+#ifndef __VALUATIONCACHE_H__
+#include "ValuationCache.h"
+#endif
+
+
+namespace {
+
+    double
+    snap( double x, double quantum )
+    {
+        return (quantum > 0.0) ? round( x / quantum ) * quantum : x;
+    }
+
+    std::uint64_t
+    mix( std::uint64_t h, std::uint64_t x )
+    {
+        // splitmix64 finaliser on the running hash
+        h ^= x + 0x9E3779B97F4A7C15ULL + (h << 6) + (h >> 2);
+        h ^= h >> 30;
+        h *= 0xBF58476D1CE4E5B9ULL;
+        h ^= h >> 27;
+        h *= 0x94D049BB133111EBULL;
+        return h ^ (h >> 31);
+    }
+}
+
+
+ValuationCache::ValuationCache( std::size_t bytes, int shards ): m_quantum(), m_sets(), m_shards()
+{
+    std::size_t sets = 1;
+    while (sets * 2 * sizeof(Set) <= bytes)
+    {
+        sets *= 2;
+    }
+    m_sets = std::vector<Set>(sets);
+    m_shards = std::vector<Shard>((shards > 0) ? shards : 1);
+}
+
+double
+ValuationCache::get( Kind kind, BinomialTree& tree, double strike, double assetPrice, double vol, double rate, double T, double yield, bool call )
+{
+    strike     = snap( strike, m_quantum.strike );
+    assetPrice = snap( assetPrice, m_quantum.assetPrice );
+    vol        = snap( vol, m_quantum.vol );
+    rate       = snap( rate, m_quantum.rate );
+    T          = snap( T, m_quantum.T );
+    yield      = snap( yield, m_quantum.yield );
+
+    std::uint64_t key[WORDS] = { std::bit_cast<std::uint64_t>( strike ), std::bit_cast<std::uint64_t>( assetPrice ),
+                                 std::bit_cast<std::uint64_t>( vol ), std::bit_cast<std::uint64_t>( rate ),
+                                 std::bit_cast<std::uint64_t>( T ), std::bit_cast<std::uint64_t>( yield ) };
+    std::uint32_t tag = ((std::uint32_t) tree.timeSteps() << 8) | ((tree.american()) ? 0u : 0x20u) | ((call) ? 0x10u : 0u) | kind;
+
+    std::uint32_t print = 0;
+    std::size_t s = locate( tag, key, print );
+    Set& set = m_sets[s];
+    Shard& shard = m_shards[s % m_shards.size()];
+
+    double v = 0.0;
+    if (lookup( set, print, tag, key, v ))
+    {
+        shard.hits.fetch_add( 1, std::memory_order_relaxed );
+        return v;
+    }
+    shard.misses.fetch_add( 1, std::memory_order_relaxed );
+
+    switch (kind)
+    {
+        case Value: v = tree.value( strike, assetPrice, vol, rate, T, yield, call ); break;
+        case Delta: v = tree.delta( strike, assetPrice, vol, rate, T, yield, call ); break;
+        case Gamma: v = tree.gamma( strike, assetPrice, vol, rate, T, yield, call ); break;
+        case Theta: v = tree.theta( strike, assetPrice, vol, rate, T, yield, call ); break;
+        case Vega:  v = tree.vega( strike, assetPrice, vol, rate, T, yield ); break;
+        case Rho:   v = tree.rho( strike, assetPrice, vol, rate, T, yield, call ); break;
+    }
+
+    insert( set, shard, print, tag, key, v );
+    return v;
+}
+
+std::size_t
+ValuationCache::locate( std::uint32_t tag, const std::uint64_t* key, std::uint32_t& print ) const
+{
+    std::uint64_t h = tag;
+    for (int i = 0; i < WORDS; ++i)
+    {
+        h = mix( h, key[i] );
+    }
+    print = (std::uint32_t) (h >> 32) | 1u;
+    return (std::size_t) h & (m_sets.size() - 1);
+}
+
+bool
+ValuationCache::lookup( Set& set, std::uint32_t print, std::uint32_t tag, const std::uint64_t* key, double& value ) const
+{
+    for (int w = 0; w < WAYS; ++w)
+    {
+        if (set.print[w].load( std::memory_order_relaxed ) != print)
+            continue;
+
+        Slot& slot = set.slot[w];
+        std::uint32_t seq = slot.seq.load( std::memory_order_acquire );
+        if (seq & 1u)
+            continue;   // being written
+
+        bool match = slot.tag.load( std::memory_order_relaxed ) == tag;
+        for (int i = 0; match && i < WORDS; ++i)
+        {
+            match = slot.key[i].load( std::memory_order_relaxed ) == key[i];
+        }
+        std::uint64_t bits = slot.value.load( std::memory_order_relaxed );
+
+        std::atomic_thread_fence( std::memory_order_acquire );
+        if (match && slot.seq.load( std::memory_order_relaxed ) == seq)
+        {
+            if (!set.ref[w].load( std::memory_order_relaxed ))
+                set.ref[w].store( 1, std::memory_order_relaxed );
+            value = std::bit_cast<double>( bits );
+            return true;
+        }
+    }
+    return false;
+}
+
+void
+ValuationCache::insert( Set& set, Shard& shard, std::uint32_t print, std::uint32_t tag, const std::uint64_t* key, double value )
+{
+    std::lock_guard<std::mutex> guard(shard.lock);
+
+    // another writer may have got here first; otherwise an empty slot, otherwise the CLOCK victim
+    int victim = -1;
+    for (int w = 0; w < WAYS && victim < 0; ++w)
+    {
+        Slot& slot = set.slot[w];
+        bool match = slot.tag.load( std::memory_order_relaxed ) == tag;
+        for (int i = 0; match && i < WORDS; ++i)
+        {
+            match = slot.key[i].load( std::memory_order_relaxed ) == key[i];
+        }
+        if (match)
+            victim = w;
+    }
+    for (int w = 0; w < WAYS && victim < 0; ++w)
+    {
+        if (set.slot[w].tag.load( std::memory_order_relaxed ) == 0)
+            victim = w;
+    }
+    if (victim < 0)
+    {
+        while (set.ref[set.hand].load( std::memory_order_relaxed ))
+        {
+            set.ref[set.hand].store( 0, std::memory_order_relaxed );
+            set.hand = (std::uint8_t) ((set.hand + 1) % WAYS);
+        }
+        victim = set.hand;
+        set.hand = (std::uint8_t) ((set.hand + 1) % WAYS);
+        shard.evictions.fetch_add( 1, std::memory_order_relaxed );
+    }
+
+    Slot& slot = set.slot[victim];
+    std::uint32_t seq = slot.seq.load( std::memory_order_relaxed );
+    slot.seq.store( seq + 1, std::memory_order_relaxed );
+    std::atomic_thread_fence( std::memory_order_release );
+
+    slot.tag.store( tag, std::memory_order_relaxed );
+    for (int i = 0; i < WORDS; ++i)
+    {
+        slot.key[i].store( key[i], std::memory_order_relaxed );
+    }
+    slot.value.store( std::bit_cast<std::uint64_t>( value ), std::memory_order_relaxed );
+
+    slot.seq.store( seq + 2, std::memory_order_release );
+    set.print[victim].store( print, std::memory_order_relaxed );
+    set.ref[victim].store( 0, std::memory_order_relaxed );
+    shard.inserts.fetch_add( 1, std::memory_order_relaxed );
+}
+
+CacheStats
+ValuationCache::stats( void ) const
+{
+    CacheStats s;
+    for (const Shard& shard : m_shards)
+    {
+        s.hits      += shard.hits.load( std::memory_order_relaxed );
+        s.misses    += shard.misses.load( std::memory_order_relaxed );
+        s.inserts   += shard.inserts.load( std::memory_order_relaxed );
+        s.evictions += shard.evictions.load( std::memory_order_relaxed );
+    }
+    return s;
+}
+
+void
+ValuationCache::clear( void )
+{
+    for (std::size_t s = 0; s < m_sets.size(); ++s)
+    {
+        Set& set = m_sets[s];
+        std::lock_guard<std::mutex> guard(m_shards[s % m_shards.size()].lock);
+        for (int w = 0; w < WAYS; ++w)
+        {
+            Slot& slot = set.slot[w];
+            slot.seq.store( slot.seq.load( std::memory_order_relaxed ) + 2, std::memory_order_release );
+            slot.tag.store( 0, std::memory_order_relaxed );
+            set.print[w].store( 0, std::memory_order_relaxed );
+            set.ref[w].store( 0, std::memory_order_relaxed );
+        }
+        set.hand = 0;
+    }
+    for (Shard& shard : m_shards)
+    {
+        shard.hits = 0;
+        shard.misses = 0;
+        shard.inserts = 0;
+        shard.evictions = 0;
+    }
+}
+
+std::size_t
+ValuationCache::entries( std::vector<CacheEntry>& out ) const
+{
+    std::size_t before = out.size();
+    for (const Set& set : m_sets)
+    {
+        for (int w = 0; w < WAYS; ++w)
+        {
+            const Slot& slot = set.slot[w];
+            CacheEntry e;
+            std::uint32_t seq = 0;
+            do
+            {
+                seq = slot.seq.load( std::memory_order_acquire );
+                e.tag = slot.tag.load( std::memory_order_relaxed );
+                for (int i = 0; i < WORDS; ++i)
+                {
+                    e.key[i] = slot.key[i].load( std::memory_order_relaxed );
+                }
+                e.value = std::bit_cast<double>( slot.value.load( std::memory_order_relaxed ) );
+                std::atomic_thread_fence( std::memory_order_acquire );
+            }
+            while ((seq & 1u) || slot.seq.load( std::memory_order_relaxed ) != seq);
+
+            if (e.tag != 0)
+                out.push_back( e );
+        }
+    }
+    return out.size() - before;
+}
+
+void
+ValuationCache::restore( const CacheEntry* entries, std::size_t n )
+{
+    for (std::size_t k = 0; k < n; ++k)
+    {
+        const CacheEntry& e = entries[k];
+        if (e.tag == 0)
+            continue;
+        std::uint32_t print = 0;
+        std::size_t s = locate( e.tag, e.key, print );
+        insert( m_sets[s], m_shards[s % m_shards.size()], print, e.tag, e.key, e.value );
+    }
+}
+
+//
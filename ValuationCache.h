@@ -0,0 +1,227 @@
+/* Valuation Cache 18/10/2026
+
+ $$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$
+ $   ValuationCache.h - header   $
+ $$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$
+
+ Copyright (C) 2026  W.B. Yates
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see http://www.gnu.org/licenses/
+
+ History:
+
+ A fixed size, thread safe memo of BinomialTree values and Greeks.
+
+ Inputs are first snapped to a grid (CacheQuantum; a quantum of 0 keeps that input exact) and the tree is
+ always run at the snapped inputs, so every request falling in one grid cell gets the same answer. The
+ key is the snapped inputs, the side, the tree's step count and exercise style (see BinomialTree::american)
+ and which figure is wanted.
+
+ The table is set associative: a key hashes to one set of 8 slots, and when the set is full the slot to
+ replace is chosen by CLOCK (each slot has a reference bit set by hits; the set's hand sweeps past
+ referenced slots, clearing them, and replaces the first unreferenced one). A set also keeps a hash
+ fingerprint per slot, so a lookup usually touches the set's first cache line and the one matching slot.
+
+ Sets are split over shards(); writers take their shard's lock, readers take no lock at all. Each slot
+ carries a sequence number that a writer makes odd while it rewrites the slot, and a reader accepts a slot
+ only if it saw the same even number before and after reading it, so a read racing a write is just a miss.
+ The number of sets is the largest power of two fitting in the memory budget given to the constructor.
+
+ The tree is not part of the cache; pass in one per thread as for any other use of BinomialTree.
+ entries() copies out the live entries and restore() inserts them again, so a warm cache can be carried
+ across a restart.
+
+ Examples
+
+    ValuationCache cache( 32 << 20 );             // 32MB
+    cache.quantum( CacheQuantum{ 0.0, 0.01, 0.0001, 0.0, 0.0, 0.0 } );   // cent spots, hundredth vol points
+    BinomialTree tree;                            // one per thread
+    double v = cache.value( tree, 100.0, 101.234, 0.2512, 0.05, 0.5, 0.0, false );
+    std::cout << "hit rate " << cache.stats().hitRate() << std::endl;
+ */
+
+
+#ifndef __VALUATIONCACHE_H__
+#define __VALUATIONCACHE_H__
+
+#include <atomic>
+#include <mutex>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+#ifndef __BINOMIALTREE_H__
+#include "BinomialTree.h"
+#endif
+
+
+// grid spacing for each input; 0 for none
+struct CacheQuantum
+{
+    double strike = 0.0;
+    double assetPrice = 0.0;
+    double vol = 0.0;
+    double rate = 0.0;
+    double T = 0.0;
+    double yield = 0.0;
+};
+
+// one live entry, as saved by entries() and reloaded by restore() (in a PricingSnapshot for example)
+struct CacheEntry
+{
+    std::uint32_t tag = 0;         // steps, style, side and figure
+    std::uint32_t reserved = 0;
+    std::uint64_t key[6] = {};     // snapped strike, assetPrice, vol, rate, T, yield as bit patterns
+    double value = 0.0;
+};
+
+struct CacheStats
+{
+    long hits = 0;
+    long misses = 0;
+    long inserts = 0;
+    long evictions = 0;    // inserts that replaced a live entry
+
+    double
+    hitRate( void ) const { return (hits + misses > 0) ? double(hits) / double(hits + misses) : 0.0; }
+};
+
+
+class ValuationCache
+{
+public:
+
+    explicit ValuationCache( std::size_t bytes = std::size_t(64) << 20, int shards = 16 );
+    ~ValuationCache() {}
+
+    ValuationCache( const ValuationCache& ) = delete;
+    ValuationCache& operator=( const ValuationCache& ) = delete;
+
+    double
+    value( BinomialTree& tree,
+           double strike,      // option strike
+           double assetPrice,  // underlying asset's current value
+           double vol,         // volatility
+           double rate,        // risk free rate of interest
+           double T,           // time to maturity (year fraction)
+           double yield = 0.0, // annualised yield of underlying asset over life of option (continuous compounded)
+           bool call = true ) { return get( Value, tree, strike, assetPrice, vol, rate, T, yield, call ); }
+
+    double
+    delta( BinomialTree& tree, double strike, double assetPrice, double vol, double rate, double T, double yield = 0.0, bool call = true )
+    { return get( Delta, tree, strike, assetPrice, vol, rate, T, yield, call ); }
+
+    double
+    gamma( BinomialTree& tree, double strike, double assetPrice, double vol, double rate, double T, double yield = 0.0, bool call = true )
+    { return get( Gamma, tree, strike, assetPrice, vol, rate, T, yield, call ); }
+
+    double
+    theta( BinomialTree& tree, double strike, double assetPrice, double vol, double rate, double T, double yield = 0.0, bool call = true )
+    { return get( Theta, tree, strike, assetPrice, vol, rate, T, yield, call ); }
+
+    double
+    rho( BinomialTree& tree, double strike, double assetPrice, double vol, double rate, double T, double yield = 0.0, bool call = true )
+    { return get( Rho, tree, strike, assetPrice, vol, rate, T, yield, call ); }
+
+    double // BinomialTree::vega has no side
+    vega( BinomialTree& tree, double strike, double assetPrice, double vol, double rate, double T, double yield = 0.0 )
+    { return get( Vega, tree, strike, assetPrice, vol, rate, T, yield, true ); }
+
+    const CacheQuantum&
+    quantum( void ) const { return m_quantum; }
+
+    // changing the grid does not invalidate entries made on the old one; clear() first if it matters
+    void
+    quantum( const CacheQuantum& q ) { m_quantum = q; }
+
+    int
+    shards( void ) const { return (int) m_shards.size(); }
+
+    std::size_t
+    capacity( void ) const { return m_sets.size() * WAYS; }
+
+    std::size_t
+    bytes( void ) const { return m_sets.size() * sizeof(Set); }
+
+    CacheStats
+    stats( void ) const;
+
+    // empties the cache and zeroes the statistics; not safe against concurrent readers
+    void
+    clear( void );
+
+    // appends every live entry to out; returns the number appended
+    std::size_t
+    entries( std::vector<CacheEntry>& out ) const;
+
+    // inserts saved entries (made with the same quantum for them to be found)
+    void
+    restore( const std::vector<CacheEntry>& entries ) { restore( entries.data(), entries.size() ); }
+
+    void
+    restore( const CacheEntry* entries, std::size_t n );
+
+private:
+
+    enum Kind : std::uint32_t { Value = 1, Delta, Gamma, Theta, Vega, Rho };
+
+    static const int WAYS = 8;
+    static const int WORDS = 6;   // snapped strike, assetPrice, vol, rate, T, yield as bit patterns
+
+    struct alignas(64) Slot
+    {
+        std::atomic<std::uint32_t> seq;
+        std::atomic<std::uint32_t> tag;     // steps, style, side and kind; 0 when empty
+        std::atomic<std::uint64_t> key[WORDS];
+        std::atomic<std::uint64_t> value;
+    };
+
+    struct alignas(64) Set
+    {
+        std::atomic<std::uint32_t> print[WAYS];  // hash fingerprints, so a lookup reads only the slots that may match
+        std::atomic<std::uint8_t> ref[WAYS];
+        std::uint8_t hand;                  // written under the shard lock only
+        Slot slot[WAYS];
+    };
+
+    struct alignas(64) Shard
+    {
+        std::mutex lock;
+        std::atomic<long> hits{0};
+        std::atomic<long> misses{0};
+        std::atomic<long> inserts{0};
+        std::atomic<long> evictions{0};
+    };
+
+    double
+    get( Kind kind, BinomialTree& tree, double strike, double assetPrice, double vol, double rate, double T, double yield, bool call );
+
+    std::size_t
+    locate( std::uint32_t tag, const std::uint64_t* key, std::uint32_t& print ) const;
+
+    bool
+    lookup( Set& set, std::uint32_t print, std::uint32_t tag, const std::uint64_t* key, double& value ) const;
+
+    void
+    insert( Set& set, Shard& shard, std::uint32_t print, std::uint32_t tag, const std::uint64_t* key, double value );
+
+    CacheQuantum m_quantum;
+    std::vector<Set> m_sets;
+    std::vector<Shard> m_shards;
+};
+
+
+#endif
+
+///